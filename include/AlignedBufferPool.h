@@ -0,0 +1,77 @@
+/*
+ * AlignedBufferPool.h - float buffers carved from one aligned allocation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_ALIGNED_BUFFER_POOL_H
+#define LMMS_ALIGNED_BUFFER_POOL_H
+
+#include <cstddef>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * One allocation handed out as float buffers, e.g. for the ports of a plugin.
+ * Every buffer starts on its own cache line, so buffers written by different
+ * threads don't share one. The pool is sized for a number of buffers of a
+ * maximum size; allocate() returns nullptr once it is used up.
+ */
+class LMMS_EXPORT AlignedBufferPool
+{
+public:
+	static constexpr std::size_t Alignment = 64;
+
+	AlignedBufferPool() = default;
+	AlignedBufferPool(std::size_t buffers, std::size_t maxBufferSize);
+	~AlignedBufferPool();
+
+	AlignedBufferPool(const AlignedBufferPool&) = delete;
+	AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+	AlignedBufferPool(AlignedBufferPool&& other) noexcept;
+	AlignedBufferPool& operator=(AlignedBufferPool&& other) noexcept;
+
+	//! Returns a zeroed buffer of `size` floats, or nullptr if the pool is too small
+	float* allocate(std::size_t size);
+
+	//! The number of floats a buffer of `size` floats takes up in the pool
+	static constexpr std::size_t paddedSize(std::size_t size)
+	{
+		constexpr auto floatsPerLine = Alignment / sizeof(float);
+		return (size + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+	}
+
+	std::size_t capacity() const { return m_capacity; }
+	std::size_t used() const { return m_used; }
+
+private:
+	float* m_data = nullptr;
+	std::size_t m_capacity = 0;
+	std::size_t m_used = 0;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_ALIGNED_BUFFER_POOL_H
@@ -84,6 +84,8 @@ public:
 
 private:
 	volatile bool m_bufferUsage;
+	//! Whether the buffer was written to since it was cleared
+	bool m_bufferDirty = true;
 
 	SampleFrame* const m_buffer;
 
@@ -92,6 +92,16 @@ protected:
 	// called by according driver for fetching new sound-data
 	fpp_t getNextBuffer(SampleFrame* _ab);
 
+	// like getNextBuffer(), but hands out the engine's buffer instead of
+	// copying it - the buffer stays valid until the next call
+	fpp_t getNextBufferView(const SampleFrame*& buffer);
+
+	//! Whether the driver should render straight from the engine's buffers
+	bool zeroCopy() const
+	{
+		return m_zeroCopy;
+	}
+
 	// convert a given audio-buffer to a buffer in signed 16-bit samples
 	// returns num of bytes in outbuf
 	int convertToS16(const SampleFrame* _ab,
@@ -135,11 +145,15 @@ private:
 	ch_cnt_t m_channels;
 	AudioEngine* m_audioEngine;
 	bool m_inProcess;
+	bool m_zeroCopy;
 
 	QMutex m_devMutex;
 
 	SampleFrame* m_buffer;
 
+	// FIFO buffer handed out by getNextBufferView(), owned by us until the next call
+	const SampleFrame* m_viewBuffer;
+
 };
 
 } // namespace lmms
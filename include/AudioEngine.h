@@ -34,12 +34,15 @@
 #include <vector>
 
 #include "AudioDevice.h"
+#include "AudioTap.h"
 #include "LmmsTypes.h"
 #include "SampleFrame.h"
 #include "LocklessList.h"
+#include "LocklessRingBuffer.h"
 #include "FifoBuffer.h"
 #include "AudioEngineProfiler.h"
 #include "PlayHandle.h"
+#include "VoiceManager.h"
 
 
 namespace lmms
@@ -179,6 +182,18 @@ public:
 	}
 
 
+	//! Number of worker threads rendering alongside the audio thread
+	int numWorkers() const
+	{
+		return m_numWorkers;
+	}
+
+
+	//! Whether the calling thread is currently rendering an audio period,
+	//! either as the audio thread or as a worker thread
+	static bool isRenderingThread();
+
+
 	AudioEngineProfiler& profiler()
 	{
 		return m_profiler;
@@ -220,6 +235,19 @@ public:
 	}
 
 
+	//! Analyzes the taps meters and visualizers subscribe to
+	AudioTapService* tapService()
+	{
+		return &m_tapService;
+	}
+
+	//! The final output, after the master gain
+	AudioTap& outputTap()
+	{
+		return m_outputTap;
+	}
+
+
 	static inline sample_t clip(const sample_t s)
 	{
 		if (s > 1.0f)
@@ -241,16 +269,19 @@ public:
 		return m_fifoWriter != nullptr;
 	}
 
+	//! Called by audio devices with captured input. Realtime safe, but must
+	//! always be called from the same thread. Frames that don't fit are dropped.
 	void pushInputFrames( SampleFrame* _ab, const f_cnt_t _frames );
 
+	//! The input that arrived during the last period
 	inline const SampleFrame* inputBuffer()
 	{
-		return m_inputBuffer[ m_inputBufferRead ];
+		return m_inputBuffer.data();
 	}
 
 	inline f_cnt_t inputBufferFrames() const
 	{
-		return m_inputBufferFrames[ m_inputBufferRead ];
+		return m_inputBufferFrames;
 	}
 
 	inline const SampleFrame* nextBuffer()
@@ -274,7 +305,6 @@ public:
 signals:
 	void qualitySettingsChanged();
 	void sampleRateChanged();
-	void nextAudioBuffer(const lmms::SampleFrame* buffer);
 
 
 private:
@@ -326,15 +356,19 @@ private:
 
 	fpp_t m_framesPerPeriod;
 
-	SampleFrame* m_inputBuffer[2];
-	f_cnt_t m_inputBufferFrames[2];
-	f_cnt_t m_inputBufferSize[2];
 	sample_rate_t m_baseSampleRate;
-	int m_inputBufferRead;
-	int m_inputBufferWrite;
+
+	//! Filled by the audio device, emptied into m_inputBuffer once per period
+	std::unique_ptr<LocklessRingBuffer<SampleFrame>> m_inputRing;
+	std::unique_ptr<LocklessRingBufferReader<SampleFrame>> m_inputRingReader;
+	std::vector<SampleFrame> m_inputBuffer;
+	f_cnt_t m_inputBufferFrames;
 
 	std::unique_ptr<SampleFrame[]> m_outputBufferRead;
 	std::unique_ptr<SampleFrame[]> m_outputBufferWrite;
+	//! Whether the output buffers contain only zeros, so they don't need to be cleared
+	bool m_outputBufferReadSilent = true;
+	bool m_outputBufferWriteSilent = true;
 
 	// worker thread stuff
 	std::vector<AudioEngineWorkerThread *> m_workers;
@@ -348,6 +382,12 @@ private:
 
 	float m_masterGain;
 
+	// the service must outlive the taps it analyzes
+	AudioTapService m_tapService;
+	AudioTap m_outputTap;
+
+	static void setRenderingThread(bool rendering);
+
 	// audio device stuff
 	void doSetAudioDevice( AudioDevice *_dev );
 	AudioDevice * m_audioDev;
@@ -364,6 +404,7 @@ private:
 	fifoWriter * m_fifoWriter;
 
 	AudioEngineProfiler m_profiler;
+	VoiceManager m_voiceManager;
 
 	bool m_clearSignal;
 
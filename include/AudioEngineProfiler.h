@@ -27,6 +27,7 @@
 
 #include <array>
 #include <atomic>
+#include <cstdint>
 #include <QFile>
 
 #include "LmmsTypes.h"
@@ -70,6 +71,35 @@ public:
 		return m_detailLoad[static_cast<std::size_t>(type)].load(std::memory_order_relaxed);
 	}
 
+	//! Number of voices rendered in the current period, used to estimate voiceLoad()
+	void setActiveVoices(std::size_t voices)
+	{
+		m_activeVoices = voices;
+	}
+
+	//! Average CPU load caused by a single voice, in percent of the period time
+	float voiceLoad() const
+	{
+		return m_voiceLoad.load(std::memory_order_relaxed);
+	}
+
+	//! Called by audio devices whenever their zero-copy path avoided copying a buffer
+	void addSkippedCopy(std::size_t bytes)
+	{
+		m_skippedCopies.fetch_add(1, std::memory_order_relaxed);
+		m_skippedCopyBytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	std::uint64_t skippedCopies() const
+	{
+		return m_skippedCopies.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t skippedCopyBytes() const
+	{
+		return m_skippedCopyBytes.load(std::memory_order_relaxed);
+	}
+
 	class Probe
 	{
 	public:
@@ -104,6 +134,12 @@ private:
 	std::array<MicroTimer, DetailCount> m_detailTimer;
 	std::array<int, DetailCount> m_detailTime{0};
 	std::array<std::atomic<float>, DetailCount> m_detailLoad{0};
+
+	std::size_t m_activeVoices = 0;
+	std::atomic<float> m_voiceLoad{0};
+
+	std::atomic<std::uint64_t> m_skippedCopies{0};
+	std::atomic<std::uint64_t> m_skippedCopyBytes{0};
 };
 
 } // namespace lmms
@@ -29,6 +29,8 @@
 
 #include <atomic>
 
+#include "lmms_export.h"
+
 class QWaitCondition;
 
 namespace lmms
@@ -37,7 +39,7 @@ namespace lmms
 class AudioEngine;
 class ThreadableJob;
 
-class AudioEngineWorkerThread : public QThread
+class LMMS_EXPORT AudioEngineWorkerThread : public QThread
 {
 	Q_OBJECT
 public:
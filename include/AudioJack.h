@@ -130,6 +130,8 @@ private:
 	jack_default_audio_sample_t** m_tempOutBufs;
 	std::vector<SampleFrame> m_inputFrameBuffer;
 	SampleFrame* m_outBuf;
+	//! Period currently being handed to JACK, either m_outBuf or the engine's buffer in zero-copy mode
+	const SampleFrame* m_curBuf;
 
 	f_cnt_t m_framesDoneInCurBuf;
 	f_cnt_t m_framesToDoInCurBuf;
@@ -0,0 +1,178 @@
+/*
+ * AudioTap.h - shared metering of audio buffers
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUDIO_TAP_H
+#define LMMS_AUDIO_TAP_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "LmmsTypes.h"
+#include "LocklessRingBuffer.h"
+#include "SampleFrame.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class AudioTapService;
+
+
+/**
+ * A point in the signal flow that meters and visualizers can listen to,
+ * e.g. a mixer channel or the engine's output.
+ *
+ * The audio thread publishes its buffers here, which only costs a copy into
+ * a lockless queue while someone is subscribed (see AudioTapService). Peaks,
+ * RMS and, if any subscriber asks for it, a spectrum are computed once on the
+ * service thread and handed to every subscriber of the tap.
+ */
+class LMMS_EXPORT AudioTap
+{
+public:
+	//! What a subscriber gets, valid only during the callback
+	struct Analysis
+	{
+		//! The audio published since the last analysis
+		const SampleFrame* frames;
+		f_cnt_t frameCount;
+		//! Absolute peak and RMS of each channel of these frames
+		SampleFrame peak;
+		SampleFrame rms;
+		//! Normalized magnitudes of the latest SpectrumSize mono frames, or empty if nobody asked
+		const std::vector<float>& spectrum;
+	};
+
+	//! Called on the service thread, without any lock held
+	using Callback = std::function<void(const Analysis&)>;
+
+	static constexpr f_cnt_t SpectrumSize = 2048;
+
+	//! The default capacity holds a few display refreshes of audio at the highest sample rates
+	explicit AudioTap(f_cnt_t capacity = 16384);
+	~AudioTap();
+
+	AudioTap(const AudioTap&) = delete;
+	AudioTap& operator=(const AudioTap&) = delete;
+
+	//! Realtime safe, but must always be called from the same thread
+	void publish(const SampleFrame* frames, f_cnt_t count)
+	{
+		if (m_subscribed.load(std::memory_order_relaxed))
+		{
+			m_queue.write(frames, count);
+		}
+	}
+
+	bool isSubscribed() const { return m_subscribed.load(std::memory_order_relaxed); }
+
+private:
+	struct Subscriber
+	{
+		int id;
+		Callback callback;
+		bool spectrum;
+	};
+
+	//! A copy of an analysis and its subscribers, so the callbacks can run without the service's lock
+	struct Delivery
+	{
+		std::vector<Callback> callbacks;
+		std::vector<SampleFrame> frames;
+		f_cnt_t frameCount = 0;
+		SampleFrame peak;
+		SampleFrame rms;
+		std::vector<float> spectrum;
+		bool hasSpectrum = false;
+
+		void deliver() const;
+	};
+
+	//! Reads what was published and computes the analysis. Returns false if nothing was published.
+	bool analyze(Delivery& delivery);
+	void updateSpectrum(const SampleFrame* frames, std::size_t count);
+
+	LocklessRingBuffer<SampleFrame> m_queue;
+	LocklessRingBufferReader<SampleFrame> m_reader;
+	std::atomic<bool> m_subscribed = false;
+
+	// only used by the service, while holding its lock
+	AudioTapService* m_service = nullptr;
+	std::vector<Subscriber> m_subscribers;
+
+	struct Fft;
+	std::unique_ptr<Fft> m_fft;
+	std::vector<float> m_spectrum;
+
+	friend class AudioTapService;
+} ;
+
+
+
+
+//! The thread analyzing all subscribed AudioTaps, see AudioEngine::tapService()
+class LMMS_EXPORT AudioTapService : public QThread
+{
+public:
+	AudioTapService();
+	~AudioTapService() override;
+
+	//! Starts publishing on the tap. Returns an id for unsubscribe().
+	int subscribe(AudioTap& tap, AudioTap::Callback callback, bool spectrum = false);
+	//! Safe to call with ids of taps that no longer exist. Once this returns, the callback
+	//! is not called anymore, unless this is called from a callback.
+	void unsubscribe(int id);
+
+private:
+	void run() override;
+
+	//! Called by taps being destroyed
+	void removeTap(AudioTap* tap);
+
+	//! How often the published audio is analyzed, about the display's refresh rate
+	static constexpr int IntervalMs = 15;
+
+	QMutex m_mutex;
+	QWaitCondition m_tapsAdded;
+	std::vector<AudioTap*> m_taps;
+	int m_nextId = 1;
+
+	//! Held while calling back, taken before m_mutex is released
+	QMutex m_callbackMutex;
+	//! Only used by the service thread, reused to avoid allocations
+	std::vector<AudioTap::Delivery> m_deliveries;
+
+	friend class AudioTap;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_AUDIO_TAP_H
@@ -25,6 +25,7 @@
 #ifndef LMMS_AUTOMATABLE_MODEL_H
 #define LMMS_AUTOMATABLE_MODEL_H
 
+#include <atomic>
 #include <cmath>
 #include <QMap>
 #include <QMutex>
@@ -175,6 +176,8 @@ public:
 
 	//! @brief Function that returns sample-exact data as a ValueBuffer
 	//! @return pointer to model's valueBuffer when s.ex.data exists, NULL otherwise
+	//! The buffer is computed once per period and must not be modified. Does not
+	//! lock, so it can be called from any worker thread while rendering.
 	ValueBuffer * valueBuffer();
 
 	template<class T>
@@ -269,6 +272,9 @@ public:
 				specified DOM element using <name> as attribute/node name */
 	virtual void loadSettings( const QDomElement& element, const QString& name );
 
+	//! Only the value is journalled, automation and controllers are not edited through the model
+	std::unique_ptr<JournalDelta> saveJournalDelta() override;
+
 	QString nodeName() const override
 	{
 		return "automatablemodel";
@@ -303,12 +309,12 @@ public:
 
 	static void incrementPeriodCounter()
 	{
-		++s_periodCounter;
+		s_periodCounter.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	static void resetPeriodCounter()
 	{
-		s_periodCounter = 0;
+		s_periodCounter.store(0, std::memory_order_relaxed);
 	}
 
 	bool useControllerValue() const
@@ -411,14 +417,18 @@ private:
 	ControllerConnection* m_controllerConnection;
 
 
-	ValueBuffer m_valueBuffer;
-	long m_lastUpdatedPeriod;
-	static long s_periodCounter;
+	//! Computes m_valueBuffer for the current period
+	//! @return whether there is sample exact data
+	bool updateValueBuffer();
 
+	//! Snapshot of the current period, published through m_lastUpdatedPeriod.
+	//! Only rewritten in the next period, after all readers are done.
+	ValueBuffer m_valueBuffer;
 	bool m_hasSampleExactData;
-
-	// prevent several threads from attempting to write the same vb at the same time
-	QMutex m_valueBufferMutex;
+	std::atomic<long> m_lastUpdatedPeriod;
+	//! Period whose snapshot is being computed, so that only one thread does it
+	std::atomic<long> m_claimedPeriod;
+	static std::atomic<long> s_periodCounter;
 
 	bool m_useControllerValue;
 
@@ -57,7 +57,7 @@ const int TLENS[MAXTBL+1] = { 2 << 0, 3 << 0, 2 << 1, 3 << 1,
 struct WaveMipMap
 {
 public:
-	inline sample_t sampleAt(int table, int ph)
+	inline sample_t sampleAt(int table, int ph) const
 	{
 		if (table % 2 == 0) { return m_data[TLENS[table] + ph]; }
 		else
@@ -169,7 +169,8 @@ public:
 
 	static bool s_wavesGenerated;
 
-	static std::array<WaveMipMap, NumWaveforms> s_waveforms;
+	//! Points to the generated waveforms or to the ones mapped from the cache
+	static const WaveMipMap* s_waveforms;
 
 	static QString s_wavetableDir;
 };
@@ -25,6 +25,7 @@
 #ifndef LMMS_CLIP_H
 #define LMMS_CLIP_H
 
+#include <atomic>
 #include <optional>
 
 #include <QColor>
@@ -144,6 +145,17 @@ public:
 	// Will copy the state of a clip to another clip
 	static void copyStateTo( Clip *src, Clip *dst );
 
+	//! Changes whenever any clip is added, removed, moved, resized or (un)muted,
+	//! so playback caches of clip layouts know when to rebuild
+	static unsigned layoutRevision()
+	{
+		return s_layoutRevision.load(std::memory_order_acquire);
+	}
+	static void invalidateLayout()
+	{
+		s_layoutRevision.fetch_add(1, std::memory_order_release);
+	}
+
 	/**
 	* Creates a copy of this clip
 	* @return pointer to the new clip object
@@ -179,6 +191,8 @@ private:
 
 	std::optional<QColor> m_color;
 
+	static std::atomic<unsigned> s_layoutRevision;
+
 	friend class ClipView;
 
 } ;
@@ -130,6 +130,13 @@ public:
 	static void triggerFrameCounter();
 	static void resetFrameCounter();
 
+	//! Computes the value buffers of all connected controllers for the coming period,
+	//! controllers modulating other controllers first. Called by the audio engine,
+	//! so the models only read finished buffers afterwards.
+	static void updateControllers();
+	//! Rebuilds the evaluation order after connections changed and hands it to the audio thread
+	static void updateEvaluationOrder();
+
 	//Accepts a ControllerConnection * as it may be used in the future.
 	void addConnection( ControllerConnection * );
 	void removeConnection( ControllerConnection * );
@@ -170,6 +177,15 @@ protected:
 
 	static long s_periods;
 
+private:
+	//! The controllers whose models are connected to other controllers
+	ControllerVector dependencies() const;
+	//! Returns the connected controllers in evaluation order, leaving out `removed`
+	static ControllerVector sortControllers(const Controller* removed = nullptr);
+
+	//! Connected controllers, each after the controllers it depends on
+	static ControllerVector s_evaluationOrder;
+
 
 signals:
 	// The value changed while the audio engine isn't running (i.e: MIDI CC)
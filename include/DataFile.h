@@ -27,16 +27,19 @@
 #define LMMS_DATA_FILE_H
 
 #include <map>
+#include <memory>
 #include <QDomDocument>
 #include <vector>
 
 #include "lmms_export.h"
 
+class QIODevice;
 class QTextStream;
 
 namespace lmms
 {
 
+class ProjectContainer;
 class ProjectVersion;
 
 
@@ -44,6 +47,17 @@ class LMMS_EXPORT DataFile : public QDomDocument
 {
 
 	using UpgradeMethod = void(DataFile::*)();
+	//! Upgrade of a single element, which may only look at the element and its ancestors
+	using ElementUpgrade = void(*)(QDomElement&);
+
+	struct Upgrade
+	{
+		Upgrade(UpgradeMethod method) : method(method) {}
+		Upgrade(ElementUpgrade element) : element(element) {}
+
+		UpgradeMethod method = nullptr;
+		ElementUpgrade element = nullptr;
+	};
 
 public:
 	enum class Type
@@ -73,7 +87,8 @@ public:
 
 	QString nameWithExtension( const QString& fn ) const;
 
-	void write( QTextStream& strm );
+	//! Returns false without writing anything if the samples of a project container can't be embedded
+	bool write( QTextStream& strm );
 	bool writeFile(const QString& fn, bool withResources = false);
 	bool copyResources(const QString& resourcesDir); //!< Copies resources to the resourcesDir and changes the DataFile to use local paths to them
 	bool hasLocalPlugins(QDomElement parent = QDomElement(), bool firstCall = true) const;
@@ -93,6 +108,17 @@ public:
 		return m_type;
 	}
 
+	//! The samples of a .mmpc file this was loaded from, or that are written along with it
+	ProjectContainer* container() const
+	{
+		return m_container.get();
+	}
+
+	void setContainer(std::shared_ptr<ProjectContainer> container)
+	{
+		m_container = std::move(container);
+	}
+
 	unsigned int legacyFileVersion();
 
 private:
@@ -101,7 +127,7 @@ private:
 
 	void cleanMetaNodes( QDomElement de );
 
-	void mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map);
+	static void mapSrcAttribute(QDomElement& element, const QMap<QString, QString>& map);
 
 	// helper upgrade routines
 	void upgrade_0_2_1_20070501();
@@ -124,20 +150,20 @@ private:
 	void upgrade_noHiddenClipNames();
 	void upgrade_automationNodes();
 	void upgrade_extendedNoteRange();
-	void upgrade_defaultTripleOscillatorHQ();
-	void upgrade_mixerRename();
-	void upgrade_bbTcoRename();
-	void upgrade_sampleAndHold();
-	void upgrade_midiCCIndexing();
-	void upgrade_loopsRename();
-	void upgrade_noteTypes();
-	void upgrade_fixCMTDelays();
-	void upgrade_fixBassLoopsTypo();
+	static void upgrade_defaultTripleOscillatorHQ(QDomElement& element);
+	static void upgrade_mixerRename(QDomElement& element);
+	static void upgrade_bbTcoRename(QDomElement& element);
+	static void upgrade_sampleAndHold(QDomElement& element);
+	static void upgrade_midiCCIndexing(QDomElement& element);
+	static void upgrade_loopsRename(QDomElement& element);
+	static void upgrade_noteTypes(QDomElement& element);
+	static void upgrade_fixCMTDelays(QDomElement& element);
+	static void upgrade_fixBassLoopsTypo(QDomElement& element);
 	void findProblematicLadspaPlugins();
 	void upgrade_noHiddenAutomationTracks();
 
 	// List of all upgrade methods
-	static const std::vector<UpgradeMethod> UPGRADE_METHODS;
+	static const std::vector<Upgrade> UPGRADE_METHODS;
 	// List of ProjectVersions for the legacyFileVersion method
 	static const std::vector<ProjectVersion> UPGRADE_VERSIONS;
 
@@ -145,15 +171,20 @@ private:
 	using ResourcesMap = std::map<QString, std::vector<QString>>;
 	static const ResourcesMap ELEMENTS_WITH_RESOURCES;
 
+	//! The consecutive element upgrades starting at the given index
+	static std::vector<ElementUpgrade> elementUpgrades(std::size_t from);
 	void upgrade();
 
-	void loadData( const QByteArray & _data, const QString & _sourceFile );
+	bool parse(QIODevice& input, QString& errorMsg, int& line, int& column);
+	void loadData(QIODevice& input, const QString& sourceFile);
 
 	QString m_fileName; //!< The origin file name or "" if this DataFile didn't originate from a file
 	QDomElement m_content;
 	QDomElement m_head;
 	Type m_type;
 	unsigned int m_fileVersion;
+	bool m_upgradedWhileParsing = false; //!< Whether the leading element upgrades were done while parsing
+	std::shared_ptr<ProjectContainer> m_container;
 } ;
 
 
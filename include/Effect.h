@@ -26,11 +26,13 @@
 #ifndef LMMS_EFFECT_H
 #define LMMS_EFFECT_H
 
+#include <memory>
 #include <span>
 
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
 #include "Engine.h"
+#include "PlanarBuffer.h"
 #include "Plugin.h"
 #include "TempoSyncKnobModel.h"
 
@@ -55,6 +57,7 @@ public:
 	Effect( const Plugin::Descriptor * _desc,
 			Model * _parent,
 			const Descriptor::SubPluginFeatures::Key * _key );
+	~Effect() override;
 
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
 	void loadSettings( const QDomElement & _this ) override;
@@ -66,6 +69,18 @@ public:
 
 	//! Returns true if audio was processed and should continue being processed
 	bool processAudioBuffer(SampleFrame* buf, const fpp_t frames);
+	//! Same as above for planar effects, see isPlanar()
+	bool processAudioBuffer(PlanarBuffer::View buf);
+
+	/**
+	 * Whether the effect prefers planar buffers, e.g. because it hosts a plugin with
+	 * one port per channel. The effect chain then calls processPlanarImpl() instead of
+	 * processImpl(), and only converts its buffer where a native effect follows.
+	 */
+	virtual bool isPlanar() const
+	{
+		return false;
+	}
 
 	inline bool isOkay() const
 	{
@@ -141,6 +156,42 @@ public:
 		return m_parent;
 	}
 
+	//! The highest oversampling factor is 2 ^ MaxOversamplingStages
+	static constexpr int MaxOversamplingStages = 3;
+
+	/**
+	 * Whether the effect can run at a multiple of the engine's sample rate. Such
+	 * effects must use sampleRate() instead of the engine's sample rate and
+	 * accept periods of up to oversamplingFactor() times framesPerPeriod() frames.
+	 */
+	virtual bool supportsOversampling() const
+	{
+		return false;
+	}
+
+	//! The number of 2x oversampling stages selected by the user
+	IntModel* oversamplingModel()
+	{
+		return &m_oversamplingModel;
+	}
+
+	int oversamplingFactor() const
+	{
+		return 1 << m_oversamplingStages;
+	}
+
+	//! The sample rate processImpl() runs at
+	sample_rate_t sampleRate() const
+	{
+		return Engine::audioEngine()->outputSampleRate() * oversamplingFactor();
+	}
+
+	//! The delay in frames at the engine's sample rate caused by the oversampling filters
+	float oversamplingLatency() const
+	{
+		return m_oversamplingLatency;
+	}
+
 	virtual EffectControls * controls() = 0;
 
 	static Effect * instantiate( const QString & _plugin_name,
@@ -166,6 +217,12 @@ protected:
 	 */
 	virtual ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) = 0;
 
+	//! The processing method of effects that return true from isPlanar()
+	virtual ProcessStatus processPlanarImpl(PlanarBuffer::View)
+	{
+		return ProcessStatus::Sleep;
+	}
+
 	/**
 	 * Optional method that runs when plugin is sleeping (not enabled,
 	 * not running, not in the Okay state, or in the Don't Run state)
@@ -177,6 +234,9 @@ protected:
 
 	virtual void onEnabledChanged() {}
 
+	//! Called with the audio engine locked after oversamplingFactor() changed
+	virtual void onOversamplingChanged() {}
+
 
 private:
 	/**
@@ -185,6 +245,14 @@ private:
 	 * turned off and won't be processed again until it receives new audio input.
 	 */
 	void handleAutoQuit(std::span<const SampleFrame> output);
+	void handleAutoQuit(PlanarBuffer::View output);
+	void handleQuietBuffer();
+
+	//! Runs processImpl() on the buffer upsampled by oversamplingFactor()
+	ProcessStatus processOversampled(SampleFrame* buf, const fpp_t frames);
+
+	//! Applies the oversampling model and the engine's sample rate to the filters
+	void updateOversampling();
 
 
 	EffectChain * m_parent;
@@ -199,9 +267,15 @@ private:
 	BoolModel m_enabledModel;
 	FloatModel m_wetDryModel;
 	TempoSyncKnobModel m_autoQuitModel;
+	IntModel m_oversamplingModel;
 
 	bool m_autoQuitEnabled = false;
 
+	struct Oversampler;
+	std::unique_ptr<Oversampler> m_oversampler;
+	int m_oversamplingStages = 0;
+	float m_oversamplingLatency = 0.f;
+
 	friend class gui::EffectView;
 	friend class EffectChain;
 
@@ -29,6 +29,7 @@
 #include "Model.h"
 #include "SerializingObject.h"
 #include "AutomatableModel.h"
+#include "PlanarBuffer.h"
 
 namespace lmms
 {
@@ -63,8 +64,12 @@ public:
 	void removeEffect( Effect * _effect );
 	void moveDown( Effect * _effect );
 	void moveUp( Effect * _effect );
+	//! Runs the effects on the buffer. Without input noise the buffer must be silent, and it
+	//! stays untouched if no effect is running anymore. Returns whether any effect keeps running.
 	bool processAudioBuffer( SampleFrame* _buf, const fpp_t _frames, bool hasInputNoise );
 	void startRunning();
+	//! Whether processAudioBuffer() would still produce output without input noise
+	bool isRunning() const;
 
 	void clear();
 
@@ -75,6 +80,9 @@ private:
 
 	BoolModel m_enabledModel;
 
+	//! Holds the audio while planar effects follow each other
+	PlanarBuffer m_planarBuffer;
+
 
 	friend class gui::EffectRackView;
 
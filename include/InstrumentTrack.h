@@ -228,6 +228,16 @@ public:
 		return &m_useMasterPitchModel;
 	}
 
+	IntModel* maxPolyphonyModel()
+	{
+		return &m_maxPolyphonyModel;
+	}
+
+	IntModel* voicePriorityModel()
+	{
+		return &m_voicePriorityModel;
+	}
+
 	void setPreviewMode( const bool );
 
 	bool isPreviewMode() const
@@ -298,6 +308,8 @@ private:
 	IntModel m_pitchRangeModel;
 	IntModel m_mixerChannelModel;
 	BoolModel m_useMasterPitchModel;
+	IntModel m_maxPolyphonyModel;	//!< Maximum number of sounding notes, 0 = unlimited
+	IntModel m_voicePriorityModel;	//!< Notes of tracks with lower priority are stolen first under CPU load
 
 	Instrument * m_instrument;
 	InstrumentSoundShaping m_soundShaping;
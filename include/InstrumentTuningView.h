@@ -41,6 +41,7 @@ namespace gui
 
 class ComboBox;
 class GroupBox;
+class LcdSpinBox;
 class LedCheckBox;
 
 
@@ -60,6 +61,9 @@ public:
 
 	LedCheckBox *rangeImportCheckbox() {return m_rangeImportCheckbox;}
 
+	LcdSpinBox *maxPolyphonySpinBox() {return m_maxPolyphonySpinBox;}
+	LcdSpinBox *voicePrioritySpinBox() {return m_voicePrioritySpinBox;}
+
 private:
 	GroupBox *m_pitchGroupBox;
 	GroupBox *m_microtunerGroupBox;
@@ -70,6 +74,9 @@ private:
 	ComboBox *m_keymapCombo;
 
 	LedCheckBox *m_rangeImportCheckbox;
+
+	LcdSpinBox *m_maxPolyphonySpinBox;
+	LcdSpinBox *m_voicePrioritySpinBox;
 };
 
 
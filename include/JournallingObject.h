@@ -25,6 +25,8 @@
 #ifndef LMMS_JOURNALLING_OBJECT_H
 #define LMMS_JOURNALLING_OBJECT_H
 
+#include <memory>
+
 #include <QStack>
 
 #include "LmmsTypes.h"
@@ -33,6 +35,8 @@
 namespace lmms
 {
 
+class JournalDelta;
+
 class LMMS_EXPORT JournallingObject : public SerializingObject
 {
 public:
@@ -65,6 +69,10 @@ public:
 
 	void restoreState( const QDomElement & _this ) override;
 
+	//! Returns the state edits of this object can change in a compact form,
+	//! or nullptr to have the journal store a snapshot of the whole object
+	virtual std::unique_ptr<JournalDelta> saveJournalDelta();
+
 	inline bool isJournalling() const
 	{
 		return m_journalling;
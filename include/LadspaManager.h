@@ -29,6 +29,7 @@
 
 #include <ladspa.h>
 
+#include <QJsonArray>
 #include <QMap>
 #include <QPair>
 #include <QString>
@@ -39,6 +40,8 @@
 #include "LmmsTypes.h"
 
 
+class QFileInfo;
+
 namespace lmms
 {
 
@@ -74,11 +77,16 @@ enum class LadspaPluginType
 
 struct LadspaManagerDescription
 {
+	//! Null until the library is loaded, if the plugin was read from the PluginCache
 	LADSPA_Descriptor_Function descriptorFunction;
+	QString library;
 	uint32_t index;
 	LadspaPluginType type;
 	uint16_t inputChannels;
 	uint16_t outputChannels;
+	//! Kept to list plugins without loading their library
+	QString name;
+	LADSPA_Properties properties;
 };
 
 class LMMS_EXPORT LadspaManager
@@ -330,8 +338,11 @@ public:
 						LADSPA_Handle _instance );
 
 private:
-	void  addPlugins( LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file );
+	//! Returns the cache entry of the library
+	QJsonArray addPlugins( LADSPA_Descriptor_Function _descriptor_func,
+						const QFileInfo & _file );
+	void addCachedPlugins( const QJsonArray & _plugins, const QFileInfo & _file );
+	void addPlugin( const ladspa_key_t & _key, LadspaManagerDescription * _plugin );
 	uint16_t  getPluginInputs( const LADSPA_Descriptor * _descriptor );
 	uint16_t  getPluginOutputs( const LADSPA_Descriptor * _descriptor );
 
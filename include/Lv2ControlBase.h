@@ -34,6 +34,7 @@
 
 #include "LinkedModelGroups.h"
 #include "lmms_export.h"
+#include "PlanarBuffer.h"
 #include "Plugin.h"
 
 namespace lmms
@@ -121,6 +122,9 @@ protected:
 	void copyBuffersFromLmms(const SampleFrame* buf, fpp_t frames);
 	//! Copy our ports into buffers passed by LMMS
 	void copyBuffersToLmms(SampleFrame* buf, fpp_t frames) const;
+	//! Same as above for planar buffers, which are copied one channel at a time
+	void copyBuffersFromLmms(PlanarBuffer::View buf);
+	void copyBuffersToLmms(PlanarBuffer::View buf) const;
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(fpp_t frames);
 
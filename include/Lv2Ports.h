@@ -195,6 +195,10 @@ struct Audio : public VisitablePort<Audio, PortBase>
 	//! @param channel channel index into each sample frame
 	void copyBuffersToCore(SampleFrame* lmmsBuf,
 		unsigned channel, fpp_t frames) const;
+	//! Same as above for one channel of a planar buffer
+	void copyBuffersFromCore(const float* lmmsBuf, fpp_t frames);
+	void averageWithBuffersFromCore(const float* lmmsBuf, fpp_t frames);
+	void copyBuffersToCore(float* lmmsBuf, fpp_t frames) const;
 
 	bool isSideChain() const { return m_sidechain; }
 	bool isOptional() const { return m_optional; }
@@ -41,6 +41,7 @@
 #include "Lv2Features.h"
 #include "Lv2Options.h"
 #include "Lv2Worker.h"
+#include "PlanarBuffer.h"
 #include "Plugin.h"
 #include "TimePos.h"
 
@@ -146,6 +147,9 @@ public:
 	 */
 	void copyBuffersToCore(SampleFrame* buf, unsigned firstChan, unsigned num,
 								fpp_t frames) const;
+	//! Same as above for planar buffers, where @p firstChan is a channel index of @p buf
+	void copyBuffersFromCore(PlanarBuffer::View buf, unsigned firstChan, unsigned num);
+	void copyBuffersToCore(PlanarBuffer::View buf, unsigned firstChan, unsigned num) const;
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(fpp_t frames);
 
@@ -26,6 +26,11 @@
 #ifndef LMMS_MIDI_CLIP_H
 #define LMMS_MIDI_CLIP_H
 
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "Clip.h"
 #include "Note.h"
 
@@ -61,6 +66,9 @@ public:
 
 	// note management
 	Note * addNote( const Note & _new_note, const bool _quant_pos = true );
+	//! Adds copies of all the notes at once, without quantizing them. Cheaper
+	//! than calling addNote() for each note when adding many notes.
+	void addNotes(const std::vector<Note>& notes);
 
 	NoteVector::const_iterator removeNote(NoteVector::const_iterator it);
 	NoteVector::const_iterator removeNote(Note* note);
@@ -75,6 +83,15 @@ public:
 		return m_notes;
 	}
 
+	using NoteRange = std::pair<NoteVector::const_iterator, NoteVector::const_iterator>;
+
+	//! Returns the notes that may overlap the ticks [start, end) in O(log n).
+	//! Contains all notes ending (or, with negative length, beginning) at or
+	//! after start and beginning before end,
+	//! in order, but may also contain notes ending before start, so callers
+	//! still need to check each note.
+	NoteRange notesInRange(TimePos start, TimePos end) const;
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -102,6 +119,8 @@ public:
 	void exportToXML(QDomDocument& doc, QDomElement& midiClipElement, bool onlySelectedNotes = false);
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
 	void loadSettings( const QDomElement & _this ) override;
+	//! Records the notes compactly unless they have per-note automation
+	std::unique_ptr<JournalDelta> saveJournalDelta() override;
 	inline QString nodeName() const override
 	{
 		return "midiclip";
@@ -140,6 +159,8 @@ protected slots:
 
 
 private:
+	class JournalState;
+
 	TimePos beatClipLength() const;
 
 	void setType( Type _new_clip_type );
@@ -147,6 +168,9 @@ private:
 
 	void resizeToFirstTrack();
 
+	void invalidateNoteIndex();
+	void rebuildNoteIndex(unsigned int generation) const;
+
 	InstrumentTrack * m_instrumentTrack;
 
 	Type m_clipType;
@@ -155,6 +179,15 @@ private:
 	NoteVector m_notes;
 	int m_steps;
 
+	// index for notesInRange(), rebuilt lazily after m_notes changed
+	mutable std::vector<tick_t> m_notePositions;
+	mutable std::vector<tick_t> m_noteMaxEnds; //!< running maximum of the end positions
+	mutable bool m_notesSorted = true;
+	//! Incremented by every change of m_notes, the index is only valid for the one it was built for
+	std::atomic<unsigned int> m_noteGeneration = 1;
+	mutable unsigned int m_noteIndexGeneration = 0;
+	mutable std::mutex m_noteIndexMutex;
+
 	MidiClip * adjacentMidiClipByOffset(int offset) const;
 
 	friend class gui::MidiClipView;
@@ -25,7 +25,9 @@
 #ifndef LMMS_MIX_HELPERS_H
 #define LMMS_MIX_HELPERS_H
 
+#include "AudioBufferView.h"
 #include "LmmsTypes.h"
+#include "lmms_constants.h"
 
 namespace lmms
 {
@@ -44,6 +46,9 @@ void setNaNHandler( bool use );
 
 bool sanitize( SampleFrame* src, int frames );
 
+/*! \brief Same as sanitize() for planar buffers */
+bool sanitize(PlanarBufferView<float, DEFAULT_CHANNELS> buffer);
+
 /*! \brief Add samples from src to dst */
 void add( SampleFrame* dst, const SampleFrame* src, int frames );
 
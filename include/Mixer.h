@@ -26,21 +26,41 @@
 #define LMMS_MIXER_H
 
 #include "Model.h"
+#include "AudioTap.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "ThreadableJob.h"
 
 #include <atomic>
 #include <optional>
+#include <vector>
 #include <QColor>
 
 namespace lmms
 {
 
 
+class MixerChannel;
 class MixerRoute;
 using MixerRouteVector = std::vector<MixerRoute*>;
 
+//! The channels and routes of the mixer as the audio thread sees them. A
+//! routing is never modified, edits publish a new one (see Mixer::startPeriod())
+struct MixerRouting
+{
+	struct Channel
+	{
+		MixerChannel* channel;
+		//! Routes from the channels sending to this one
+		MixerRouteVector receives;
+		//! Channels this one sends to
+		std::vector<MixerChannel*> receivers;
+	};
+
+	//! Indexed like the mixer channels at the time the routing was published
+	std::vector<Channel> channels;
+};
+
 class MixerChannel : public ThreadableJob
 {
 	public:
@@ -53,9 +73,14 @@ class MixerChannel : public ThreadableJob
 		bool m_hasInput;
 		// set to true if any effect in the channel is enabled and running
 		bool m_stillRunning;
+		// set to true when the buffer may be non-silent after processing;
+		// buffers of silent channels are neither mixed nor cleared
+		bool m_hasOutput;
 
 		float m_peakLeft;
 		float m_peakRight;
+		//! Carries the processed buffer to meters, the peaks above are only updated while metered
+		AudioTap m_tap;
 		SampleFrame* m_buffer;
 		bool m_muteBeforeSolo;
 		BoolModel m_muteModel;
@@ -72,6 +97,9 @@ class MixerChannel : public ThreadableJob
 		// pointers to other channels that send to this one
 		MixerRouteVector m_receives;
 
+		// the sends and receives used by the audio thread in the current period
+		const MixerRouting::Channel* m_routing;
+
 		int index() const { return m_channelIndex; }
 		void setIndex(int index) { m_channelIndex = index; }
 
@@ -88,11 +116,16 @@ class MixerChannel : public ThreadableJob
 		std::atomic_size_t m_dependenciesMet;
 		void incrementDeps();
 		void processed();
+
+		void setMetered(bool metered);
 		
 	private:
 		void doProcessing() override;
 		int m_channelIndex;
 		std::optional<QColor> m_color;
+		//! Volume of the last period, to scale the metered peaks like the output
+		std::atomic<float> m_meterVolume;
+		int m_meterSubscription;
 };
 
 class MixerRoute : public QObject
@@ -145,8 +178,8 @@ public:
 
 	void mixToChannel( const SampleFrame* _buf, mix_ch_t _ch );
 
-	void prepareMasterMix();
-	void masterMix( SampleFrame* _buf );
+	//! Adds the master output to the buffer, returns false if it was silent and nothing was added
+	bool masterMix( SampleFrame* _buf );
 
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
 	void loadSettings( const QDomElement & _this ) override;
@@ -213,6 +246,14 @@ public:
 		return m_mixerChannels.size();
 	}
 
+	//! Whether the peaks of all channels should be updated, e.g. while the mixer is visible
+	void setMetered(bool metered);
+
+	//! Called by the audio engine around each period. The routing published
+	//! last is used for the whole period, edits only take effect at the next one.
+	void startPeriod();
+	void finishPeriod();
+
 	MixerRouteVector m_mixerRoutes;
 
 private:
@@ -222,7 +263,34 @@ private:
 	// make sure we have at least num channels
 	void allocateChannelsTo(int num);
 
+	//! Makes the current channels and routes visible to the audio thread,
+	//! without waiting for it
+	void publishRouting();
+	//! Deletes retired routings, and the channels and routes removed with them,
+	//! once the audio thread can no longer use them. Retries until all are deleted.
+	void reclaimRoutings();
+	//! Roughly a period, so routings in use are reclaimed soon after it ends
+	static constexpr int ReclaimRetryInterval = 10; // ms
+
+	std::atomic<MixerRouting*> m_routing;
+	//! The routing of the period being rendered, nullptr between periods
+	std::atomic<MixerRouting*> m_activeRouting;
+
+	struct RetiredRouting
+	{
+		MixerRouting* routing;
+		std::vector<MixerChannel*> channels;
+		MixerRouteVector routes;
+	};
+	//! Replaced routings, oldest first
+	std::vector<RetiredRouting> m_retiredRoutings;
+	//! Removed since the last publish, but still in the current routing
+	std::vector<MixerChannel*> m_removedChannels;
+	MixerRouteVector m_removedRoutes;
+
 	int m_lastSoloed;
+	bool m_metered;
+	bool m_reclaimScheduled;
 } ;
 
 
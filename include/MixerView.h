@@ -96,6 +96,8 @@ public slots:
 
 protected:
 	void closeEvent(QCloseEvent* ce) override;
+	void showEvent(QShowEvent* se) override;
+	void hideEvent(QHideEvent* he) override;
 
 private slots:
 	void updateFaders();
@@ -114,6 +114,11 @@ public:
 	//! Performs a deep copy and returns an owning raw pointer
 	Note* clone() const;
 
+	//! Notes are allocated from a pool, so that notes created one after
+	//! another, e.g. those of a clip, are close to each other in memory
+	static void* operator new(std::size_t size);
+	static void operator delete(void* ptr, std::size_t size);
+
 	// Note types
 	enum class Type
 	{
@@ -220,6 +220,17 @@ public:
 	/*! Mutes playback of note */
 	void mute();
 
+	/*! Releases the note and fades it out within the given number of frames,
+	    ignoring the release of the envelopes. Used by the VoiceManager to free
+	    resources when the CPU is overloaded or polyphony is exceeded */
+	void steal(f_cnt_t fadeFrames);
+
+	/*! Returns whether note was stolen and is fading out or finished */
+	bool isStolen() const
+	{
+		return m_stealFrames > 0;
+	}
+
 	/*! Returns index of NotePlayHandle in vector of note-play-handles
 	    belonging to this instrument track - used by arpeggiator.
 	    Ignores child note-play-handles, returns -1 when called on one */
@@ -312,6 +323,8 @@ private:
 	NotePlayHandle * m_parent;			// parent note
 	bool m_hadChildren;
 	bool m_muted;							// indicates whether note is muted
+	f_cnt_t m_stealFrames;					// length of fade out when stolen, 0 if not stolen
+	f_cnt_t m_stealFramesDone;				// frames of the fade out already played
 	Track* m_patternTrack;						// related pattern track
 
 	// tempo reaction
@@ -258,7 +258,11 @@ private:
 	bool m_isModulator;
 
 	/* Multiband WaveTable */
-	static sample_t s_waveTables[NumWaveShapeTables][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH];
+	using WaveShapeTable = sample_t[OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH];
+	using WaveShapeTables = WaveShapeTable[NumWaveShapeTables];
+	//! Points to s_generatedWaveTables or to the tables mapped from the cache
+	static const WaveShapeTable* s_waveTables;
+	static WaveShapeTables s_generatedWaveTables;
 	static fftwf_plan s_fftPlan;
 	static fftwf_plan s_ifftPlan;
 	static fftwf_complex * s_specBuf;
@@ -25,18 +25,16 @@
 #ifndef LMMS_GUI_OSCILLOSCOPE_H
 #define LMMS_GUI_OSCILLOSCOPE_H
 
+#include <array>
+#include <atomic>
+#include <vector>
+
 #include <QWidget>
 #include <QPixmap>
 
+#include "AudioTap.h"
 #include "LmmsTypes.h"
 
-namespace lmms
-{
-
-class SampleFrame;
-
-}
-
 namespace lmms::gui
 {
 
@@ -73,18 +71,27 @@ protected:
 	void mousePressEvent( QMouseEvent * _me ) override;
 
 
-protected slots:
-	void updateAudioBuffer(const lmms::SampleFrame* buffer);
-
 private:
+	//! Called on the tap service's thread
+	void updateAudioBuffer(const AudioTap::Analysis& analysis);
 	bool clips(float level) const;
 
 private:
 	QPixmap m_background;
 	QPointF * m_points;
 
-	SampleFrame* m_buffer;
+	//! The latest period, only used by the tap service's thread
+	std::vector<SampleFrame> m_buffer;
+	// Copies of m_buffer are passed to paintEvent() through a triple buffer.
+	// m_snapshotIndex holds the latest copy and NewSnapshot until it is painted.
+	static constexpr int NewSnapshot = 4;
+	std::array<std::vector<SampleFrame>, 3> m_snapshots;
+	std::atomic<int> m_snapshotIndex;
+	int m_writtenSnapshot;
+	int m_paintedSnapshot;
+
 	bool m_active;
+	int m_tapSubscription;
 
 	QColor m_leftChannelColor;
 	QColor m_rightChannelColor;
@@ -0,0 +1,176 @@
+/*
+ * PartitionedConvolver.h - uniformly partitioned FFT convolution
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PARTITIONED_CONVOLVER_H
+#define LMMS_PARTITIONED_CONVOLVER_H
+
+#include <complex>
+#include <vector>
+#include <fftw3.h>
+
+#include "LmmsTypes.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class SampleFrame;
+
+
+/**
+ * Convolves a stereo signal with a stereo impulse response of arbitrary length
+ * using uniformly partitioned overlap-save convolution. The latency is zero,
+ * the cost per block is two FFTs per channel plus one complex multiply-add per
+ * bin and non-silent partition of the impulse response. Silent partitions,
+ * e.g. the gaps between the taps of a delay, cost nothing.
+ */
+class LMMS_EXPORT PartitionedConvolver
+{
+	using Spectrum = std::complex<float>;
+
+public:
+	/**
+	 * The spectra of the non-silent partitions of an impulse response. Computing
+	 * them takes FFTs and allocations, so a response can be prepared on another
+	 * thread and then be exchanged with the one in use by swapImpulseResponse().
+	 */
+	class LMMS_EXPORT ImpulseResponse
+	{
+	public:
+		explicit ImpulseResponse(fpp_t blockSize);
+		~ImpulseResponse();
+
+		ImpulseResponse(const ImpulseResponse&) = delete;
+		ImpulseResponse& operator=(const ImpulseResponse&) = delete;
+
+		//! Only allocates if the response has more active partitions than all previous ones
+		void set(const SampleFrame* ir, f_cnt_t length);
+
+		fpp_t blockSize() const { return m_blockSize; }
+		std::size_t partitions() const { return m_partitions; }
+		std::size_t activePartitions() const { return m_activePartitions.size(); }
+
+	private:
+		std::size_t bins() const { return m_blockSize + 1; }
+
+		Spectrum* spectrum(std::size_t partition, ch_cnt_t ch)
+		{
+			return &m_spectra[(partition * 2 + ch) * bins()];
+		}
+
+		void swap(ImpulseResponse& other);
+
+		const fpp_t m_blockSize;
+
+		// FFT buffers of twice the block size, allocated by FFTW for proper alignment
+		float* m_timeBuffer;
+		fftwf_complex* m_spectrumBuffer;
+		fftwf_plan m_forward;
+
+		std::vector<Spectrum> m_spectra;
+		std::vector<std::size_t> m_activePartitions;
+		std::size_t m_partitions;
+
+		friend class PartitionedConvolver;
+	} ;
+
+	/**
+	 * @param blockSize Number of frames passed to each process() call
+	 * @param maxLength Longest impulse response expected, the input history is allocated for it
+	 */
+	explicit PartitionedConvolver(fpp_t blockSize, f_cnt_t maxLength = 0);
+	~PartitionedConvolver();
+
+	PartitionedConvolver(const PartitionedConvolver&) = delete;
+	PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+	/**
+	 * Sets the impulse response used for subsequent blocks. The input history
+	 * is kept, so the response can be changed while playing. Only allocates if
+	 * the response is longer than all previous ones.
+	 */
+	void setImpulseResponse(const SampleFrame* ir, f_cnt_t length);
+
+	/**
+	 * Exchanges the impulse response used for subsequent blocks with @p response,
+	 * which must have the same block size. Like setImpulseResponse(), but without
+	 * any FFTs, and without allocating if the response is at most as long as the
+	 * maximum length passed to the constructor.
+	 */
+	void swapImpulseResponse(ImpulseResponse& response);
+
+	//! Convolves one block of blockSize() frames and adds the result to @p out
+	void process(const SampleFrame* in, SampleFrame* out);
+
+	//! Clears the input history
+	void reset();
+
+	fpp_t blockSize() const { return m_blockSize; }
+
+	//! Number of blocks after the last non-silent input until the output is silent
+	std::size_t tailBlocks() const { return m_response.partitions(); }
+
+	std::size_t activePartitions() const { return m_response.activePartitions(); }
+
+	//! Number of partitions of @p ir that contain non-zero samples
+	static std::size_t activePartitions(const SampleFrame* ir, f_cnt_t length, fpp_t blockSize);
+
+	//! Rough number of floating point operations per process() call, to compare with other algorithms
+	static float estimatedCost(std::size_t activePartitions, fpp_t blockSize);
+
+private:
+	std::size_t bins() const { return m_blockSize + 1; }
+
+	Spectrum* inputSpectrum(std::size_t slot, ch_cnt_t ch)
+	{
+		return &m_inputSpectra[(slot * 2 + ch) * bins()];
+	}
+
+	//! Grows the frequency domain delay line to hold @p partitions blocks
+	void reserveInputSlots(std::size_t partitions);
+
+	const fpp_t m_blockSize;
+
+	// FFT buffers of twice the block size, allocated by FFTW for proper alignment
+	float* m_timeBuffer;
+	fftwf_complex* m_spectrumBuffer;
+	fftwf_plan m_forward;
+	fftwf_plan m_backward;
+
+	//! The last two blocks of input for each channel
+	std::vector<float> m_history[2];
+
+	ImpulseResponse m_response;
+
+	//! Spectra of past input blocks (frequency domain delay line), used as ring buffer
+	std::vector<Spectrum> m_inputSpectra;
+	std::size_t m_inputSlots;
+	std::size_t m_inputPosition;
+
+	std::vector<Spectrum> m_accumulator;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_PARTITIONED_CONVOLVER_H
@@ -25,6 +25,8 @@
 #ifndef LMMS_PATTERN_STORE_H
 #define LMMS_PATTERN_STORE_H
 
+#include <vector>
+
 #include "TrackContainer.h"
 #include "ComboBoxModel.h"
 
@@ -103,8 +105,16 @@ signals:
 	void trackUpdated();
 
 private:
+	//! lengthOfPattern() in ticks, cached for playback until clips change
+	tick_t playbackLength(int pattern);
+
 	ComboBoxModel m_patternComboBoxModel;
 
+	// only used by the audio thread
+	std::vector<tick_t> m_playbackLengths;
+	unsigned m_playbackLengthsRevision;
+	tick_t m_playbackLengthsTicksPerBar;
+
 
 	// Where the pattern selection combo box is
 	friend class gui::PatternEditorWindow;
@@ -25,6 +25,8 @@
 #ifndef LMMS_PATTERN_TRACK_H
 #define LMMS_PATTERN_TRACK_H
 
+#include <vector>
+
 #include <QMap>
 
 #include "Track.h"
@@ -88,11 +90,32 @@ protected:
 
 
 private:
+	//! Rebuilds the timeline if any clip, or the pattern, changed since it was built
+	void updateTimeline();
+
 	QList<Track *> m_disabledTracks;
 
 	using infoMap = QMap<PatternTrack*, int>;
 	static infoMap s_infoMap;
 
+	//! What playback needs to know about an unmuted clip, in ticks
+	struct TimelineEntry
+	{
+		tick_t start;
+		tick_t end;
+		tick_t startTimeOffset;
+	};
+
+	//! The unmuted clips sorted by start, so playback finds the current clip
+	//! without scanning all of them every tick
+	std::vector<TimelineEntry> m_timeline;
+	//! The latest end of the entries up to each index
+	std::vector<tick_t> m_timelineMaxEnd;
+	unsigned m_timelineRevision;
+	tick_t m_timelineTicksPerBar;
+	int m_timelinePattern;
+	tick_t m_timelinePatternLength;
+
 	friend class gui::PatternTrackView;
 } ;
 
@@ -0,0 +1,79 @@
+/*
+ * PlanarBuffer.h - owning buffer with one array per channel
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PLANAR_BUFFER_H
+#define LMMS_PLANAR_BUFFER_H
+
+#include <array>
+#include <cassert>
+#include <span>
+#include <vector>
+
+#include "AudioBufferView.h"
+#include "lmms_constants.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * Stereo audio stored as one contiguous array per channel, the layout most
+ * plugin APIs use for their ports. Effect chains keep their audio in here
+ * while planar effects follow each other, so it is only converted from and to
+ * interleaved SampleFrames where a native effect needs that.
+ */
+class LMMS_EXPORT PlanarBuffer
+{
+public:
+	using View = PlanarBufferView<float, DEFAULT_CHANNELS>;
+
+	explicit PlanarBuffer(f_cnt_t frames);
+
+	PlanarBuffer(const PlanarBuffer&) = delete;
+	PlanarBuffer& operator=(const PlanarBuffer&) = delete;
+
+	f_cnt_t frames() const { return m_frames; }
+
+	//! The first `frames` frames of the buffer
+	View view(f_cnt_t frames)
+	{
+		assert(frames <= m_frames);
+		return View{m_channels.data(), frames};
+	}
+
+	//! Copies the frames into the beginning of the buffer
+	void deinterleave(std::span<const SampleFrame> source);
+	//! Copies the first `destination.size()` frames into `destination`
+	void interleave(std::span<SampleFrame> destination) const;
+
+private:
+	f_cnt_t m_frames;
+	std::vector<float> m_data;
+	std::array<float*, DEFAULT_CHANNELS> m_channels;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_PLANAR_BUFFER_H
@@ -0,0 +1,74 @@
+/*
+ * PluginCache.h - persistent cache of plugin metadata
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PLUGIN_CACHE_H
+#define LMMS_PLUGIN_CACHE_H
+
+#include <optional>
+
+#include <QJsonObject>
+#include <QString>
+
+#include "lmms_export.h"
+
+class QFileInfo;
+
+namespace lmms
+{
+
+/**
+ * Remembers what was read from plugin libraries, so later runs don't have to
+ * load them just to list the plugins. Entries are keyed by the library's path
+ * and only used while its modification time and size are unchanged.
+ *
+ * The cache is read on construction and written to the cache directory (see
+ * WaveTableCache::directory()) on destruction. Entries of libraries that were
+ * not looked up during the scan are dropped, so removed plugins disappear.
+ */
+class LMMS_EXPORT PluginCache
+{
+public:
+	explicit PluginCache(const QString& name);
+	~PluginCache();
+
+	PluginCache(const PluginCache&) = delete;
+	PluginCache& operator=(const PluginCache&) = delete;
+
+	//! Returns what was stored for the library, or nothing if it changed since
+	std::optional<QJsonObject> find(const QFileInfo& library);
+	void insert(const QFileInfo& library, const QJsonObject& data);
+
+	//! Ignore all cached data from now on, e.g. after plugins were updated in place
+	static void setRescan(bool rescan);
+
+private:
+	QString m_path;
+	QJsonObject m_stored;
+	QJsonObject m_current;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_PLUGIN_CACHE_H
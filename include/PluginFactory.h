@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 
+#include <QByteArray>
 #include <QFileInfo>
 #include <QList>
 #include <QString>
@@ -36,6 +37,7 @@
 #include "lmms_export.h"
 #include "Plugin.h"
 
+class QJsonObject;
 class QLibrary;  // IWYU pragma: keep
 
 namespace lmms
@@ -48,16 +50,41 @@ public:
 	{
 		QString name() const;
 		QFileInfo file;
+		//! May be null if the descriptor was read from the cache, see PluginFactory::library()
 		std::shared_ptr<QLibrary> library = nullptr;
 		Plugin::Descriptor* descriptor = nullptr;
 
-		bool isNull() const {return ! library;}
+		bool isNull() const {return ! descriptor;}
 	};
 	using PluginInfoList = QList<PluginInfo>;
 	using DescriptorMap = QMultiMap<Plugin::Type, Plugin::Descriptor*>;
 
+	//! A descriptor read from the PluginCache along with the data it points to
+	struct CachedDescriptor
+	{
+		explicit CachedDescriptor(const QJsonObject& data);
+		~CachedDescriptor();
+
+		//! Whether the descriptor can be restored from the cache later
+		static bool isCacheable(const Plugin::Descriptor& descriptor);
+
+		//! Must be called while the plugin's library is loaded, as the logo
+		//! is stored as an image. It is in the library's resources.
+		static QJsonObject toJson(const Plugin::Descriptor& descriptor);
+
+		std::string name;
+		std::string displayName;
+		std::string description;
+		std::string author;
+		std::string supportedFileTypes;
+		//! PNG encoded logo, empty if the plugin has none
+		QByteArray logoImage;
+		std::unique_ptr<PixmapLoader> logo;
+		Plugin::Descriptor descriptor;
+	};
+
 	PluginFactory();
-	~PluginFactory() = default;
+	~PluginFactory();
 
 	static void setupSearchPaths();
 	static QList<QRegularExpression> getExcludePatterns(const char* envVar);
@@ -87,6 +114,11 @@ public:
 	/// PluginInfo::isNull() to check this).
 	PluginInfo pluginInfo(const char* name) const;
 
+	/// Returns the loaded library of the plugin. Libraries of plugins whose
+	/// descriptor came from the PluginCache are only loaded here, when the
+	/// plugin is instantiated for the first time. Returns nullptr on failure.
+	std::shared_ptr<QLibrary> library(const PluginInfo& info);
+
 	/// When loading a library fails during discovery, the error string is saved.
 	/// It can be retrieved by calling this function.
 	QString errorString(QString pluginName) const;
@@ -100,6 +132,7 @@ private:
 
 	QMap<QString, PluginInfoAndKey> m_pluginByExt;
 	std::vector<std::string> m_garbage; //!< cleaned up at destruction
+	std::vector<std::unique_ptr<CachedDescriptor>> m_cachedDescriptors;
 
 	QHash<QString, QString> m_errors;
 
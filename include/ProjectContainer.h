@@ -0,0 +1,143 @@
+/*
+ * ProjectContainer.h - project file with the sample data stored next to the XML
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PROJECT_CONTAINER_H
+#define LMMS_PROJECT_CONTAINER_H
+
+#include <map>
+#include <memory>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "SampleBuffer.h"
+#include "lmms_export.h"
+
+class QDomDocument;
+class QIODevice;
+
+namespace lmms
+{
+
+
+/**
+ * A project file (.mmpc) that keeps sample data out of the XML. Samples that
+ * projects would otherwise embed as Base64 (recorded clips, samples of
+ * instruments without a file) are stored once per content as raw frames,
+ * aligned so the file can be mapped into memory, and the XML refers to them
+ * by the hash of their data.
+ *
+ * Layout, all integers little endian:
+ *
+ *   header: "LMMSPRJC", version (u32), number of samples (u32),
+ *           offset and size of the compressed XML (2 x u64)
+ *   index:  per sample the SHA-256 of its data (32 bytes), offset and size (2 x u64)
+ *   data:   the samples as native SampleFrames, each starting at a page boundary
+ *   XML:    the project, compressed like .mmpz files
+ *
+ * While a container is saved or loaded, it is made active with a Scope and
+ * saveSample() / loadSample() go through it. Otherwise they fall back to
+ * Base64, so clipboard data, presets and the undo journal are unaffected.
+ */
+class LMMS_EXPORT ProjectContainer
+{
+public:
+	//! Creates an empty container, to be filled while saving a project
+	ProjectContainer() = default;
+	~ProjectContainer();
+
+	ProjectContainer(const ProjectContainer&) = delete;
+	ProjectContainer& operator=(const ProjectContainer&) = delete;
+
+	static bool isContainerFile(const QString& fileName);
+
+	//! Maps the container @p fileName into memory, returns nullptr if it is not a valid container
+	static std::unique_ptr<ProjectContainer> open(const QString& fileName);
+
+	//! The uncompressed XML of an opened container
+	QByteArray xml() const;
+
+	//! Writes the samples collected so far and @p xml to @p device
+	bool write(QIODevice& device, const QByteArray& xml) const;
+
+	//! Moves sample data embedded as Base64 into the container, e.g. when converting a .mmpz file
+	void extractSamples(QDomDocument& doc);
+	//! Embeds the referenced samples as Base64 again, e.g. when converting to a .mmpz file.
+	//! Returns false if a sample is too large to be embedded, its data is left empty then.
+	bool embedSamples(QDomDocument& doc) const;
+
+	//! Returns how @p buffer is stored in the project: a reference into the active container or Base64
+	static QString saveSample(const std::shared_ptr<const SampleBuffer>& buffer);
+	//! Reverses saveSample()
+	static std::shared_ptr<const SampleBuffer> loadSample(
+		const QString& data, int sampleRate = Engine::audioEngine()->outputSampleRate());
+
+	//! Makes @p container the one samples are saved to and loaded from while the scope exists
+	class LMMS_EXPORT Scope
+	{
+	public:
+		explicit Scope(ProjectContainer* container);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		ProjectContainer* m_previous;
+	} ;
+
+private:
+	//! Sample data, pointing into the mapped file, a buffer that owns it or its own bytes.
+	//! Samples may be larger than a QByteArray can hold, so the size is 64 bit.
+	struct Blob
+	{
+		const char* data;
+		quint64 size;
+		std::shared_ptr<const SampleBuffer> owner;
+		QByteArray bytes;
+	} ;
+
+	//! Makes a blob that owns @p bytes
+	static Blob blobOf(QByteArray bytes);
+
+	QString addSample(Blob blob);
+	std::shared_ptr<const SampleBuffer> sample(const QString& id, int sampleRate);
+
+	QFile m_file;
+	const uchar* m_map = nullptr;
+	QByteArray m_compressedXml;
+
+	//! Keyed by the hex encoded hash
+	std::map<QString, Blob> m_blobs;
+	//! Samples referenced more than once share the buffer
+	std::map<QString, std::weak_ptr<const SampleBuffer>> m_loaded;
+
+	static ProjectContainer* s_active;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_PROJECT_CONTAINER_H
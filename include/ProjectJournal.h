@@ -25,8 +25,12 @@
 #ifndef LMMS_PROJECT_JOURNAL_H
 #define LMMS_PROJECT_JOURNAL_H
 
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+#include <QByteArray>
 #include <QHash>
-#include <QStack>
 
 #include "LmmsTypes.h"
 #include "DataFile.h"
@@ -39,11 +43,30 @@ namespace lmms
 class JournallingObject;
 
 
+/**
+ * Compact state of a journalling object, recorded instead of a full snapshot
+ * where the object knows what an edit can change, e.g. the value of a model
+ * or the notes of a MIDI clip. See JournallingObject::saveJournalDelta().
+ */
+class JournalDelta
+{
+public:
+	virtual ~JournalDelta() = default;
+
+	//! Approximate memory used by this delta, counted against the undo budget
+	virtual std::size_t size() const = 0;
+
+	//! Sets the object back to the recorded state. Journalling is disabled meanwhile.
+	virtual void restore(JournallingObject* object) const = 0;
+} ;
+
+
 //! @warning many parts of this class may be rewritten soon
 class ProjectJournal
 {
 public:
-	static const int MAX_UNDO_STATES;
+	//! Memory the undo history may use before the oldest checkpoints are dropped
+	static const std::size_t DefaultMaxMemoryUsage; // TODO: make this configurable in settings
 
 	ProjectJournal();
 	virtual ~ProjectJournal() = default;
@@ -54,6 +77,14 @@ public:
 	bool canUndo() const;
 	bool canRedo() const;
 
+	//! Bytes used by the undo and redo history
+	std::size_t memoryUsage() const
+	{
+		return m_checkPointBytes;
+	}
+
+	void setMaxMemoryUsage( std::size_t bytes );
+
 	void addJournalCheckPoint( JournallingObject *jo );
 
 	bool isJournalling() const
@@ -102,22 +133,30 @@ public:
 private:
 	using JoIdMap = QHash<jo_id_t, JournallingObject*>;
 
+	//! Either a delta or a compressed snapshot of the object
 	struct CheckPoint
 	{
-		CheckPoint( jo_id_t initID = 0, const DataFile& initData = DataFile( DataFile::Type::JournalData ) ) :
-			joID( initID ),
-			data( initData )
-		{
-		}
 		jo_id_t joID;
-		DataFile data;
+		std::unique_ptr<const JournalDelta> delta;
+		QByteArray snapshot;
+
+		std::size_t size() const;
 	} ;
-	using CheckPointStack = QStack<CheckPoint>;
+	using CheckPointStack = std::deque<CheckPoint>;
+
+	static CheckPoint saveCheckPoint(JournallingObject* jo);
+	void restoreCheckPoint(JournallingObject* jo, const CheckPoint& c);
+	void pushUndoCheckPoint(CheckPoint c);
+	void trimUndoCheckPoints();
+	void clearRedoCheckPoints();
 
 	JoIdMap m_joIDs;
 
 	CheckPointStack m_undoCheckPoints;
 	CheckPointStack m_redoCheckPoints;
+	//! Bytes used by all checkpoints in both stacks
+	std::size_t m_checkPointBytes;
+	std::size_t m_maxMemoryUsage;
 
 	bool m_journalling;
 
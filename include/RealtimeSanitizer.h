@@ -0,0 +1,101 @@
+/*
+ * RealtimeSanitizer.h - detect realtime-unsafe calls on the audio threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_REALTIME_SANITIZER_H
+#define LMMS_REALTIME_SANITIZER_H
+
+#include <cstddef>
+#include <cstdio>
+
+#include "lmmsconfig.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * When built with WANT_DEBUG_RTSAN, malloc/free, pthread_mutex_lock and
+ * file I/O are interposed. Each call made while a thread is rendering audio
+ * (see AudioEngine::isRenderingThread()) is recorded with its stack trace.
+ * Setting the environment variable LMMS_RTSAN_ABORT makes the first
+ * violation abort instead, which is useful in CI.
+ *
+ * Without WANT_DEBUG_RTSAN all functions are no-ops.
+ *
+ * Note that QMutex locks without going through pthread_mutex_lock and is
+ * therefore not detected.
+ */
+namespace RealtimeSanitizer
+{
+
+enum class Violation
+{
+	Allocation,
+	Deallocation,
+	Lock,
+	FileIo
+};
+
+#ifdef LMMS_DEBUG_RTSAN
+
+//! Number of violations since start or the last reset()
+LMMS_EXPORT std::size_t violationCount();
+
+//! Print all recorded violations, grouped by identical stack traces
+LMMS_EXPORT void report(std::FILE* out);
+
+LMMS_EXPORT void reset();
+
+//! Suppresses violations on the calling thread while in scope, e.g. for
+//! known issues that should not hide new ones
+class LMMS_EXPORT ScopedAllow
+{
+public:
+	ScopedAllow();
+	~ScopedAllow();
+	ScopedAllow(const ScopedAllow&) = delete;
+	ScopedAllow& operator=(const ScopedAllow&) = delete;
+};
+
+#else
+
+inline std::size_t violationCount() { return 0; }
+inline void report(std::FILE*) {}
+inline void reset() {}
+
+class ScopedAllow
+{
+public:
+	ScopedAllow() = default;
+	ScopedAllow(const ScopedAllow&) = delete;
+	ScopedAllow& operator=(const ScopedAllow&) = delete;
+};
+
+#endif
+
+} // namespace RealtimeSanitizer
+
+} // namespace lmms
+
+#endif // LMMS_REALTIME_SANITIZER_H
@@ -0,0 +1,122 @@
+/*
+ * RenderServer.h - render projects on request from a local socket
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_RENDER_SERVER_H
+#define LMMS_RENDER_SERVER_H
+
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QObject>
+#include <QPointer>
+
+#include "OutputSettings.h"
+#include "ProjectRenderer.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+namespace lmms
+{
+
+class RenderManager;
+
+
+/**
+ * Keeps the engine, the plugin descriptors and decoded samples loaded and
+ * renders one project after another, so each job only pays for loading the
+ * song itself.
+ *
+ * Clients connect to a local socket (a Unix domain socket, or a named pipe on
+ * Windows) and send one JSON object per line:
+ *
+ *   {"id": 1, "project": "/path/song.mmpz", "output": "/path/song.wav"}
+ *
+ * Optional keys are "format" ("wav", "flac", "ogg", "mp3"), "sampleRate",
+ * "bitrate", "bitDepth" (16, 24 or 32), "stereoMode" ("s", "j", "m"), "loop"
+ * and "tracks", which renders each track into the "output" directory like
+ * the rendertracks action does.
+ *
+ * Jobs are rendered in the order they arrive. When a job is done, the server
+ * answers with a line containing the "id" of the job and either
+ * "status": "ok" with the load and render times in milliseconds, or
+ * "status": "error" with a "message".
+ *
+ * {"command": "status"} reports the number of queued jobs and
+ * {"command": "shutdown"} exits after the running job.
+ */
+class RenderServer : public QObject
+{
+	Q_OBJECT
+public:
+	explicit RenderServer(QObject* parent = nullptr);
+	~RenderServer() override;
+
+	bool listen(const QString& socketName);
+	QString errorString() const;
+
+private slots:
+	void acceptConnection();
+	void finishJob();
+
+private:
+	struct Job
+	{
+		QPointer<QLocalSocket> client;
+		QJsonValue id;
+		QString project;
+		QString output;
+		OutputSettings outputSettings;
+		ProjectRenderer::ExportFileFormat format;
+		bool loop;
+		bool tracks;
+	};
+
+	void readRequests(QLocalSocket* client);
+	void handleRequest(QLocalSocket* client, const QByteArray& line);
+	std::optional<Job> parseJob(QLocalSocket* client, const QJsonObject& request, QString& error) const;
+
+	void startNextJob();
+	void reply(QLocalSocket* client, const QJsonValue& id, QJsonObject response);
+	void replyError(QLocalSocket* client, const QJsonValue& id, const QString& message);
+
+	QLocalServer* m_server;
+
+	std::deque<Job> m_queue;
+	std::optional<Job> m_currentJob;
+	std::unique_ptr<RenderManager> m_renderManager;
+
+	QElapsedTimer m_jobTimer;
+	qint64 m_loadTime = 0;
+	bool m_shutdownRequested = false;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_RENDER_SERVER_H
@@ -87,6 +87,13 @@ public:
 	static std::shared_ptr<const SampleBuffer> fromBase64(
 		const QString& str, int sampleRate = Engine::audioEngine()->outputSampleRate());
 
+	//! Makes fromFile() return the already decoded buffer as long as the file is unchanged.
+	//! Used by long-running processes that load the same samples again and again.
+	static void setCacheEnabled(bool enabled);
+
+	//! Drops cached buffers that are not in use anymore until the cache fits into maxBytes
+	static void trimCache(std::size_t maxBytes);
+
 private:
 	std::vector<SampleFrame> m_data;
 	QString m_audioFile;
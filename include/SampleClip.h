@@ -25,6 +25,7 @@
 #ifndef LMMS_SAMPLE_CLIP_H
 #define LMMS_SAMPLE_CLIP_H
 
+#include <atomic>
 #include <memory>
 #include "Clip.h"
 #include "Sample.h"
@@ -33,6 +34,7 @@ namespace lmms
 {
 
 class SampleBuffer;
+class SampleRecordWriter;
 
 namespace gui
 {
@@ -79,6 +81,9 @@ public:
 	void setIsPlaying(bool isPlaying);
 	void setSampleBuffer(std::shared_ptr<const SampleBuffer> sb);
 
+	//! Takes the writer prepared when recording was armed, or nullptr if there is none. Realtime safe.
+	SampleRecordWriter* takeRecordWriter();
+
 	SampleClip* clone() override
 	{
 		return new SampleClip(*this);
@@ -91,6 +96,10 @@ public slots:
 	void playbackPositionChanged();
 	void updateTrackClips();
 
+private slots:
+	//! Starts a writer when recording is armed, so the audio thread doesn't have to
+	void updateRecordWriter();
+
 protected:
 	SampleClip( const SampleClip& orig );
 
@@ -98,6 +107,7 @@ private:
 	Sample m_sample;
 	BoolModel m_recordModel;
 	bool m_isPlaying;
+	std::atomic<SampleRecordWriter*> m_recordWriter = nullptr;
 
 	friend class gui::SampleClipView;
 
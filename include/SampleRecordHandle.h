@@ -25,10 +25,6 @@
 #ifndef LMMS_SAMPLE_RECORD_HANDLE_H
 #define LMMS_SAMPLE_RECORD_HANDLE_H
 
-#include <QList>
-#include <QPair>
-#include <memory>
-
 #include "PlayHandle.h"
 #include "TimePos.h"
 
@@ -37,8 +33,8 @@ namespace lmms
 
 
 class PatternTrack;
-class SampleBuffer;
 class SampleClip;
+class SampleRecordWriter;
 class Track;
 
 
@@ -54,15 +50,11 @@ public:
 	bool isFromTrack( const Track * _track ) const override;
 
 	f_cnt_t framesRecorded() const;
-	std::shared_ptr<const SampleBuffer> createSampleBuffer();
 
 
 private:
-	virtual void writeBuffer( const SampleFrame* _ab,
-						const f_cnt_t _frames );
-
-	using bufferList = QList<QPair<SampleFrame*, f_cnt_t>>;
-	bufferList m_buffers;
+	//! Streams the recording to disk, taken from the clip and deletes itself after we finish it
+	SampleRecordWriter* m_writer;
 	f_cnt_t m_framesRecorded;
 	TimePos m_minLength;
 
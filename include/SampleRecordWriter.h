@@ -0,0 +1,86 @@
+/*
+ * SampleRecordWriter.h - streams recorded audio to a file
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SAMPLE_RECORD_WRITER_H
+#define LMMS_SAMPLE_RECORD_WRITER_H
+
+#include <atomic>
+
+#include <QPointer>
+#include <QThread>
+
+#include "LmmsSemaphore.h"
+#include "LmmsTypes.h"
+#include "LocklessRingBuffer.h"
+#include "SampleFrame.h"
+
+namespace lmms
+{
+
+class SampleClip;
+
+
+/**
+ * Writes the frames recorded into a clip to an RF64 file in the user's
+ * recordings directory while recording is still going on, so long takes
+ * neither pile up in memory nor have to be assembled when recording stops.
+ * Recordings that stay below 4 GiB are written as plain WAV files.
+ *
+ * The writer is created and started on the GUI thread when recording is
+ * armed. The audio thread hands frames over through a lockless queue and
+ * wakes the writer through a semaphore; writing, and loading the finished
+ * file into the clip, happen on this thread. The writer deletes itself once
+ * it is done.
+ */
+class SampleRecordWriter : public QThread
+{
+public:
+	SampleRecordWriter(SampleClip* clip, sample_rate_t sampleRate);
+
+	//! Queues frames for writing. Realtime safe, but must always be called from the same thread.
+	void write(const SampleFrame* frames, f_cnt_t count);
+
+	//! Stops recording without waiting for the remaining frames to be written. Realtime safe.
+	void finish();
+
+private:
+	void run() override;
+
+	//! How much audio may be queued while the disk is busy
+	static constexpr int QueueSeconds = 4;
+
+	const sample_rate_t m_sampleRate;
+	QPointer<SampleClip> m_clip;
+
+	LocklessRingBuffer<SampleFrame> m_queue;
+	//! Posted whenever frames were queued or recording finished
+	Semaphore m_wakeUp;
+	std::atomic<bool> m_finishing = false;
+	std::atomic<f_cnt_t> m_framesDropped = 0;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_SAMPLE_RECORD_WRITER_H
@@ -0,0 +1,120 @@
+/*
+ * VoiceManager.h - limits polyphony and keeps the audio engine within its CPU budget
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_VOICE_MANAGER_H
+#define LMMS_VOICE_MANAGER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "PlayHandle.h"
+
+namespace lmms
+{
+
+class AudioEngineProfiler;
+class InstrumentTrack;
+class NotePlayHandle;
+
+
+/**
+ * Decides which notes to fade out ("steal") when an instrument track exceeds
+ * its maximum polyphony or when the audio engine's CPU load exceeds the
+ * configured load target.
+ *
+ * Instead of refusing new notes under load, the voice budget is derived from
+ * the per-voice cost measured by the AudioEngineProfiler. Voices of tracks with
+ * a lower priority are stolen first, then released voices, then the quietest
+ * and finally the oldest ones.
+ */
+class VoiceManager
+{
+public:
+	VoiceManager();
+
+	//! If disabled, the audio engine refuses new notes on overload instead
+	bool isEnabled() const
+	{
+		return m_enabled;
+	}
+
+	//! CPU load in percent the voice budget is computed for
+	int loadTarget() const
+	{
+		return m_loadTarget;
+	}
+
+	/**
+	 * Steals voices from @p handles where needed. Must be called by the audio
+	 * thread before rendering the instruments.
+	 *
+	 * @param limitLoad Whether to steal voices because of CPU load, e.g.
+	 *        false while exporting
+	 * @return Number of voices that are going to be rendered in this period
+	 */
+	std::size_t process(const PlayHandleList& handles, const AudioEngineProfiler& profiler,
+		sample_rate_t sampleRate, bool limitLoad);
+
+	struct Voice
+	{
+		NotePlayHandle* handle;
+		//! Only used to group the voices by track
+		const InstrumentTrack* track;
+		int maxPolyphony;
+		int priority;
+		bool released;
+		float level;
+		f_cnt_t age;
+		bool steal = false;
+	};
+
+	//! Whether @p a should be stolen before @p b
+	static bool stealBefore(const Voice& a, const Voice& b);
+
+	//! Marks the voices exceeding the maximum polyphony of their track, reorders @p voices
+	static void markOverPolyphony(std::vector<Voice>& voices);
+
+	//! Marks voices until at most @p budget are left unmarked, reorders @p voices
+	static void markOverBudget(std::vector<Voice>& voices, std::size_t budget);
+
+	//! Number of voices fitting into @p loadTarget, or SIZE_MAX if the load is below it
+	static std::size_t voiceBudget(int loadTarget, int cpuLoad, int instrumentsLoad, float voiceLoad);
+
+private:
+	//! Fades out the marked voices and removes them from m_voices, returns whether there were any
+	bool stealMarked(f_cnt_t fadeFrames);
+
+	bool m_enabled;
+	int m_loadTarget;
+
+	//! Periods to wait after stealing before the load measurement is trusted again
+	int m_holdOff;
+
+	std::vector<Voice> m_voices;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_VOICE_MANAGER_H
@@ -0,0 +1,73 @@
+/*
+ * WaveTableCache.h - persistent cache for precomputed tables and FFTW wisdom
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_WAVE_TABLE_CACHE_H
+#define LMMS_WAVE_TABLE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include <QString>
+
+#include "lmms_export.h"
+
+/**
+ * Tables that are expensive to compute on startup, like the band-limited
+ * wave tables, are stored in versioned and checksummed files in the cache
+ * directory and memory-mapped read-only by later runs. Concurrent processes
+ * share the mapped pages. Files are replaced atomically, so processes never
+ * see partially written tables.
+ *
+ * The directory defaults to the user's cache location and can be changed
+ * with the environment variable LMMS_CACHE_DIR, e.g. to share it between
+ * render nodes.
+ */
+namespace lmms::WaveTableCache
+{
+
+//! Directory of the cache files, also used for other caches like the plugin cache
+LMMS_EXPORT QString directory();
+
+//! Combines everything the table contents depend on (sizes, constants, a
+//! version of the generating code) into a key. A cached table is only used
+//! if its key matches.
+LMMS_EXPORT std::uint64_t key(std::initializer_list<std::uint64_t> values);
+
+//! Returns the contents of a valid cache file with the given name, key and
+//! size, mapped read-only for the lifetime of the process, or nullptr.
+LMMS_EXPORT const void* map(const QString& name, std::uint64_t key, std::size_t size);
+
+//! Writes a cache file for later runs. Failing is not an error, the tables just get regenerated.
+LMMS_EXPORT bool store(const QString& name, std::uint64_t key, const void* data, std::size_t size);
+
+//! Imports FFTW wisdom from the cache. Call before creating FFTW plans.
+LMMS_EXPORT bool loadFftwWisdom();
+
+//! Stores the FFTW wisdom if plans were created that it did not know yet
+LMMS_EXPORT void saveFftwWisdom();
+
+} // namespace lmms::WaveTableCache
+
+#endif // LMMS_WAVE_TABLE_CACHE_H
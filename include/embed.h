@@ -81,12 +81,14 @@ public:
 
 	virtual ~PixmapLoader() = default;
 
-	auto pixmap(int width = -1, int height = -1) const -> QPixmap
+	virtual auto pixmap(int width = -1, int height = -1) const -> QPixmap
 	{
 		return embed::getIconPixmap(m_name, width, height, m_xpm);
 	}
 
 	auto pixmapName() const -> const std::string& { return m_name; }
+	//! The compiled-in XPM data, or nullptr if the pixmap is loaded from the artwork
+	auto xpm() const -> const char* const* { return m_xpm; }
 
 private:
 	std::string m_name;
@@ -27,6 +27,7 @@
 
 #include "InstrumentTrack.h"
 #include "PathUtil.h"
+#include "ProjectContainer.h"
 #include "Song.h"
 
 #include "LmmsTypes.h"
@@ -197,7 +198,7 @@ void AudioFileProcessor::saveSettings(QDomDocument& doc, QDomElement& elem)
 	elem.setAttribute("src", m_sample.sampleFile());
 	if (m_sample.sampleFile().isEmpty())
 	{
-		elem.setAttribute("sampledata", m_sample.toBase64());
+		elem.setAttribute("sampledata", ProjectContainer::saveSample(m_sample.buffer()));
 	}
 	m_reverseModel.saveSettings(doc, elem, "reversed");
 	m_loopModel.saveSettings(doc, elem, "looped");
@@ -224,7 +225,7 @@ void AudioFileProcessor::loadSettings(const QDomElement& elem)
 	}
 	else if (auto sampleData = elem.attribute("sampledata"); !sampleData.isEmpty())
 	{
-		m_sample = Sample(SampleBuffer::fromBase64(sampleData));
+		m_sample = Sample(ProjectContainer::loadSample(sampleData));
 	}
 
 	m_loopModel.loadSettings(elem, "looped");
@@ -66,8 +66,8 @@ DynProcEffect::DynProcEffect( Model * _parent,
 	m_dpControls( this )
 {
 	m_currentPeak[0] = m_currentPeak[1] = DYN_NOISE_FLOOR;
-	m_rms[0] = new RmsHelper( 64 * Engine::audioEngine()->outputSampleRate() / 44100 );
-	m_rms[1] = new RmsHelper( 64 * Engine::audioEngine()->outputSampleRate() / 44100 );
+	m_rms[0] = new RmsHelper( 64 * sampleRate() / 44100 );
+	m_rms[1] = new RmsHelper( 64 * sampleRate() / 44100 );
 	calcAttack();
 	calcRelease();
 }
@@ -84,12 +84,12 @@ DynProcEffect::~DynProcEffect()
 
 inline void DynProcEffect::calcAttack()
 {
-	m_attCoeff = std::exp((DNF_LOG / (m_dpControls.m_attackModel.value() * 0.001)) / Engine::audioEngine()->outputSampleRate());
+	m_attCoeff = std::exp((DNF_LOG / (m_dpControls.m_attackModel.value() * 0.001)) / sampleRate());
 }
 
 inline void DynProcEffect::calcRelease()
 {
-	m_relCoeff = std::exp((DNF_LOG / (m_dpControls.m_releaseModel.value() * 0.001)) / Engine::audioEngine()->outputSampleRate());
+	m_relCoeff = std::exp((DNF_LOG / (m_dpControls.m_releaseModel.value() * 0.001)) / sampleRate());
 }
 
 
@@ -116,8 +116,8 @@ Effect::ProcessStatus DynProcEffect::processImpl(SampleFrame* buf, const fpp_t f
 
 	if( m_needsUpdate )
 	{
-		m_rms[0]->setSize( 64 * Engine::audioEngine()->outputSampleRate() / 44100 );
-		m_rms[1]->setSize( 64 * Engine::audioEngine()->outputSampleRate() / 44100 );
+		m_rms[0]->setSize( 64 * sampleRate() / 44100 );
+		m_rms[1]->setSize( 64 * sampleRate() / 44100 );
 		calcAttack();
 		calcRelease();
 		m_needsUpdate = false;
@@ -217,6 +217,15 @@ void DynProcEffect::processBypassedImpl()
 	m_currentPeak[0] = m_currentPeak[1] = DYN_NOISE_FLOOR;
 }
 
+void DynProcEffect::onOversamplingChanged()
+{
+	// the engine is locked, so resize the RMS buffers here instead of while processing
+	m_rms[0]->setSize( 64 * sampleRate() / 44100 );
+	m_rms[1]->setSize( 64 * sampleRate() / 44100 );
+	calcAttack();
+	calcRelease();
+}
+
 
 
 extern "C"
@@ -51,6 +51,14 @@ public:
 		return( &m_dpControls );
 	}
 
+	bool supportsOversampling() const override
+	{
+		return true;
+	}
+
+protected:
+	void onOversamplingChanged() override;
+
 
 private:
 	void calcAttack();
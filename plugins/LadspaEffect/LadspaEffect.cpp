@@ -27,9 +27,18 @@
 #include <QVarLengthArray>
 #include <QMessageBox>
 
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "LadspaEffect.h"
 #include "DataFile.h"
 #include "AudioEngine.h"
+#include "AudioEngineWorkerThread.h"
 #include "Ladspa2LMMS.h"
 #include "LadspaBase.h"
 #include "LadspaControl.h"
@@ -107,10 +116,17 @@ void LadspaEffect::changeSampleRate()
 	LadspaControls * controls = m_controls;
 	m_controls = nullptr;
 
-	m_pluginMutex.lock();
+	// wait for the audio thread to finish the current period - it will
+	// skip processing until we are done
+	auto expected = PluginState::Idle;
+	while (!m_pluginState.compare_exchange_weak(expected, PluginState::Reinstantiating))
+	{
+		expected = PluginState::Idle;
+		std::this_thread::yield();
+	}
 	pluginDestruction();
 	pluginInstantiation();
-	m_pluginMutex.unlock();
+	m_pluginState = PluginState::Idle;
 
 	controls->effectModelChanged( m_controls );
 	delete controls;
@@ -127,10 +143,32 @@ void LadspaEffect::changeSampleRate()
 
 Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t frames)
 {
-	m_pluginMutex.lock();
+	return processBuffer(InterleavedBufferView<float, DEFAULT_CHANNELS>{std::span{buf, frames}}, frames);
+}
+
+
+
+
+Effect::ProcessStatus LadspaEffect::processPlanarImpl(PlanarBuffer::View buf)
+{
+	// the port buffers are planar too, so the channels are copied as a whole
+	return processBuffer(buf, buf.frames());
+}
+
+
+
+
+template<class Buffer>
+Effect::ProcessStatus LadspaEffect::processBuffer(Buffer buf, const fpp_t frames)
+{
+	auto expected = PluginState::Idle;
+	if (!m_pluginState.compare_exchange_strong(expected, PluginState::Processing))
+	{
+		return ProcessStatus::Sleep;
+	}
 	if (!isOkay() || dontRun() || !isEnabled() || !isRunning())
 	{
-		m_pluginMutex.unlock();
+		m_pluginState = PluginState::Idle;
 		return ProcessStatus::Sleep;
 	}
 
@@ -145,12 +183,22 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 			switch( pp->rate )
 			{
 				case BufferRate::ChannelIn:
-					for (fpp_t frame = 0; frame < frames; ++frame)
+				{
+					LADSPA_Data* const out = pp->buffer;
+					if constexpr (Buffer::Interleaved)
 					{
-						pp->buffer[frame] = buf[frame][channel];
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							out[frame] = buf[frame][channel];
+						}
+					}
+					else
+					{
+						std::copy_n(buf[channel], frames, out);
 					}
 					++channel;
 					break;
+				}
 				case BufferRate::AudioRateInput:
 				{
 					ValueBuffer * vb = pp->control->valueBuffer();
@@ -165,10 +213,7 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 						// This only supports control rate ports, so the audio rates are
 						// treated as though they were control rate by setting the
 						// port buffer to all the same value.
-						for (fpp_t frame = 0; frame < frames; ++frame)
-						{
-							pp->buffer[frame] = pp->value;
-						}
+						std::fill_n(pp->buffer, frames, pp->value);
 					}
 					break;
 				}
@@ -193,10 +238,27 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 	}
 
 
-	// Process the buffers.
-	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+	// Process the buffers. The processor instances are independent, so all
+	// but the first one are handed to the worker threads while we run the
+	// first one here.
+	for (auto& job : m_processorJobs)
+	{
+		job->setFrames(frames);
+		AudioEngineWorkerThread::addJob(job.get());
+	}
+
+	(m_descriptor->run)(m_handles[0], frames);
+
+	for (auto& job : m_processorJobs)
 	{
-		(m_descriptor->run)(m_handles[proc], frames);
+		// run it here if no worker has picked it up yet, then wait for it
+		job->process();
+		while (job->state() != ThreadableJob::ProcessingState::Done)
+		{
+#ifdef __SSE__
+			_mm_pause();
+#endif
+		}
 	}
 
 	// Copy the LADSPA output buffers to the LMMS buffer.
@@ -215,12 +277,26 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 				case BufferRate::ControlRateInput:
 					break;
 				case BufferRate::ChannelOut:
-					for (fpp_t frame = 0; frame < frames; ++frame)
+				{
+					const LADSPA_Data* const in = pp->buffer;
+					if constexpr (Buffer::Interleaved)
 					{
-						buf[frame][channel] = d * buf[frame][channel] + w * pp->buffer[frame];
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							buf[frame][channel] = d * buf[frame][channel] + w * in[frame];
+						}
+					}
+					else
+					{
+						float* const out = buf[channel];
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							out[frame] = d * out[frame] + w * in[frame];
+						}
 					}
 					++channel;
 					break;
+				}
 				case BufferRate::AudioRateOutput:
 				case BufferRate::ControlRateOutput:
 					break;
@@ -230,7 +306,7 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 		}
 	}
 
-	m_pluginMutex.unlock();
+	m_pluginState = PluginState::Idle;
 
 	return ProcessStatus::ContinueIfNotQuiet;
 }
@@ -264,6 +340,12 @@ void LadspaEffect::pluginInstantiation()
 	// Categorize the ports, and create the buffers.
 	m_portCount = manager->getPortCount( m_key );
 
+	// Reserve one contiguous block large enough to give every port of
+	// every processor a full period
+	static_assert(std::is_same_v<LADSPA_Data, float>);
+	const auto framesPerPeriod = static_cast<std::size_t>(Engine::audioEngine()->framesPerPeriod());
+	m_portBuffers = AlignedBufferPool(processorCount() * m_portCount, framesPerPeriod);
+
 	int inputch = 0;
 	int outputch = 0;
 	std::array<LADSPA_Data*, 2> inbuf;
@@ -289,7 +371,7 @@ void LadspaEffect::pluginInstantiation()
 					manager->isPortInput( m_key, port ) )
 				{
 					p->rate = BufferRate::ChannelIn;
-					p->buffer = new LADSPA_Data[Engine::audioEngine()->framesPerPeriod()];
+					p->buffer = m_portBuffers.allocate(framesPerPeriod);
 					inbuf[ inputch ] = p->buffer;
 					inputch++;
 				}
@@ -304,24 +386,24 @@ void LadspaEffect::pluginInstantiation()
 					}
 					else
 					{
-						p->buffer = new LADSPA_Data[Engine::audioEngine()->framesPerPeriod()];
+						p->buffer = m_portBuffers.allocate(framesPerPeriod);
 						m_inPlaceBroken = true;
 					}
 				}
 				else if( manager->isPortInput( m_key, port ) )
 				{
 					p->rate = BufferRate::AudioRateInput;
-					p->buffer = new LADSPA_Data[Engine::audioEngine()->framesPerPeriod()];
+					p->buffer = m_portBuffers.allocate(framesPerPeriod);
 				}
 				else
 				{
 					p->rate = BufferRate::AudioRateOutput;
-					p->buffer = new LADSPA_Data[Engine::audioEngine()->framesPerPeriod()];
+					p->buffer = m_portBuffers.allocate(framesPerPeriod);
 				}
 			}
 			else
 			{
-				p->buffer = new LADSPA_Data[1];
+				p->buffer = m_portBuffers.allocate(1);
 
 				if( manager->isPortInput( m_key, port ) )
 				{
@@ -333,6 +415,17 @@ void LadspaEffect::pluginInstantiation()
 				}
 			}
 
+			if( p->buffer == nullptr )
+			{
+				QMessageBox::warning( 0, "Effect",
+					"Can't allocate port buffers: " + m_key.second,
+					QMessageBox::Ok, QMessageBox::NoButton );
+				delete p;
+				qDeleteAll( ports );
+				setOkay( false );
+				return;
+			}
+
 			p->scale = 1.0f;
 			if( manager->isEnum( m_key, port ) )
 			{
@@ -494,6 +587,11 @@ void LadspaEffect::pluginInstantiation()
 	{
 		manager->activate( m_key, m_handles[proc] );
 	}
+
+	for (ch_cnt_t proc = 1; proc < processorCount(); ++proc)
+	{
+		m_processorJobs.push_back(std::make_unique<ProcessorJob>(m_descriptor, m_handles[proc]));
+	}
 	m_controls = new LadspaControls( this );
 }
 
@@ -516,18 +614,15 @@ void LadspaEffect::pluginDestruction()
 		manager->cleanup( m_key, m_handles[proc] );
 		for( int port = 0; port < m_portCount; port++ )
 		{
-			port_desc_t * pp = m_ports.at( proc ).at( port );
-			if( m_inPlaceBroken || pp->rate != BufferRate::ChannelOut )
-			{
-				if( pp->buffer) delete[] pp->buffer;
-			}
-			delete pp;
+			delete m_ports.at( proc ).at( port );
 		}
 		m_ports[proc].clear();
 	}
 	m_ports.clear();
 	m_handles.clear();
 	m_portControls.clear();
+	m_processorJobs.clear();
+	m_portBuffers = AlignedBufferPool{};
 }
 
 extern "C"
@@ -26,12 +26,16 @@
 #ifndef _LADSPA_EFFECT_H
 #define _LADSPA_EFFECT_H
 
-#include <QMutex>
+#include <atomic>
+#include <memory>
+#include <vector>
 
+#include "AlignedBufferPool.h"
 #include "Effect.h"
 #include "ladspa.h"
 #include "LadspaControls.h"
 #include "LadspaManager.h"
+#include "ThreadableJob.h"
 
 namespace lmms
 {
@@ -48,6 +52,12 @@ public:
 	~LadspaEffect() override;
 
 	ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBuffer::View buf) override;
+
+	bool isPlanar() const override
+	{
+		return true;
+	}
 
 	void setControl( int _control, LADSPA_Data _data );
 
@@ -71,12 +81,48 @@ private slots:
 
 
 private:
+	//! Runs one mono processor instance on an audio engine worker thread
+	class ProcessorJob : public ThreadableJob
+	{
+	public:
+		ProcessorJob(const LADSPA_Descriptor* descriptor, LADSPA_Handle handle) :
+			m_descriptor(descriptor),
+			m_handle(handle)
+		{
+		}
+
+		void setFrames(fpp_t frames) { m_frames = frames; }
+
+		bool requiresProcessing() const override { return true; }
+
+	protected:
+		void doProcessing() override { (m_descriptor->run)(m_handle, m_frames); }
+
+	private:
+		const LADSPA_Descriptor* m_descriptor;
+		LADSPA_Handle m_handle;
+		fpp_t m_frames = 0;
+	};
+
+	enum class PluginState
+	{
+		Idle,
+		Processing,
+		Reinstantiating
+	};
+
+	//! Runs the plugin on an interleaved or planar buffer view
+	template<class Buffer>
+	ProcessStatus processBuffer(Buffer buf, const fpp_t frames);
+
 	void pluginInstantiation();
 	void pluginDestruction();
 
 	static sample_rate_t maxSamplerate( const QString & _name );
 
-	QMutex m_pluginMutex;
+	//! Replaces a mutex: the audio thread skips a period instead of
+	//! blocking while the plugin is being re-instantiated
+	std::atomic<PluginState> m_pluginState = PluginState::Idle;
 	LadspaControls * m_controls;
 
 	ladspa_key_t m_key;
@@ -89,6 +135,12 @@ private:
 	QVector<multi_proc_t> m_ports;
 	multi_proc_t m_portControls;
 
+	//! All port buffers of all processors, in one contiguous block
+	AlignedBufferPool m_portBuffers;
+
+	//! Jobs for the processors other than the first one
+	std::vector<std::unique_ptr<ProcessorJob>> m_processorJobs;
+
 	ch_cnt_t m_processors = 1;
 };
 
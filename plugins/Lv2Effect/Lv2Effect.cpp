@@ -61,7 +61,8 @@ Plugin::Descriptor PLUGIN_EXPORT lv2effect_plugin_descriptor =
 Lv2Effect::Lv2Effect(Model* parent, const Descriptor::SubPluginFeatures::Key *key) :
 	Effect(&lv2effect_plugin_descriptor, parent, key),
 	m_controls(this, key->attributes["uri"]),
-	m_tmpOutputSmps(Engine::audioEngine()->framesPerPeriod())
+	m_tmpOutputSmps(Engine::audioEngine()->framesPerPeriod()),
+	m_tmpPlanarOutput(Engine::audioEngine()->framesPerPeriod())
 {
 }
 
@@ -97,6 +98,36 @@ Effect::ProcessStatus Lv2Effect::processImpl(SampleFrame* buf, const fpp_t frame
 
 
 
+Effect::ProcessStatus Lv2Effect::processPlanarImpl(PlanarBuffer::View buf)
+{
+	const fpp_t frames = buf.frames();
+	const auto output = m_tmpPlanarOutput.view(frames);
+
+	m_controls.copyBuffersFromLmms(buf);
+	m_controls.copyModelsFromLmms();
+	m_controls.run(frames);
+	m_controls.copyModelsToLmms();
+	m_controls.copyBuffersToLmms(output);
+
+	bool corrupt = wetLevel() < 0; // #3261 - if w < 0, bash w := 0, d := 1
+	const float d = corrupt ? 1 : dryLevel();
+	const float w = corrupt ? 0 : wetLevel();
+	for (proc_ch_t ch = 0; ch < buf.channels(); ++ch)
+	{
+		float* const dst = buf[ch];
+		const float* const src = output[ch];
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			dst[f] = d * dst[f] + w * src[f];
+		}
+	}
+
+	return ProcessStatus::ContinueIfNotQuiet;
+}
+
+
+
+
 extern "C"
 {
 
@@ -43,6 +43,8 @@ public:
 	Lv2Effect(Model* parent, const Descriptor::SubPluginFeatures::Key* _key);
 
 	ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBuffer::View buf) override;
+	bool isPlanar() const override { return true; }
 
 	EffectControls* controls() override { return &m_controls; }
 
@@ -52,6 +54,7 @@ public:
 private:
 	Lv2FxControls m_controls;
 	std::vector<SampleFrame> m_tmpOutputSmps;
+	PlanarBuffer m_tmpPlanarOutput;
 };
 
 
@@ -29,11 +29,16 @@
 #include <QMessageBox>
 #include <QProgressDialog>
 
+#include <algorithm>
+#include <future>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "MidiImport.h"
 #include "TrackContainer.h"
+#include "AudioEngine.h"
 #include "InstrumentTrack.h"
 #include "AutomationTrack.h"
 #include "AutomationClip.h"
@@ -44,6 +49,7 @@
 #include "MainWindow.h"
 #include "TimePos.h"
 #include "Song.h"
+#include "ThreadPool.h"
 
 #include "plugin_export.h"
 
@@ -134,6 +140,52 @@ bool MidiImport::tryImport(TrackContainer* tc)
 
 
 
+namespace
+{
+
+//! A note read from a track, converted to ticks
+struct ImportedNote
+{
+	tick_t pos;
+	tick_t length;
+	int key;
+	volume_t volume;
+};
+
+//! The order MidiClip keeps its notes in, at the same position by descending key
+bool notesBefore(const ImportedNote& lhs, const ImportedNote& rhs)
+{
+	return lhs.pos < rhs.pos || (lhs.pos == rhs.pos && lhs.key > rhs.key);
+}
+
+//! A channel event other than a note, kept in the order of the track
+struct ImportedUpdate
+{
+	enum class Type
+	{
+		Channel, //!< first event on the channel in this track
+		Program,
+		Control
+	};
+
+	Type type;
+	long chan;
+	double time;
+	int id; //!< program or controller number
+	double value;
+	std::size_t name; //!< index of the track name at the time of the event
+};
+
+//! The contents of a track, ready to be turned into LMMS tracks and clips
+struct ImportedTrack
+{
+	std::vector<QString> names;
+	std::vector<ImportedUpdate> updates;
+	std::unordered_map<long, std::vector<ImportedNote>> notes;
+};
+
+
+
 class smfMidiCC
 {
 
@@ -189,7 +241,6 @@ class smfMidiChannel
 
 public:
 	InstrumentTrack* it = nullptr;
-	MidiClip* p = nullptr;
 	Instrument* it_inst = nullptr;
 	bool isSF2 = false;
 	bool hasNotes = false;
@@ -220,45 +271,133 @@ public:
 			if (trackName != "") { it->setName(tn); }
 			// General MIDI default
 			it->pitchRangeModel()->setInitValue(2);
-			// Create a default pattern
-			p = dynamic_cast<MidiClip*>(it->createClip(0));
 		}
 		return this;
 	}
 
 
-	void addNote(Note& n)
+	//! Adds the sorted notes, starting a new clip after each gap of more than a bar
+	void addNotes(const std::vector<ImportedNote>& notes)
 	{
-		if (!p) { p = dynamic_cast<MidiClip*>(it->createClip(0)); }
-		p->addNote(n, false);
-		hasNotes = true;
+		MidiClip* clip = nullptr;
+		auto clipNotes = std::vector<Note>{};
+		TimePos lastEnd(0);
+
+		for (const auto& n : notes)
+		{
+			if (!clip || n.pos > lastEnd + DefaultTicksPerBar)
+			{
+				if (clip) { clip->addNotes(clipNotes); }
+				clipNotes.clear();
+				clip = dynamic_cast<MidiClip*>(it->createClip(TimePos(TimePos(n.pos).getBar(), 0)));
+			}
+			lastEnd = n.pos + n.length;
+			clipNotes.emplace_back(n.length, n.pos - clip->startPosition(), n.key, n.volume);
+		}
+		if (clip) { clip->addNotes(clipNotes); }
+
+		hasNotes = !notes.empty();
 	}
+};
 
 
-	void splitMidiClips()
+//! Converts the events of a track into compact arrays, which is safe to run
+//! concurrently for different tracks of the same sequence
+ImportedTrack parseTrack(Alg_track_ptr trk, bool firstTrack, const QString& defaultName, double ticksPerBeat)
+{
+	auto track = ImportedTrack{};
+	track.names.push_back(defaultName);
+	auto seenChannels = std::unordered_set<long>{};
+
+	auto addUpdate = [&](ImportedUpdate::Type type, const Alg_event_ptr evt, int id, double value) {
+		track.updates.push_back({type, evt->chan, evt->time * ticksPerBeat, id, value, track.names.size() - 1});
+	};
+
+	for (int e = 0; e < trk->length(); ++e)
 	{
-		MidiClip* newMidiClip = nullptr;
-		TimePos lastEnd(0);
+		Alg_event_ptr evt = (*trk)[e];
 
-		p->rearrangeAllNotes();
-		for (auto n : p->notes())
+		if (evt->chan == -1)
 		{
-			if (!newMidiClip || n->pos() > lastEnd + DefaultTicksPerBar)
+			bool handled = false;
+			if (evt->is_update())
 			{
-				TimePos pPos = TimePos(n->pos().getBar(), 0);
-				newMidiClip = dynamic_cast<MidiClip*>(it->createClip(pPos));
+				QString attr = evt->get_attribute();
+				// seqnames is a track0 identifier (see allegro code)
+				if (attr == (firstTrack ? "seqnames" : "tracknames")
+					&& evt->get_update_type() == 's')
+				{
+					track.names.push_back(evt->get_string_value());
+					handled = true;
+				}
 			}
-			lastEnd = n->pos() + n->length();
+			if (!handled) {
+				// Write debug output, in one call as other tracks are parsed at the same time
+				QString details;
+				if (evt->is_update())
+				{
+					details = QString(", Update Type: %1").arg(evt->get_attribute());
+					if (evt->get_update_type() == 'a') {
+						details += QString(", Atom: %1").arg(evt->get_atom_value());
+					}
+				}
+				printf("MISSING GLOBAL HANDLER\n\tChn: %ld, Type Code: %d, Time: %f%s\n",
+					evt->chan, evt->get_type_code(), evt->time, details.toUtf8().constData());
+			}
+			continue;
+		}
+
+		if (seenChannels.insert(evt->chan).second)
+		{
+			addUpdate(ImportedUpdate::Type::Channel, evt, 0, 0);
+		}
 
-			Note newNote(*n);
-			newNote.setPos(n->pos(newMidiClip->startPosition()));
-			newMidiClip->addNote(newNote, false);
+		if (evt->is_note())
+		{
+			auto noteEvt = dynamic_cast<Alg_note_ptr>(evt);
+			tick_t ticks = noteEvt->get_duration() * ticksPerBeat;
+			track.notes[evt->chan].push_back({
+				static_cast<tick_t>(noteEvt->get_start_time() * ticksPerBeat),
+				ticks < 1 ? 1 : ticks,
+				static_cast<int>(noteEvt->get_identifier()),
+				// Map from MIDI velocity to LMMS volume
+				static_cast<volume_t>(noteEvt->get_loud() * (200.f / 127.f))
+			});
 		}
+		else if (evt->is_update())
+		{
+			QString update(evt->get_attribute());
 
-		delete p;
-		p = nullptr;
+			if (update == "programi")
+			{
+				addUpdate(ImportedUpdate::Type::Program, evt, evt->get_integer_value(), 0);
+			}
+			else if (update.startsWith("control") || update == "bendr")
+			{
+				int ccid = update.mid(7, update.length() - 8).toInt();
+				if (update == "bendr") { ccid = 128; }
+				if (ccid <= 128)
+				{
+					addUpdate(ImportedUpdate::Type::Control, evt, ccid, evt->get_real_value());
+				}
+			}
+			else {
+				printf("Unhandled update: %ld %d %f %s\n",
+					evt->chan, evt->get_type_code(), evt->time, evt->get_attribute());
+			}
+		}
 	}
-};
+
+	for (auto& [chan, notes] : track.notes)
+	{
+		std::stable_sort(notes.begin(), notes.end(), notesBefore);
+	}
+
+	return track;
+}
+
+
+} // namespace
 
 
 bool MidiImport::readSMF(TrackContainer* tc)
@@ -280,6 +419,19 @@ bool MidiImport::readSMF(TrackContainer* tc)
 	pd.setMaximum(seq->tracks() + preTrackSteps);
 	pd.setValue(1);
 
+	// TODO: adjust these to Time.Sig changes
+	double beatsPerBar = 4;
+	double ticksPerBeat = DefaultTicksPerBar / beatsPerBar;
+
+	// Convert the tracks in the background while the song tracks are created,
+	// the sequence is only read from here on
+	auto parsedTracks = std::vector<std::future<ImportedTrack>>{};
+	for (int t = 0; t < seq->tracks(); ++t)
+	{
+		parsedTracks.push_back(ThreadPool::instance().enqueue(parseTrack,
+			seq->track(t), t == 0, QString(tr("Track") + " %1").arg(t), ticksPerBeat));
+	}
+
 	// 128 CC + Pitch Bend
 	auto ccs = std::array<smfMidiCC, MIDI_CC_COUNT>{};
 
@@ -291,6 +443,9 @@ bool MidiImport::readSMF(TrackContainer* tc)
 	std::unordered_map<long, smfMidiChannel> chs;
 	// NOTE: unordered_map::operator[] creates a new element if none exists
 
+	// notes of each channel from all tracks, added to the clips at the end
+	std::unordered_map<long, std::vector<ImportedNote>> notes;
+
 	MeterModel & timeSigMM = Engine::getSong()->getTimeSigModel();
 	auto nt = dynamic_cast<AutomationTrack*>(Track::create(Track::Type::Automation, Engine::getSong()));
 	nt->setName(tr("MIDI Time Signature Numerator"));
@@ -303,10 +458,6 @@ bool MidiImport::readSMF(TrackContainer* tc)
 	timeSigDenominatorPat->setDisplayName(tr("Denominator"));
 	timeSigDenominatorPat->addObject(&timeSigMM.denominatorModel());
 
-	// TODO: adjust these to Time.Sig changes
-	double beatsPerBar = 4;
-	double ticksPerBeat = DefaultTicksPerBar / beatsPerBar;
-
 	// Time-sig changes
 	Alg_time_sigs* timeSigs = &seq->time_sig;
 	for (int s = 0; s < timeSigs->length(); ++s)
@@ -364,169 +515,124 @@ bool MidiImport::readSMF(TrackContainer* tc)
 	// Tracks
 	for (int t = 0; t < seq->tracks(); ++t)
 	{
-		QString trackName = QString(tr("Track") + " %1").arg(t);
-		Alg_track_ptr trk = seq->track(t);
+		const ImportedTrack track = parsedTracks[t].get();
 		pd.setValue(t + preTrackSteps);
 
 		for (auto& cc : ccs) { cc.clear(); }
 
-		// Now look at events
-		for (int e = 0; e < trk->length(); ++e)
+		for (const auto& evt : track.updates)
 		{
-			Alg_event_ptr evt = (*trk)[e];
+			const QString& trackName = track.names[evt.name];
+			smfMidiChannel* ch = chs[evt.chan].create(tc, trackName);
 
-			if (evt->chan == -1)
+			if (evt.type == ImportedUpdate::Type::Program)
 			{
-				bool handled = false;
-				if (evt->is_update())
+				const auto prog = evt.id;
+				if (ch->isSF2)
 				{
-					QString attr = evt->get_attribute();
-					// seqnames is a track0 identifier (see allegro code)
-					if (attr == (t == 0 ? "seqnames" : "tracknames")
-						&& evt->get_update_type() == 's')
-					{
-						trackName = evt->get_string_value();
-						handled = true;
+					auto& pc = pcs[evt.chan];
+					AutomatableModel* objModel = ch->it_inst->childModel("patch");
+					if (pc.at == nullptr) {
+						pc.create(tc, trackName + " > " + objModel->displayName());
 					}
+					pc.putValue(evt.time, objModel, prog);
 				}
-				if (!handled) {
-					// Write debug output
-					printf("MISSING GLOBAL HANDLER\n");
-					printf("\tChn: %ld, Type Code: %d, Time: %f", evt->chan, evt->get_type_code(), evt->time);
-					if (evt->is_update())
+				else
+				{
+					const QString num = QString::number(prog);
+					const QString filter = QString().fill('0', 3 - num.length()) + num + "*.pat";
+					const QString dir = "/usr/share/midi/"
+							"freepats/Tone_000/";
+					const QStringList files = QDir(dir).
+					entryList(QStringList(filter));
+					if (ch->it_inst && !files.empty())
 					{
-						printf(", Update Type: %s", evt->get_attribute());
-						if (evt->get_update_type() == 'a') {
-							printf(", Atom: %s", evt->get_atom_value());
-						}
+						ch->it_inst->loadFile(dir + files.front());
 					}
-					printf("\n");
 				}
 			}
-			else if (evt->is_note())
-			{
-				smfMidiChannel* ch = chs[evt->chan].create(tc, trackName);
-				auto noteEvt = dynamic_cast<Alg_note_ptr>(evt);
-				tick_t ticks = noteEvt->get_duration() * ticksPerBeat;
-				Note n(
-					ticks < 1 ? 1 : ticks,
-					noteEvt->get_start_time() * ticksPerBeat,
-					noteEvt->get_identifier(),
-					// Map from MIDI velocity to LMMS volume
-					noteEvt->get_loud() * (200.f / 127.f)
-				);
-				ch->addNote(n);
-			}
-			else if (evt->is_update())
+			else if (evt.type == ImportedUpdate::Type::Control)
 			{
-				smfMidiChannel* ch = chs[evt->chan].create(tc, trackName);
+				const int ccid = evt.id;
+				double cc = evt.value;
+				AutomatableModel* objModel = nullptr;
 
-				double time = evt->time*ticksPerBeat;
-				QString update(evt->get_attribute());
-
-				if (update == "programi")
+				switch (ccid)
 				{
-					const auto prog = evt->get_integer_value();
-					if (ch->isSF2)
-					{
-						auto& pc = pcs[evt->chan];
-						AutomatableModel* objModel = ch->it_inst->childModel("patch");
-						if (pc.at == nullptr) {
-							pc.create(tc, trackName + " > " + objModel->displayName());
-						}
-						pc.putValue(time, objModel, prog);
-					}
-					else
-					{
-						const QString num = QString::number(prog);
-						const QString filter = QString().fill('0', 3 - num.length()) + num + "*.pat";
-						const QString dir = "/usr/share/midi/"
-								"freepats/Tone_000/";
-						const QStringList files = QDir(dir).
-						entryList(QStringList(filter));
-						if (ch->it_inst && !files.empty())
+					case 0:
+						if (ch->isSF2 && ch->it_inst)
 						{
-							ch->it_inst->loadFile(dir + files.front());
+							objModel = ch->it_inst->childModel("bank");
+							printf("BANK SELECT %f %d\n", cc, static_cast<int>(cc * 127));
+							cc *= 127.0f;
 						}
-					}
+						break;
+
+					case 7:
+						objModel = ch->it->volumeModel();
+						cc *= 100.0f;
+						break;
+
+					case 10:
+						objModel = ch->it->panningModel();
+						cc = cc * 200.f - 100.0f;
+						break;
+
+					case 128:
+						objModel = ch->it->pitchModel();
+						cc = cc * 100.0f;
+						break;
+
+					default:
+						//TODO: something useful for other CCs
+						break;
 				}
-				else if (update.startsWith("control") || update == "bendr")
+
+				if (objModel)
 				{
-					int ccid = update.mid(7, update.length() - 8).toInt();
-					if (update == "bendr") { ccid = 128; }
-					if (ccid <= 128)
+					if (evt.time == 0 && objModel)
 					{
-						double cc = evt->get_real_value();
-						AutomatableModel* objModel = nullptr;
-
-						switch (ccid)
-						{
-							case 0:
-								if (ch->isSF2 && ch->it_inst)
-								{
-									objModel = ch->it_inst->childModel("bank");
-									printf("BANK SELECT %f %d\n", cc, static_cast<int>(cc * 127));
-									cc *= 127.0f;
-								}
-								break;
-
-							case 7:
-								objModel = ch->it->volumeModel();
-								cc *= 100.0f;
-								break;
-
-							case 10:
-								objModel = ch->it->panningModel();
-								cc = cc * 200.f - 100.0f;
-								break;
-
-							case 128:
-								objModel = ch->it->pitchModel();
-								cc = cc * 100.0f;
-								break;
-
-							default:
-								//TODO: something useful for other CCs
-								break;
-						}
-
-						if (objModel)
-						{
-							if (time == 0 && objModel)
-							{
-								objModel->setInitValue(cc);
-							}
-							else
-							{
-								if (ccs[ccid].at == nullptr) {
-									ccs[ccid].create(tc, trackName + " > " +
-										// This is inside if (objModel), so objModel should never be nullptr
-										// (objModel != nullptr ? objModel->displayName() : QString("CC %1").arg(ccid))
-										objModel->displayName()
-									);
-								}
-								ccs[ccid].putValue(time, objModel, cc);
-							}
+						objModel->setInitValue(cc);
+					}
+					else
+					{
+						if (ccs[ccid].at == nullptr) {
+							ccs[ccid].create(tc, trackName + " > " +
+								// This is inside if (objModel), so objModel should never be nullptr
+								// (objModel != nullptr ? objModel->displayName() : QString("CC %1").arg(ccid))
+								objModel->displayName()
+							);
 						}
+						ccs[ccid].putValue(evt.time, objModel, cc);
 					}
 				}
-				else {
-					printf("Unhandled update: %ld %d %f %s\n",
-						evt->chan, evt->get_type_code(), evt->time, evt->get_attribute());
-				}
 			}
 		}
+
+		// Keep the notes of earlier tracks first among equal ones, like adding them one by one would
+		for (const auto& [chan, trackNotes] : track.notes)
+		{
+			auto& channelNotes = notes[chan];
+			const auto oldSize = channelNotes.size();
+			channelNotes.insert(channelNotes.end(), trackNotes.begin(), trackNotes.end());
+			std::inplace_merge(channelNotes.begin(), channelNotes.begin() + oldSize, channelNotes.end(), notesBefore);
+		}
 	}
 
 	delete seq;
 
-	for (auto& c: chs)
 	{
-		if (c.second.hasNotes)
+		// Let the audio engine see all the imported notes at once
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		for (auto& [chan, channelNotes] : notes)
 		{
-			c.second.splitMidiClips();
+			chs[chan].addNotes(channelNotes);
 		}
-		else if (c.second.it)
+	}
+
+	for (auto& c: chs)
+	{
+		if (!c.second.hasNotes && c.second.it)
 		{
 			printf(" Should remove empty track\n");
 			// must delete trackView first - but where is it?
@@ -24,6 +24,10 @@
  */
 
 #include "MultitapEcho.h"
+
+#include <algorithm>
+#include <cmath>
+
 #include "embed.h"
 #include "LmmsTypes.h"
 #include "lmms_math.h"
@@ -58,12 +62,19 @@ MultitapEchoEffect::MultitapEchoEffect( Model* parent, const Descriptor::SubPlug
 	m_controls( this ),
 	m_buffer( 16100.0f ),
 	m_sampleRate( Engine::audioEngine()->outputSampleRate() ),
-	m_sampleRatio( 1.0f / m_sampleRate )
+	m_sampleRatio( 1.0f / m_sampleRate ),
+	m_convolverLength( 0 ),
+	m_useConvolver( false ),
+	m_convolverDrainBlocks( 0 ),
+	m_preparedIndex( 0 ),
+	m_guiResponse( 1 ),
+	m_audioResponse( 2 )
 {
 	m_work = new SampleFrame[Engine::audioEngine()->framesPerPeriod()];
 	m_buffer.reset();
 	m_stages = static_cast<int>( m_controls.m_stages.value() );
 	updateFilters( 0, 19 );
+	updateImpulseResponse();
 }
 
 
@@ -95,6 +106,147 @@ void MultitapEchoEffect::runFilter( SampleFrame* dst, SampleFrame* src, StereoOn
 }
 
 
+namespace
+{
+
+// taps are cut off once they fall below this
+constexpr float ResponseThreshold = 1e-5f;
+
+// the convolver has to be this much cheaper to be used, so that automating the controls does not switch back and forth
+constexpr float ConvolverHysteresis = 0.8f;
+
+//! Number of frames until the response of a one-pole lowpass starting at @p peak falls below the threshold
+f_cnt_t tailLength( float peak, float b1 )
+{
+	return peak > ResponseThreshold && b1 > 0.0f
+		? static_cast<f_cnt_t>( std::ceil( std::log( ResponseThreshold / peak ) / std::log( b1 ) ) ) + 1
+		: 1;
+}
+
+} // namespace
+
+
+void MultitapEchoEffect::updateImpulseResponse()
+{
+	// Every lowpass stage filters the input signal of the tap, so the
+	// response of a tap is a single one-pole lowpass regardless of the stage count
+	const int steps = m_controls.m_steps.value();
+	const float stepLength = m_controls.m_stepLength.value();
+
+	// same rounding as RingBuffer::msToFrames()
+	const auto tapPosition = [this, stepLength]( int i ) {
+		return static_cast<f_cnt_t>( std::ceil( stepLength * ( i + 1 ) * m_sampleRate * 0.001f ) );
+	};
+
+	f_cnt_t length = 0;
+	for( int i = 0; i < steps; ++i )
+	{
+		const float b1 = std::exp( -2 * std::numbers::pi_v<float> * m_lpFreq[i] * m_sampleRatio );
+		length = std::max( length, tapPosition( i ) + tailLength( m_amp[i] * ( 1.0f - b1 ), b1 ) );
+	}
+
+	m_impulseResponse.assign( length, SampleFrame{} );
+	for( int i = 0; i < steps; ++i )
+	{
+		const float b1 = std::exp( -2 * std::numbers::pi_v<float> * m_lpFreq[i] * m_sampleRatio );
+		float value = m_amp[i] * ( 1.0f - b1 );
+		for( f_cnt_t f = tapPosition( i ); f < length && value > ResponseThreshold; ++f )
+		{
+			m_impulseResponse[f] += SampleFrame( value );
+			value *= b1;
+		}
+	}
+
+	// rough operation counts per period: the direct path runs two one-pole updates
+	// per stage and writes to the ring buffer for every tap and frame
+	const fpp_t blockSize = Engine::audioEngine()->framesPerPeriod();
+	const int stages = static_cast<int>( m_controls.m_stages.value() );
+	const float directCost = static_cast<float>( steps ) * blockSize * ( stages * 6 + 4 );
+	const float convolverCost = PartitionedConvolver::estimatedCost(
+		PartitionedConvolver::activePartitions( m_impulseResponse.data(), length, blockSize ), blockSize );
+
+	// without a convolver, the audio thread keeps using the filters anyway
+	if( !m_convolver && convolverCost >= directCost * ConvolverHysteresis ) { return; }
+	reserveConvolver();
+
+	auto& prepared = *m_preparedResponses[m_guiResponse];
+	prepared.response.set( m_impulseResponse.data(), length );
+	prepared.directCost = directCost;
+	prepared.convolverCost = convolverCost;
+
+	// a response the audio thread has not picked up yet is outdated and gets overwritten next time
+	m_guiResponse = m_preparedIndex.exchange( m_guiResponse | NewResponse ) & ~NewResponse;
+}
+
+
+void MultitapEchoEffect::applyImpulseResponse()
+{
+	if( !( m_preparedIndex.load() & NewResponse ) ) { return; }
+	m_audioResponse = m_preparedIndex.exchange( m_audioResponse ) & ~NewResponse;
+	auto& prepared = *m_preparedResponses[m_audioResponse];
+
+	const bool useConvolver = m_useConvolver
+		? prepared.convolverCost < prepared.directCost
+		: prepared.convolverCost < prepared.directCost * ConvolverHysteresis;
+
+	if( useConvolver )
+	{
+		if( !m_useConvolver )
+		{
+			// the ring buffer already contains the echoes of the past input
+			m_convolver->reset();
+			m_convolverDrainBlocks = 0;
+		}
+		m_convolver->swapImpulseResponse( prepared.response );
+	}
+	else if( m_useConvolver )
+	{
+		// keep convolving silence with the old response until the echoes of the past input are out
+		m_convolverDrainBlocks = m_convolver->tailBlocks();
+	}
+	m_useConvolver = useConvolver;
+}
+
+
+void MultitapEchoEffect::reserveConvolver()
+{
+	// called before each response is handed over, so the audio thread never has to grow the input history
+	const f_cnt_t maxLength = maxImpulseResponseLength();
+	if( m_convolver && maxLength <= m_convolverLength ) { return; }
+
+	const fpp_t blockSize = Engine::audioEngine()->framesPerPeriod();
+	auto convolver = std::make_unique<PartitionedConvolver>( blockSize, maxLength );
+	if( m_convolver )
+	{
+		// the audio thread may be using the old one, which is freed once the guard is released
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		std::swap( m_convolver, convolver );
+		m_useConvolver = false;
+		m_convolverDrainBlocks = 0;
+	}
+	else
+	{
+		// the audio thread does not touch any of this before the first response is handed over
+		m_convolverInput.resize( blockSize );
+		for( auto& prepared : m_preparedResponses )
+		{
+			prepared = std::make_unique<PreparedResponse>( blockSize );
+		}
+		m_convolver = std::move( convolver );
+	}
+	m_convolverLength = maxLength;
+}
+
+
+f_cnt_t MultitapEchoEffect::maxImpulseResponseLength() const
+{
+	// the longest tap has the lowest cutoff at full amplitude
+	const float b1 = std::exp( -2 * std::numbers::pi_v<float> * 20.0f * m_sampleRatio );
+	const float longest = m_controls.m_stepLength.maxValue() * m_controls.m_steps.maxValue();
+	return static_cast<f_cnt_t>( std::ceil( longest * m_sampleRate * 0.001f ) ) + tailLength( 1.0f - b1, b1 );
+}
+
+
 Effect::ProcessStatus MultitapEchoEffect::processImpl(SampleFrame* buf, const fpp_t frames)
 {
 	const float d = dryLevel();
@@ -112,41 +264,64 @@ Effect::ProcessStatus MultitapEchoEffect::processImpl(SampleFrame* buf, const fp
 		m_stages = static_cast<int>( m_controls.m_stages.value() );
 		updateFilters( 0, steps - 1 );
 	}
+
+	applyImpulseResponse();
+
+	const bool useConvolver = m_useConvolver && frames == m_convolver->blockSize();
 	
 	// add dry buffer - never swap inputs for dry
 	m_buffer.writeAddingMultiplied(buf, f_cnt_t{0}, frames, dryGain);
 
-	// swapped inputs?
-	if( swapInputs )
+	// with the convolver, the taps are added after popping the buffer
+	if( !useConvolver )
 	{
-		float offset = stepLength;
-		for( int i = 0; i < steps; ++i ) // add all steps swapped
+		// swapped inputs?
+		if( swapInputs )
 		{
-			for( int s = 0; s < m_stages; ++s )
+			float offset = stepLength;
+			for( int i = 0; i < steps; ++i ) // add all steps swapped
 			{
-				runFilter( m_work, buf, m_filter[i][s], frames );
+				for( int s = 0; s < m_stages; ++s )
+				{
+					runFilter( m_work, buf, m_filter[i][s], frames );
+				}
+				m_buffer.writeSwappedAddingMultiplied( m_work, offset, frames, m_amp[i] );
+				offset += stepLength;
 			}
-			m_buffer.writeSwappedAddingMultiplied( m_work, offset, frames, m_amp[i] );
-			offset += stepLength;
 		}
-	}
-	else
-	{
-		float offset = stepLength;
-		for( int i = 0; i < steps; ++i ) // add all steps
+		else
 		{
-			for( int s = 0; s < m_stages; ++s )
+			float offset = stepLength;
+			for( int i = 0; i < steps; ++i ) // add all steps
 			{
-				runFilter( m_work, buf, m_filter[i][s], frames );
+				for( int s = 0; s < m_stages; ++s )
+				{
+					runFilter( m_work, buf, m_filter[i][s], frames );
+				}
+				m_buffer.writeAddingMultiplied( m_work, offset, frames, m_amp[i] );
+				offset += stepLength;
 			}
-			m_buffer.writeAddingMultiplied( m_work, offset, frames, m_amp[i] );
-			offset += stepLength;
 		}
 	}
 	
 	// pop the buffer and mix it into output
 	m_buffer.pop( m_work );
 
+	if( useConvolver )
+	{
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			m_convolverInput[f] = swapInputs ? SampleFrame( buf[f][1], buf[f][0] ) : buf[f];
+		}
+		m_convolver->process( m_convolverInput.data(), m_work );
+	}
+	else if( m_convolverDrainBlocks > 0 && frames == m_convolver->blockSize() )
+	{
+		std::fill( m_convolverInput.begin(), m_convolverInput.end(), SampleFrame{} );
+		m_convolver->process( m_convolverInput.data(), m_work );
+		--m_convolverDrainBlocks;
+	}
+
 	for (auto f = std::size_t{0}; f < frames; ++f)
 	{
 		buf[f][0] = d * buf[f][0] + w * m_work[f][0];
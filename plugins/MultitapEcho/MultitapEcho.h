@@ -26,8 +26,14 @@
 #ifndef MULTITAP_ECHO_H
 #define MULTITAP_ECHO_H
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "Effect.h"
 #include "MultitapEchoControls.h"
+#include "PartitionedConvolver.h"
 #include "RingBuffer.h"
 #include "BasicFilters.h"
 
@@ -49,8 +55,25 @@ public:
 	}
 
 private:
+	//! An impulse response prepared on the GUI thread, with what it costs compared to the filters
+	struct PreparedResponse
+	{
+		explicit PreparedResponse( fpp_t blockSize ) : response( blockSize ) {}
+
+		PartitionedConvolver::ImpulseResponse response;
+		float directCost = 0.0f;
+		float convolverCost = 0.0f;
+	};
+
 	void updateFilters( int begin, int end );
 	void runFilter( SampleFrame* dst, SampleFrame* src, StereoOnePole & filter, const fpp_t frames );
+	//! Computes the impulse response of the current taps and hands it to the audio thread. Not realtime safe.
+	void updateImpulseResponse();
+	//! Takes over the response prepared by updateImpulseResponse(), if there is a new one
+	void applyImpulseResponse();
+	//! Creates the convolver, or a longer one once the sample rate went up. Not realtime safe.
+	void reserveConvolver();
+	f_cnt_t maxImpulseResponseLength() const;
 
 	inline void setFilterFreq( float fc, StereoOnePole & f )
 	{
@@ -73,6 +96,28 @@ private:
 	
 	SampleFrame* m_work;
 
+	// With many taps, convolving with the impulse response of all taps is
+	// cheaper than running the filters of each tap. The ring buffer is still
+	// used for the dry signal and the echoes written before switching over.
+	// The convolver is only created once it pays off, as its input history
+	// is sized for the longest possible response.
+	std::unique_ptr<PartitionedConvolver> m_convolver;
+	f_cnt_t m_convolverLength;
+	std::vector<SampleFrame> m_convolverInput;
+	bool m_useConvolver;
+	std::size_t m_convolverDrainBlocks;
+
+	// The response is computed on the GUI thread and passed to the audio thread
+	// through a triple buffer, so the audio thread neither allocates nor locks.
+	// m_preparedIndex holds the index of the latest response and NewResponse
+	// until the audio thread exchanges it for the one it used before.
+	static constexpr int NewResponse = 4;
+	std::array<std::unique_ptr<PreparedResponse>, 3> m_preparedResponses;
+	std::atomic<int> m_preparedIndex;
+	int m_guiResponse;
+	int m_audioResponse;
+	std::vector<SampleFrame> m_impulseResponse;
+
 	friend class MultitapEchoControls;
 
 };
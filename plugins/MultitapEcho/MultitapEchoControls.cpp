@@ -24,6 +24,7 @@
  */
 
 #include <QDomElement>
+#include <QTimer>
 #include <QVarLengthArray>
 
 #include "MultitapEchoControls.h"
@@ -44,13 +45,17 @@ MultitapEchoControls::MultitapEchoControls( MultitapEchoEffect * eff ) :
 	m_swapInputs( false, this, "Swap inputs" ),
 	m_stages( 1.0f, 1.0f, 4.0f, 1.0f, this, "Lowpass stages" ),
 	m_ampGraph( -60.0f, 0.0f, 16, this ),
-	m_lpGraph( 0.0f, 3.0f, 16, this )
+	m_lpGraph( 0.0f, 3.0f, 16, this ),
+	m_impulseResponseRequested( false )
 {
 	m_stages.setStrictStepSize( true );
 	connect( &m_ampGraph, SIGNAL( samplesChanged( int, int ) ), this, SLOT( ampSamplesChanged( int, int ) ) );
 	connect( &m_lpGraph, SIGNAL( samplesChanged( int, int ) ), this, SLOT( lpSamplesChanged( int, int ) ) );
 
 	connect( &m_steps, SIGNAL( dataChanged() ), this, SLOT( lengthChanged() ) );
+	// automation changes these on the audio thread, the connections queue the rebuild to this thread then
+	connect( &m_stepLength, SIGNAL( dataChanged() ), this, SLOT( requestImpulseResponse() ) );
+	connect( &m_stages, SIGNAL( dataChanged() ), this, SLOT( requestImpulseResponse() ) );
 	connect( Engine::audioEngine(), SIGNAL( sampleRateChanged() ), this, SLOT( sampleRateChanged() ) );
 
 	setDefaultAmpShape();
@@ -132,6 +137,7 @@ void MultitapEchoControls::ampSamplesChanged( int begin, int end )
 	{
 		m_effect->m_amp[i] = dbfsToAmp( samples[i] );
 	}
+	requestImpulseResponse();
 }
 
 
@@ -150,6 +156,7 @@ void MultitapEchoControls::lpSamplesChanged( int begin, int end )
 		m_effect->m_lpFreq[i] = 20.0f * fastPow10f(samples[i]);
 	}
 	m_effect->updateFilters( begin, end );
+	requestImpulseResponse();
 }
 
 
@@ -175,6 +182,19 @@ void MultitapEchoControls::sampleRateChanged()
 	m_effect->m_sampleRate = Engine::audioEngine()->outputSampleRate();
 	m_effect->m_sampleRatio = 1.0f / m_effect->m_sampleRate;
 	m_effect->updateFilters( 0, 19 );
+	requestImpulseResponse();
+}
+
+
+void MultitapEchoControls::requestImpulseResponse()
+{
+	// the graphs and knobs usually change several taps at once, build the response once for all of them
+	if( m_impulseResponseRequested ) { return; }
+	m_impulseResponseRequested = true;
+	QTimer::singleShot( 0, this, [this] {
+		m_impulseResponseRequested = false;
+		m_effect->updateImpulseResponse();
+	} );
 }
 
 
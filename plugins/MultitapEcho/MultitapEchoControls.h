@@ -73,6 +73,9 @@ private slots:
 	void lengthChanged();
 	void sampleRateChanged();
 
+	//! Rebuilds the impulse response once control returns to the event loop
+	void requestImpulseResponse();
+
 private:
 	MultitapEchoEffect * m_effect;
 	IntModel m_steps;
@@ -85,6 +88,8 @@ private:
 	graphModel m_ampGraph;
 	graphModel m_lpGraph;
 
+	bool m_impulseResponseRequested;
+
 	friend class MultitapEchoEffect;
 	friend class gui::MultitapEchoControlDialog;
 };
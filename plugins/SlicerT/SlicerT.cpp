@@ -25,14 +25,19 @@
 #include "SlicerT.h"
 
 #include <QDomElement>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <fftw3.h>
 
+#include "AudioEngine.h"
 #include "Engine.h"
 #include "InstrumentTrack.h"
 #include "PathUtil.h"
+#include "ProjectContainer.h"
 #include "SlicerTView.h"
 #include "Song.h"
+#include "ThreadPool.h"
 #include "embed.h"
 #include "interpolation.h"
 #include "plugin_export.h"
@@ -53,6 +58,144 @@ Plugin::Descriptor PLUGIN_EXPORT slicert_plugin_descriptor = {
 };
 } // end extern
 
+namespace {
+
+constexpr int WindowSize = 512;
+//! Long samples are analyzed in chunks of at least this many windows in parallel
+constexpr std::size_t MinWindowsPerChunk = 256;
+
+//! The plan is created once with FFTW_MEASURE and executed on the arrays of each chunk
+class FluxPlan
+{
+public:
+	FluxPlan()
+		: m_in(fftwf_alloc_real(WindowSize))
+		, m_out(fftwf_alloc_complex(WindowSize / 2 + 1))
+		, m_plan(fftwf_plan_dft_r2c_1d(WindowSize, m_in, m_out, FFTW_MEASURE))
+	{
+	}
+
+	~FluxPlan()
+	{
+		fftwf_destroy_plan(m_plan);
+		fftwf_free(m_in);
+		fftwf_free(m_out);
+	}
+
+	FluxPlan(const FluxPlan&) = delete;
+	FluxPlan& operator=(const FluxPlan&) = delete;
+
+	//! Thread safe, as long as the arrays are allocated with fftwf_malloc
+	void execute(float* in, fftwf_complex* out) const { fftwf_execute_dft_r2c(m_plan, in, out); }
+
+	//! Must be called on the GUI thread first, since creating FFTW plans is not thread safe
+	static const FluxPlan& instance()
+	{
+		static const auto s_plan = FluxPlan{};
+		return s_plan;
+	}
+
+private:
+	float* m_in;
+	fftwf_complex* m_out;
+	fftwf_plan m_plan;
+};
+
+float monoSample(const SampleFrame& frame)
+{
+	return (frame[0] + frame[1]) / 2;
+}
+
+//! The results for a range of windows, computed without knowing the peak of the whole sample
+struct AnalysisChunk
+{
+	std::vector<float> flux;
+	std::vector<f_cnt_t> zeroCrossings;
+	float maxMag = -1;
+};
+
+// uses the spectral flux to determine the change in magnitude
+// resources:
+// http://www.iro.umontreal.ca/~pift6080/H09/documents/papers/bello_onset_tutorial.pdf
+void analyzeChunk(const SampleBuffer& buffer, std::size_t firstWindow, std::size_t endWindow, bool lastChunk,
+	const std::atomic<bool>& cancelled, AnalysisChunk& chunk)
+{
+	const SampleFrame* data = buffer.data();
+	const auto start = firstWindow * WindowSize;
+	const auto end = lastChunk ? buffer.size() : endWindow * WindowSize;
+
+	// zero crossings and peak of this chunk, the flux is normalized when all chunks are done
+	bool lastPositive = start == 0 || monoSample(data[start - 1]) >= 0;
+	for (auto i = start; i < end; ++i)
+	{
+		const float value = monoSample(data[i]);
+		chunk.maxMag = std::max(chunk.maxMag, value);
+		if ((value >= 0) != lastPositive)
+		{
+			chunk.zeroCrossings.push_back(i);
+			lastPositive = value >= 0;
+		}
+	}
+
+	const auto& plan = FluxPlan::instance();
+	const auto in = std::unique_ptr<float, decltype(&fftwf_free)>{fftwf_alloc_real(WindowSize), &fftwf_free};
+	const auto out = std::unique_ptr<fftwf_complex, decltype(&fftwf_free)>{
+		fftwf_alloc_complex(WindowSize / 2 + 1), &fftwf_free};
+	auto prevMags = std::vector<float>(WindowSize / 2, 0);
+
+	const auto transform = [&](std::size_t window) {
+		for (int j = 0; j < WindowSize; ++j)
+		{
+			in.get()[j] = monoSample(data[window * WindowSize + j]);
+		}
+		plan.execute(in.get(), out.get());
+	};
+
+	// the flux of the first window is relative to the window before it
+	if (firstWindow > 0)
+	{
+		transform(firstWindow - 1);
+		for (int j = 0; j < WindowSize / 2; ++j)
+		{
+			const float real = out.get()[j][0];
+			const float imag = out.get()[j][1];
+			prevMags[j] = std::sqrt(real * real + imag * imag);
+		}
+	}
+
+	chunk.flux.reserve(endWindow - firstWindow);
+	for (auto window = firstWindow; window < endWindow && !cancelled.load(std::memory_order_relaxed); ++window)
+	{
+		transform(window);
+
+		// calculate spectral flux in regard to last window
+		float spectralFlux = 0;
+		for (int j = 0; j < WindowSize / 2; j++) // only use niquistic frequencies
+		{
+			const float real = out.get()[j][0];
+			const float imag = out.get()[j][1];
+			const float magnitude = std::sqrt(real * real + imag * imag);
+
+			// using L2-norm (euclidean distance)
+			spectralFlux += std::abs(magnitude - prevMags[j]);
+			prevMags[j] = magnitude;
+		}
+		chunk.flux.push_back(spectralFlux);
+	}
+}
+
+} // namespace
+
+struct SlicerT::AnalysisJob
+{
+	std::shared_ptr<const SampleBuffer> buffer;
+	std::vector<AnalysisChunk> chunks;
+	std::atomic<std::size_t> remaining = 0;
+	std::atomic<bool> cancelled = false;
+	//! The slices are only picked if they weren't edited since, only used on the GUI thread
+	unsigned int sliceEdits = 0;
+};
+
 // ################################# SlicerT ####################################
 
 SlicerT::SlicerT(InstrumentTrack* instrumentTrack)
@@ -75,6 +218,11 @@ SlicerT::SlicerT(InstrumentTrack* instrumentTrack)
 	m_sliceSnap.setValue(0);
 }
 
+SlicerT::~SlicerT()
+{
+	cancelAnalysis();
+}
+
 void SlicerT::playNote(NotePlayHandle* handle, SampleFrame* workingBuffer)
 {
 	if (m_originalSample.sampleSize() <= 1) { return; }
@@ -141,111 +289,172 @@ void SlicerT::deleteNotePluginData(NotePlayHandle* handle)
 	emit isPlaying(-1, 0, 0);
 }
 
-// uses the spectral flux to determine the change in magnitude
-// resources:
-// http://www.iro.umontreal.ca/~pift6080/H09/documents/papers/bello_onset_tutorial.pdf
 void SlicerT::findSlices()
 {
 	if (m_originalSample.sampleSize() <= 1) { return; }
-	m_slicePoints = {};
 
-	const int windowSize = 512;
-	const float minBeatLength = 0.05f; // in seconds, ~ 1/4 length at 220 bpm
+	if (m_analysis && m_analysis->buffer == m_originalSample.buffer())
+	{
+		pickSlices();
+	}
+	// a running analysis of this sample picks the slices when it's done
+	else if (m_analysisJob && m_analysisJob->buffer == m_originalSample.buffer())
+	{
+		m_analysisJob->sliceEdits = m_sliceEdits;
+	}
+	else
+	{
+		startAnalysis();
+	}
+}
+
+void SlicerT::startAnalysis()
+{
+	cancelAnalysis();
+
+	auto job = std::make_shared<AnalysisJob>();
+	job->buffer = m_originalSample.buffer();
+	job->sliceEdits = m_sliceEdits;
+
+	const auto frames = job->buffer->size();
+	const auto windows = frames > WindowSize ? (frames - WindowSize + WindowSize - 1) / WindowSize : 0;
+	const auto chunks = std::clamp<std::size_t>(windows / MinWindowsPerChunk, 1, ThreadPool::instance().numWorkers());
+	job->chunks.resize(chunks);
+	job->remaining = chunks;
+
+	// create the plan here, as FFTW's planner must not run on several threads at once
+	FluxPlan::instance();
+
+	for (std::size_t c = 0; c < chunks; ++c)
+	{
+		const auto firstWindow = windows * c / chunks;
+		const auto endWindow = windows * (c + 1) / chunks;
+		m_analysisTasks.push_back(ThreadPool::instance().enqueue([this, job, c, firstWindow, endWindow, chunks] {
+			analyzeChunk(*job->buffer, firstWindow, endWindow, c == chunks - 1, job->cancelled, job->chunks[c]);
+			if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && !job->cancelled)
+			{
+				// cancelAnalysis() waits for this task, so the instrument is still alive here
+				QMetaObject::invokeMethod(this, [this, job] { finishAnalysis(job); }, Qt::QueuedConnection);
+			}
+		}));
+	}
+
+	m_analysisJob = std::move(job);
+}
 
-	int sampleRate = m_originalSample.sampleRate();
-	int minDist = sampleRate * minBeatLength;
+void SlicerT::cancelAnalysis()
+{
+	if (m_analysisJob) { m_analysisJob->cancelled = true; }
+	for (auto& task : m_analysisTasks)
+	{
+		task.wait();
+	}
+	m_analysisTasks.clear();
+	m_analysisJob.reset();
+}
+
+void SlicerT::finishAnalysis(const std::shared_ptr<AnalysisJob>& job)
+{
+	// a newer analysis was started in the meantime
+	if (job != m_analysisJob) { return; }
+
+	auto analysis = std::make_shared<Analysis>();
+	analysis->buffer = job->buffer;
 
 	float maxMag = -1;
-	std::vector<float> singleChannel(m_originalSample.sampleSize(), 0);
-	for (auto i = std::size_t{0}; i < m_originalSample.sampleSize(); i++)
+	for (const auto& chunk : job->chunks)
 	{
-		singleChannel[i] = (m_originalSample.data()[i][0] + m_originalSample.data()[i][1]) / 2;
-		maxMag = std::max(maxMag, singleChannel[i]);
+		maxMag = std::max(maxMag, chunk.maxMag);
 	}
 
-	// normalize and find 0 crossings
-	std::vector<int> zeroCrossings;
-	float lastValue = 1;
-	for (auto i = std::size_t{0}; i < singleChannel.size(); i++)
+	// the magnitudes scale with the sample, so this is the same as normalizing it first
+	const float scale = maxMag != 0 ? 1 / std::abs(maxMag) : 1;
+	for (const auto& chunk : job->chunks)
 	{
-		singleChannel[i] /= maxMag;
-		if ((lastValue >= 0) != (singleChannel[i] >= 0))
+		for (const float flux : chunk.flux)
 		{
-			zeroCrossings.push_back(i);
-			lastValue = singleChannel[i];
+			// small value, no divison by zero
+			const float offset = analysis->flux.empty() ? 0 : 1E-10f;
+			analysis->flux.push_back(flux * scale + offset);
 		}
+		analysis->zeroCrossings.insert(
+			analysis->zeroCrossings.end(), chunk.zeroCrossings.begin(), chunk.zeroCrossings.end());
 	}
 
-	std::vector<float> prevMags(windowSize / 2, 0);
-	std::vector<float> fftIn(windowSize, 0);
-	std::array<fftwf_complex, windowSize> fftOut;
+	m_analysisTasks.clear();
+	m_analysisJob.reset();
+	m_analysis = std::move(analysis);
 
-	fftwf_plan fftPlan = fftwf_plan_dft_r2c_1d(windowSize, fftIn.data(), fftOut.data(), FFTW_MEASURE);
+	// keep slices that were edited by hand or loaded in the meantime
+	if (m_analysis->buffer == m_originalSample.buffer() && job->sliceEdits == m_sliceEdits) { pickSlices(); }
+}
+
+void SlicerT::pickSlices()
+{
+	const float minBeatLength = 0.05f; // in seconds, ~ 1/4 length at 220 bpm
 
+	const auto& buffer = *m_analysis->buffer;
+	int minDist = buffer.sampleRate() * minBeatLength;
+
+	std::vector<float> slicePoints;
 	int lastPoint = -minDist - 1; // to always store 0 first
-	float spectralFlux = 0;
 	float prevFlux = 1E-10f; // small value, no divison by zero
 
-	for (int i = 0; i < static_cast<int>(singleChannel.size()) - windowSize; i += windowSize)
+	for (auto window = std::size_t{0}; window < m_analysis->flux.size(); window++)
 	{
-		// fft
-		std::copy_n(singleChannel.data() + i, windowSize, fftIn.data());
-		fftwf_execute(fftPlan);
-
-		// calculate spectral flux in regard to last window
-		for (int j = 0; j < windowSize / 2; j++) // only use niquistic frequencies
-		{
-			float real = fftOut[j][0];
-			float imag = fftOut[j][1];
-			float magnitude = std::sqrt(real * real + imag * imag);
-
-			// using L2-norm (euclidean distance)
-			float diff = std::abs(magnitude - prevMags[j]);
-			spectralFlux += diff;
-
-			prevMags[j] = magnitude;
-		}
-
+		const float spectralFlux = m_analysis->flux[window];
+		const int i = window * WindowSize;
 		if (spectralFlux / prevFlux > 1.0f + m_noteThreshold.value() && i - lastPoint > minDist)
 		{
-			m_slicePoints.push_back(i);
+			slicePoints.push_back(i);
 			lastPoint = i;
-			if (m_slicePoints.size() > 128) { break; } // no more keys on the keyboard
+			if (slicePoints.size() > 128) { break; } // no more keys on the keyboard
 		}
 
 		prevFlux = spectralFlux;
-		spectralFlux = 1E-10f; // again for no divison by zero
 	}
 
-	m_slicePoints.push_back(m_originalSample.sampleSize());
+	slicePoints.push_back(buffer.size());
 
-	for (float& sliceValue : m_slicePoints)
+	const auto& zeroCrossings = m_analysis->zeroCrossings;
+	for (float& sliceValue : slicePoints)
 	{
 		auto closestZeroCrossing = std::lower_bound(zeroCrossings.begin(), zeroCrossings.end(), sliceValue);
 		if (closestZeroCrossing == zeroCrossings.end()) { continue; }
-		if (std::abs(sliceValue - *closestZeroCrossing) < windowSize) { sliceValue = *closestZeroCrossing; }
+		if (std::abs(sliceValue - *closestZeroCrossing) < WindowSize) { sliceValue = *closestZeroCrossing; }
 	}
 
 	float beatsPerMin = m_originalBPM.value() / 60.0f;
-	float samplesPerBeat = m_originalSample.sampleRate() / beatsPerMin * 4.0f;
+	float samplesPerBeat = buffer.sampleRate() / beatsPerMin * 4.0f;
 	int noteSnap = m_sliceSnap.value();
 	int sliceLock = samplesPerBeat / std::exp2(noteSnap + 1);
 	if (noteSnap == 0) { sliceLock = 1; }
-	for (float& sliceValue : m_slicePoints)
+	for (float& sliceValue : slicePoints)
 	{
 		sliceValue += sliceLock / 2.f;
 		sliceValue -= static_cast<int>(sliceValue) % sliceLock;
 	}
 
-	m_slicePoints.erase(std::unique(m_slicePoints.begin(), m_slicePoints.end()), m_slicePoints.end());
+	slicePoints.erase(std::unique(slicePoints.begin(), slicePoints.end()), slicePoints.end());
 
-	for (float& sliceIndex : m_slicePoints)
+	for (float& sliceIndex : slicePoints)
 	{
-		sliceIndex /= m_originalSample.sampleSize();
+		sliceIndex /= buffer.size();
 	}
 
-	m_slicePoints[0] = 0;
-	m_slicePoints[m_slicePoints.size() - 1] = 1;
+	slicePoints[0] = 0;
+	slicePoints[slicePoints.size() - 1] = 1;
+
+	setSlicePoints(std::move(slicePoints));
+}
+
+void SlicerT::setSlicePoints(std::vector<float> slicePoints)
+{
+	{
+		// playNote() reads the slices on the audio thread
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		m_slicePoints = std::move(slicePoints);
+	}
 
 	emit dataChanged();
 }
@@ -308,6 +517,8 @@ void SlicerT::updateFile(QString file)
 {
 	if (auto buffer = SampleBuffer::fromFile(file)) { m_originalSample = Sample(std::move(buffer)); }
 
+	// play the whole sample until the new slices are found
+	setSlicePoints({0, 1});
 	findBPM();
 	findSlices();
 
@@ -330,7 +541,7 @@ void SlicerT::saveSettings(QDomDocument& document, QDomElement& element)
 	element.setAttribute("src", m_originalSample.sampleFile());
 	if (m_originalSample.sampleFile().isEmpty())
 	{
-		element.setAttribute("sampledata", m_originalSample.toBase64());
+		element.setAttribute("sampledata", ProjectContainer::saveSample(m_originalSample.buffer()));
 	}
 
 	element.setAttribute("totalSlices", static_cast<int>(m_slicePoints.size()));
@@ -362,7 +573,7 @@ void SlicerT::loadSettings(const QDomElement& element)
 	}
 	else if (auto sampleData = element.attribute("sampledata"); !sampleData.isEmpty())
 	{
-		auto buffer = SampleBuffer::fromBase64(sampleData);
+		auto buffer = ProjectContainer::loadSample(sampleData);
 		m_originalSample = Sample(std::move(buffer));
 	}
 
@@ -374,6 +585,7 @@ void SlicerT::loadSettings(const QDomElement& element)
 		{
 			m_slicePoints.push_back(element.attribute(tr("slice_%1").arg(i)).toFloat());
 		}
+		slicesEdited();
 	}
 
 	m_fadeOutFrames.loadSettings(element, "fadeOut");
@@ -25,6 +25,9 @@
 #ifndef LMMS_SLICERT_H
 #define LMMS_SLICERT_H
 
+#include <future>
+#include <memory>
+
 #include "AutomatableModel.h"
 #include "ComboBoxModel.h"
 #include "Instrument.h"
@@ -47,6 +50,7 @@ signals:
 
 public:
 	SlicerT(InstrumentTrack* instrumentTrack);
+	~SlicerT() override;
 
 	void playNote(NotePlayHandle* handle, SampleFrame* workingBuffer) override;
 	void deleteNotePluginData(NotePlayHandle* handle) override;
@@ -55,6 +59,7 @@ public:
 	void loadSettings(const QDomElement& element) override;
 
 	void loadFile(const QString& file) override;
+	//! Slices the sample, analyzing it on the thread pool first if that wasn't done yet
 	void findSlices();
 	void findBPM();
 
@@ -66,6 +71,26 @@ public:
 	std::vector<Note> getMidi();
 
 private:
+	//! What the slicing needs to know about a sample, independent of the slicing parameters
+	struct Analysis
+	{
+		std::shared_ptr<const SampleBuffer> buffer;
+		//! Normalized spectral flux of each analysis window
+		std::vector<float> flux;
+		std::vector<f_cnt_t> zeroCrossings;
+	};
+
+	struct AnalysisJob;
+
+	void startAnalysis();
+	void cancelAnalysis();
+	void finishAnalysis(const std::shared_ptr<AnalysisJob>& job);
+	//! Picks the slices from the analysis, which is cheap enough for the GUI thread
+	void pickSlices();
+	void setSlicePoints(std::vector<float> slicePoints);
+	//! Called after the slices were edited by hand, so a running analysis doesn't replace them
+	void slicesEdited() { ++m_sliceEdits; }
+
 	FloatModel m_noteThreshold;
 	FloatModel m_fadeOutFrames;
 	IntModel m_originalBPM;
@@ -75,6 +100,11 @@ private:
 	Sample m_originalSample;
 
 	std::vector<float> m_slicePoints;
+	unsigned int m_sliceEdits = 0;
+
+	std::shared_ptr<const Analysis> m_analysis;
+	std::shared_ptr<AnalysisJob> m_analysisJob;
+	std::vector<std::future<void>> m_analysisTasks;
 
 	InstrumentTrack* m_parentTrack;
 
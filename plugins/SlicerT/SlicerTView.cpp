@@ -129,6 +129,7 @@ void SlicerTView::clearSlices()
 	// so the whole sample can still be copied using MIDI.
 	m_slicerTParent->m_slicePoints.emplace_back(0);
 	m_slicerTParent->m_slicePoints.emplace_back(1);
+	m_slicerTParent->slicesEdited();
 
 	emit m_slicerTParent->dataChanged();
 }
@@ -380,6 +380,7 @@ void SlicerTWaveform::mousePressEvent(QMouseEvent* me)
 		if (m_slicerTParent->m_slicePoints.size() > 2 && m_closestObject == UIObjects::SlicePoint)
 		{
 			m_slicerTParent->m_slicePoints.erase(m_slicerTParent->m_slicePoints.begin() + m_closestSlice);
+			m_slicerTParent->slicesEdited();
 		}
 		break;
 	default:;
@@ -444,6 +445,7 @@ void SlicerTWaveform::mouseMoveEvent(QMouseEvent* me)
 			= startFrame + normalizedClickEditor * (endFrame - startFrame);
 		m_slicerTParent->m_slicePoints.at(m_closestSlice)
 			= std::clamp(m_slicerTParent->m_slicePoints.at(m_closestSlice), 0.0f, 1.0f);
+		m_slicerTParent->slicesEdited();
 		break;
 	case UIObjects::Nothing:
 		break;
@@ -467,6 +469,7 @@ void SlicerTWaveform::mouseDoubleClickEvent(QMouseEvent* me)
 
 	m_slicerTParent->m_slicePoints.insert(m_slicerTParent->m_slicePoints.begin(), slicePosition);
 	std::sort(m_slicerTParent->m_slicePoints.begin(), m_slicerTParent->m_slicePoints.end());
+	m_slicerTParent->slicesEdited();
 }
 
 void SlicerTWaveform::wheelEvent(QWheelEvent* we)
@@ -86,13 +86,18 @@ Effect::ProcessStatus WaveShaperEffect::processImpl(SampleFrame* buf, const fpp_
 	const float *inputPtr = inputBuffer ? &( inputBuffer->values()[ 0 ] ) : &input;
 	const float *outputPtr = outputBufer ? &( outputBufer->values()[ 0 ] ) : &output;
 
+	// value buffers hold one value per frame at the engine's rate
+	const int factor = oversamplingFactor();
+
 	for (fpp_t f = 0; f < frames; ++f)
 	{
 		auto s = std::array{buf[f][0], buf[f][1]};
+		const float inputGain = inputPtr[f / factor * inputInc];
+		const float outputGain = outputPtr[f / factor * outputInc];
 
 // apply input gain
-		s[0] *= *inputPtr;
-		s[1] *= *inputPtr;
+		s[0] *= inputGain;
+		s[1] *= inputGain;
 
 // clip if clip enabled
 		if( clip )
@@ -124,15 +129,12 @@ Effect::ProcessStatus WaveShaperEffect::processImpl(SampleFrame* buf, const fpp_
 		}
 
 // apply output gain
-		s[0] *= *outputPtr;
-		s[1] *= *outputPtr;
+		s[0] *= outputGain;
+		s[1] *= outputGain;
 
 // mix wet/dry signals
 		buf[f][0] = d * buf[f][0] + w * s[0];
 		buf[f][1] = d * buf[f][1] + w * s[1];
-
-		outputPtr += outputInc;
-		inputPtr += inputInc;
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
@@ -48,6 +48,11 @@ public:
 		return( &m_wsControls );
 	}
 
+	bool supportsOversampling() const override
+	{
+		return true;
+	}
+
 
 private:
 
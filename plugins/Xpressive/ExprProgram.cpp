@@ -0,0 +1,686 @@
+/*
+ * ExprProgram.cpp - block evaluation of Xpressive expressions
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ExprProgram.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace lmms
+{
+
+
+namespace
+{
+
+struct Unsupported {};
+
+struct Token
+{
+	enum class Type { Number, Symbol, Operator, LeftParen, RightParen, Comma, End };
+	Type type;
+	std::string text;
+};
+
+bool isDigit(char c) { return std::isdigit(static_cast<unsigned char>(c)); }
+bool isLetter(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+
+std::vector<Token> tokenize(const std::string& s)
+{
+	using Type = Token::Type;
+	auto tokens = std::vector<Token>{};
+	std::size_t i = 0;
+	while (i < s.size())
+	{
+		const char c = s[i];
+		if (std::isspace(static_cast<unsigned char>(c)))
+		{
+			++i;
+			continue;
+		}
+
+		auto token = Token{};
+		const std::size_t start = i;
+		if (isDigit(c) || (c == '.' && i + 1 < s.size() && isDigit(s[i + 1])))
+		{
+			while (i < s.size() && isDigit(s[i])) { ++i; }
+			if (i < s.size() && s[i] == '.')
+			{
+				++i;
+				while (i < s.size() && isDigit(s[i])) { ++i; }
+			}
+			if (i < s.size() && (s[i] == 'e' || s[i] == 'E'))
+			{
+				++i;
+				if (i < s.size() && (s[i] == '+' || s[i] == '-')) { ++i; }
+				if (i >= s.size() || !isDigit(s[i])) { throw Unsupported{}; }
+				while (i < s.size() && isDigit(s[i])) { ++i; }
+			}
+			token = {Type::Number, s.substr(start, i - start)};
+		}
+		else if (isLetter(c))
+		{
+			while (i < s.size() && (isLetter(s[i]) || isDigit(s[i]))) { ++i; }
+			if (i < s.size() && s[i] == '.') { throw Unsupported{}; }
+			token = {Type::Symbol, s.substr(start, i - start)};
+			std::transform(token.text.begin(), token.text.end(), token.text.begin(),
+				[](char ch) { return static_cast<char>(std::tolower(static_cast<unsigned char>(ch))); });
+		}
+		else if (c == '(') { token = {Type::LeftParen, "("}; ++i; }
+		else if (c == ')') { token = {Type::RightParen, ")"}; ++i; }
+		else if (c == ',') { token = {Type::Comma, ","}; ++i; }
+		else if (c == '<' || c == '>')
+		{
+			++i;
+			if (i < s.size() && s[i] == '=') { ++i; }
+			token = {Type::Operator, s.substr(start, i - start)};
+		}
+		else if (std::strchr("+-*/%^", c))
+		{
+			token = {Type::Operator, std::string(1, c)};
+			++i;
+		}
+		else
+		{
+			throw Unsupported{};
+		}
+
+		// exprtk inserts a multiplication after a number that is followed by a
+		// symbol or parenthesis, and after a closing parenthesis followed by a number or symbol
+		if (!tokens.empty())
+		{
+			const auto prev = tokens.back().type;
+			if ((prev == Type::Number && (token.type == Type::Symbol || token.type == Type::LeftParen))
+				|| (prev == Type::RightParen && (token.type == Type::Number || token.type == Type::Symbol)))
+			{
+				tokens.push_back({Type::Operator, "*"});
+			}
+		}
+		tokens.push_back(std::move(token));
+	}
+	tokens.push_back({Token::Type::End, ""});
+	return tokens;
+}
+
+//! Same multiplication order as exprtk's fast_exp, which it uses for constant integer exponents
+float fastExp(float v, unsigned int n)
+{
+	switch (n)
+	{
+		case 0: return 1.0f;
+		case 1: return v;
+		case 2: return v * v;
+		case 3: return v * v * v;
+		case 4: { const float v2 = v * v; return v2 * v2; }
+		case 5: return fastExp(v, 4) * v;
+		case 6: { const float v3 = fastExp(v, 3); return v3 * v3; }
+		case 7: return fastExp(v, 6) * v;
+		case 8: { const float v4 = fastExp(v, 4); return v4 * v4; }
+		case 9: return fastExp(v, 8) * v;
+		case 10: { const float v5 = fastExp(v, 5); return v5 * v5; }
+		default: break;
+	}
+	float result = 1.0f;
+	while (n)
+	{
+		if (n % 2 == 1)
+		{
+			result *= v;
+			--n;
+		}
+		v *= v;
+		n /= 2;
+	}
+	return result;
+}
+
+} // namespace
+
+
+
+
+class ExprProgram::Parser
+{
+public:
+	using Type = Token::Type;
+
+	Parser(ExprProgram& program, const ExprSymbols& symbols, std::vector<Token> tokens) :
+		m_program(program),
+		m_symbols(symbols),
+		m_tokens(std::move(tokens))
+	{
+	}
+
+	Operand parse()
+	{
+		const auto result = comparison();
+		if (peek().type != Type::End) { throw Unsupported{}; }
+		return result;
+	}
+
+private:
+	const Token& peek() const { return m_tokens[m_pos]; }
+	const Token& next() { return m_tokens[m_pos++]; }
+
+	bool isOperator(const char* op) const
+	{
+		return peek().type == Type::Operator && peek().text == op;
+	}
+
+	void expect(Type type)
+	{
+		if (next().type != type) { throw Unsupported{}; }
+	}
+
+	Operand binaryOp(Op op, Operand a, Operand b)
+	{
+		auto in = Instruction{};
+		in.op = op;
+		in.a = a.buffer;
+		in.b = b.buffer;
+		return m_program.emit(in, {a, b}, true);
+	}
+
+	Operand unaryOp(Op op, Operand a)
+	{
+		auto in = Instruction{};
+		in.op = op;
+		in.a = a.buffer;
+		return m_program.emit(in, {a}, true);
+	}
+
+	Operand comparison()
+	{
+		static constexpr std::pair<const char*, Op> comparisons[] = {
+			{"<", Op::Less}, {"<=", Op::LessEqual}, {">", Op::Greater}, {">=", Op::GreaterEqual}
+		};
+
+		const auto lhs = additive();
+		for (const auto& [text, op] : comparisons)
+		{
+			if (!isOperator(text)) { continue; }
+			next();
+			const auto rhs = additive();
+			// chained comparisons are left to exprtk
+			if (peek().type == Type::Operator && (peek().text[0] == '<' || peek().text[0] == '>'))
+			{
+				throw Unsupported{};
+			}
+			return binaryOp(op, lhs, rhs);
+		}
+		return lhs;
+	}
+
+	Operand additive()
+	{
+		auto lhs = term();
+		while (isOperator("+") || isOperator("-"))
+		{
+			const auto op = next().text == "+" ? Op::Add : Op::Sub;
+			lhs = binaryOp(op, lhs, term());
+		}
+		return lhs;
+	}
+
+	Operand term()
+	{
+		auto lhs = unary();
+		while (isOperator("*") || isOperator("/") || isOperator("%"))
+		{
+			const auto& text = next().text;
+			const auto op = text == "*" ? Op::Mul : text == "/" ? Op::Div : Op::Mod;
+			lhs = binaryOp(op, lhs, unary());
+		}
+		return lhs;
+	}
+
+	Operand unary()
+	{
+		int negations = 0;
+		bool hasSign = false;
+		while (isOperator("-") || isOperator("+"))
+		{
+			hasSign = true;
+			if (next().text == "-") { ++negations; }
+		}
+
+		bool hasPower = false;
+		auto operand = power(hasPower);
+		// whether the sign binds stronger than ^ is left to exprtk
+		if (hasSign && hasPower) { throw Unsupported{}; }
+
+		for (int i = 0; i < negations; ++i)
+		{
+			operand = unaryOp(Op::Neg, operand);
+		}
+		return operand;
+	}
+
+	Operand power(bool& hasPower)
+	{
+		const auto base = primary();
+		if (!isOperator("^")) { return base; }
+		next();
+		hasPower = true;
+
+		const auto type = peek().type;
+		if (type != Type::Number && type != Type::Symbol && type != Type::LeftParen) { throw Unsupported{}; }
+		const auto exponent = primary();
+		// so is the associativity of a ^ b ^ c
+		if (isOperator("^")) { throw Unsupported{}; }
+
+		return pow(base, exponent);
+	}
+
+	Operand pow(Operand base, Operand exponent)
+	{
+		if (exponent.constant)
+		{
+			const float c = exponent.buffer[0];
+			if (std::abs(c) <= 60.0f && c == std::trunc(c))
+			{
+				m_program.release(exponent);
+				if (c == 2.0f) { return binaryOp(Op::Mul, base, base); }
+
+				auto in = Instruction{};
+				in.op = Op::PowInt;
+				in.a = base.buffer;
+				in.exponent = static_cast<int>(c);
+				return m_program.emit(in, {base}, true);
+			}
+		}
+		return binaryOp(Op::Pow, base, exponent);
+	}
+
+	Operand primary()
+	{
+		const auto token = next();
+		switch (token.type)
+		{
+			case Type::Number:
+			{
+				float value = 0.0f;
+				if (m_symbols.parseNumber)
+				{
+					if (!m_symbols.parseNumber(token.text, value)) { throw Unsupported{}; }
+				}
+				else
+				{
+					value = std::strtof(token.text.c_str(), nullptr);
+				}
+				return m_program.constant(value);
+			}
+			case Type::LeftParen:
+			{
+				const auto result = comparison();
+				expect(Type::RightParen);
+				return result;
+			}
+			case Type::Symbol:
+				if (peek().type == Type::LeftParen)
+				{
+					next();
+					return call(token.text);
+				}
+				return symbol(token.text);
+			default:
+				throw Unsupported{};
+		}
+	}
+
+	std::vector<Operand> arguments()
+	{
+		auto args = std::vector<Operand>{};
+		if (peek().type == Type::RightParen)
+		{
+			next();
+			return args;
+		}
+		while (true)
+		{
+			args.push_back(comparison());
+			const auto& token = next();
+			if (token.type == Type::RightParen) { return args; }
+			if (token.type != Type::Comma) { throw Unsupported{}; }
+		}
+	}
+
+	Operand call(const std::string& name)
+	{
+		static const auto unaryFunctions = std::map<std::string, Op>{
+			{"abs", Op::Abs}, {"sin", Op::Sin}, {"cos", Op::Cos}, {"tan", Op::Tan},
+			{"asin", Op::Asin}, {"acos", Op::Acos}, {"atan", Op::Atan},
+			{"sinh", Op::Sinh}, {"cosh", Op::Cosh}, {"tanh", Op::Tanh},
+			{"exp", Op::Exp}, {"log", Op::Log}, {"sqrt", Op::Sqrt},
+			{"floor", Op::Floor}, {"ceil", Op::Ceil}, {"round", Op::Round},
+			{"trunc", Op::Trunc}, {"frac", Op::Frac}, {"sgn", Op::Sgn}
+		};
+		static const auto binaryFunctions = std::map<std::string, Op>{
+			{"min", Op::Min}, {"max", Op::Max}, {"atan2", Op::Atan2}, {"pow", Op::Pow}
+		};
+
+		// symbols shadow the built-in functions
+		const auto f0 = m_symbols.functions0.find(name);
+		const auto f1 = m_symbols.functions1.find(name);
+		const auto f2 = m_symbols.functions2.find(name);
+
+		const auto args = arguments();
+		auto in = Instruction{};
+
+		if (f0 != m_symbols.functions0.end() && args.empty())
+		{
+			return callFunction0(f0->second);
+		}
+		if (f1 != m_symbols.functions1.end() && args.size() == 1)
+		{
+			in.op = Op::Call1;
+			in.a = args[0].buffer;
+			in.function1 = f1->second.function;
+			in.data = f1->second.data;
+			m_program.m_sequential |= f1->second.sequential;
+			return m_program.emit(in, {args[0]}, false);
+		}
+		if (f2 != m_symbols.functions2.end() && args.size() == 2)
+		{
+			in.op = Op::Call2;
+			in.a = args[0].buffer;
+			in.b = args[1].buffer;
+			in.function2 = f2->second.function;
+			in.data = f2->second.data;
+			m_program.m_sequential |= f2->second.sequential;
+			return m_program.emit(in, {args[0], args[1]}, false);
+		}
+		if (name == "integrate" && m_symbols.integrateSampleRate > 0 && args.size() == 1)
+		{
+			in.op = Op::Integrate;
+			in.a = args[0].buffer;
+			in.counter = m_program.m_counters.size();
+			m_program.m_counters.push_back(0.0);
+			return m_program.emit(in, {args[0]}, false);
+		}
+		if (const auto it = unaryFunctions.find(name); it != unaryFunctions.end() && args.size() == 1)
+		{
+			return unaryOp(it->second, args[0]);
+		}
+		if (const auto it = binaryFunctions.find(name); it != binaryFunctions.end() && args.size() == 2)
+		{
+			// exprtk may optimize pow() with constant exponents differently from ^
+			if (it->second == Op::Pow && args[1].constant) { throw Unsupported{}; }
+			return binaryOp(it->second, args[0], args[1]);
+		}
+		throw Unsupported{};
+	}
+
+	Operand callFunction0(const ExprSymbols::Binding<ExprSymbols::Function0>& binding)
+	{
+		auto in = Instruction{};
+		in.op = Op::Call0;
+		in.function0 = binding.function;
+		m_program.m_sequential |= binding.sequential;
+		return m_program.emit(in, {}, false);
+	}
+
+	Operand symbol(const std::string& name)
+	{
+		if (const auto it = m_symbols.inputs.find(name); it != m_symbols.inputs.end())
+		{
+			return bound(it->second, m_program.m_inputs);
+		}
+		if (const auto it = m_symbols.variables.find(name); it != m_symbols.variables.end())
+		{
+			return bound(it->second, m_program.m_variables);
+		}
+		if (const auto it = m_symbols.constants.find(name); it != m_symbols.constants.end())
+		{
+			return m_program.constant(it->second);
+		}
+		if (const auto it = m_symbols.functions0.find(name); it != m_symbols.functions0.end())
+		{
+			return callFunction0(it->second);
+		}
+		throw Unsupported{};
+	}
+
+	//! Each variable or input gets one buffer, no matter how often it is used
+	Operand bound(const float* source, std::vector<std::pair<const float*, float*>>& list)
+	{
+		const auto it = std::find_if(list.begin(), list.end(), [source](const auto& p) { return p.first == source; });
+		if (it != list.end()) { return {it->second, false, false}; }
+
+		float* buffer = m_program.allocate();
+		list.emplace_back(source, buffer);
+		return {buffer, false, false};
+	}
+
+	ExprProgram& m_program;
+	const ExprSymbols& m_symbols;
+	const std::vector<Token> m_tokens;
+	std::size_t m_pos = 0;
+} ;
+
+
+
+
+bool ExprProgram::compile(const std::string& expression, const ExprSymbols& symbols, std::size_t maxFrames)
+{
+	m_maxFrames = std::max<std::size_t>(maxFrames, 1);
+	m_buffers.clear();
+	m_freeRegisters.clear();
+	m_variables.clear();
+	m_inputs.clear();
+	m_counters.clear();
+	m_code.clear();
+	m_result = nullptr;
+	m_integrateSampleRate = symbols.integrateSampleRate;
+	m_sequential = false;
+
+	try
+	{
+		auto parser = Parser(*this, symbols, tokenize(expression));
+		m_result = parser.parse().buffer;
+	}
+	catch (const Unsupported&)
+	{
+		m_code.clear();
+		m_buffers.clear();
+		return false;
+	}
+	return true;
+}
+
+
+
+
+void ExprProgram::run(float* out, std::size_t frames, std::size_t offset)
+{
+	for (const auto& [source, buffer] : m_inputs)
+	{
+		std::copy_n(source + offset, frames, buffer);
+	}
+	for (const auto& [source, buffer] : m_variables)
+	{
+		std::fill_n(buffer, frames, *source);
+	}
+
+	for (const auto& in : m_code)
+	{
+		execute(in, frames);
+	}
+
+	std::copy_n(m_result, frames, out);
+}
+
+
+
+
+void ExprProgram::execute(const Instruction& in, std::size_t frames)
+{
+	switch (in.op)
+	{
+		case Op::Neg: unary(in, frames, [](float x) { return -x; }); break;
+		case Op::Abs: unary(in, frames, [](float x) { return x < 0 ? -x : x; }); break;
+		case Op::Sin: unary(in, frames, [](float x) { return std::sin(x); }); break;
+		case Op::Cos: unary(in, frames, [](float x) { return std::cos(x); }); break;
+		case Op::Tan: unary(in, frames, [](float x) { return std::tan(x); }); break;
+		case Op::Asin: unary(in, frames, [](float x) { return std::asin(x); }); break;
+		case Op::Acos: unary(in, frames, [](float x) { return std::acos(x); }); break;
+		case Op::Atan: unary(in, frames, [](float x) { return std::atan(x); }); break;
+		case Op::Sinh: unary(in, frames, [](float x) { return std::sinh(x); }); break;
+		case Op::Cosh: unary(in, frames, [](float x) { return std::cosh(x); }); break;
+		case Op::Tanh: unary(in, frames, [](float x) { return std::tanh(x); }); break;
+		case Op::Exp: unary(in, frames, [](float x) { return std::exp(x); }); break;
+		case Op::Log: unary(in, frames, [](float x) { return std::log(x); }); break;
+		case Op::Sqrt: unary(in, frames, [](float x) { return std::sqrt(x); }); break;
+		case Op::Floor: unary(in, frames, [](float x) { return std::floor(x); }); break;
+		case Op::Ceil: unary(in, frames, [](float x) { return std::ceil(x); }); break;
+		case Op::Round:
+			unary(in, frames, [](float x) { return x < 0 ? std::ceil(x - 0.5f) : std::floor(x + 0.5f); });
+			break;
+		case Op::Trunc:
+			unary(in, frames, [](float x) { return static_cast<float>(static_cast<long long>(x)); });
+			break;
+		case Op::Frac: unary(in, frames, [](float x) { return x - static_cast<long long>(x); }); break;
+		case Op::Sgn:
+			unary(in, frames, [](float x) { return x > 0 ? 1.0f : x < 0 ? -1.0f : 0.0f; });
+			break;
+		case Op::PowInt:
+		{
+			const int n = in.exponent;
+			unary(in, frames, [n](float x) { return n < 0 ? 1.0f / fastExp(x, -n) : fastExp(x, n); });
+			break;
+		}
+		case Op::Add: binary(in, frames, [](float a, float b) { return a + b; }); break;
+		case Op::Sub: binary(in, frames, [](float a, float b) { return a - b; }); break;
+		case Op::Mul: binary(in, frames, [](float a, float b) { return a * b; }); break;
+		case Op::Div: binary(in, frames, [](float a, float b) { return a / b; }); break;
+		case Op::Mod: binary(in, frames, [](float a, float b) { return std::fmod(a, b); }); break;
+		case Op::Pow: binary(in, frames, [](float a, float b) { return std::pow(a, b); }); break;
+		case Op::Min: binary(in, frames, [](float a, float b) { return std::min(a, b); }); break;
+		case Op::Max: binary(in, frames, [](float a, float b) { return std::max(a, b); }); break;
+		case Op::Atan2: binary(in, frames, [](float a, float b) { return std::atan2(a, b); }); break;
+		case Op::Less: binary(in, frames, [](float a, float b) { return a < b ? 1.0f : 0.0f; }); break;
+		case Op::LessEqual: binary(in, frames, [](float a, float b) { return a <= b ? 1.0f : 0.0f; }); break;
+		case Op::Greater: binary(in, frames, [](float a, float b) { return a > b ? 1.0f : 0.0f; }); break;
+		case Op::GreaterEqual: binary(in, frames, [](float a, float b) { return a >= b ? 1.0f : 0.0f; }); break;
+		case Op::Call0:
+			for (std::size_t f = 0; f < frames; ++f) { in.dst[f] = in.function0(); }
+			break;
+		case Op::Call1:
+			for (std::size_t f = 0; f < frames; ++f) { in.dst[f] = in.function1(in.data, in.a[f]); }
+			break;
+		case Op::Call2:
+			for (std::size_t f = 0; f < frames; ++f) { in.dst[f] = in.function2(in.data, in.a[f], in.b[f]); }
+			break;
+		case Op::Integrate:
+		{
+			// same as IntegrateFunction: the result is the sum before adding the current value
+			double& counter = m_counters[in.counter];
+			for (std::size_t f = 0; f < frames; ++f)
+			{
+				const float res = static_cast<float>(counter);
+				counter += in.a[f];
+				in.dst[f] = res / m_integrateSampleRate;
+			}
+			break;
+		}
+	}
+}
+
+
+
+
+float* ExprProgram::allocate()
+{
+	m_buffers.emplace_back(m_maxFrames);
+	return m_buffers.back().data();
+}
+
+
+
+
+ExprProgram::Operand ExprProgram::constant(float value)
+{
+	float* buffer = allocate();
+	std::fill_n(buffer, m_maxFrames, value);
+	return {buffer, true, false};
+}
+
+
+
+
+ExprProgram::Operand ExprProgram::registerOperand()
+{
+	if (!m_freeRegisters.empty())
+	{
+		float* buffer = m_freeRegisters.back();
+		m_freeRegisters.pop_back();
+		return {buffer, false, true};
+	}
+	return {allocate(), false, true};
+}
+
+
+
+
+void ExprProgram::release(const Operand& operand)
+{
+	if (operand.reg && std::find(m_freeRegisters.begin(), m_freeRegisters.end(), operand.buffer) == m_freeRegisters.end())
+	{
+		m_freeRegisters.push_back(operand.buffer);
+	}
+}
+
+
+
+
+ExprProgram::Operand ExprProgram::emit(Instruction in, std::initializer_list<Operand> operands, bool pure)
+{
+	const bool constant = pure && std::all_of(operands.begin(), operands.end(), [](const Operand& o) { return o.constant; });
+	for (const auto& operand : operands)
+	{
+		release(operand);
+	}
+
+	if (constant)
+	{
+		// fold at compile time, computing the value exactly as at run time
+		const auto result = this->constant(0.0f);
+		in.dst = result.buffer;
+		execute(in, 1);
+		std::fill_n(result.buffer, m_maxFrames, result.buffer[0]);
+		return result;
+	}
+
+	const auto result = registerOperand();
+	in.dst = result.buffer;
+	m_code.push_back(in);
+	return result;
+}
+
+
+} // namespace lmms
@@ -0,0 +1,160 @@
+/*
+ * ExprProgram.h - block evaluation of Xpressive expressions
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef EXPRPROGRAM_H
+#define EXPRPROGRAM_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lmms
+{
+
+
+//! Everything an expression may refer to. Names are case insensitive, like in exprtk.
+struct ExprSymbols
+{
+	using Function0 = float (*)();
+	using Function1 = float (*)(void*, float);
+	using Function2 = float (*)(void*, float, float);
+	using NumberParser = bool (*)(const std::string&, float&);
+
+	template<typename F>
+	struct Binding
+	{
+		F function;
+		void* data;
+		//! The result depends on the order of calls, e.g. random numbers or the output history
+		bool sequential;
+	};
+
+	std::map<std::string, float> constants;
+	//! Read once per ExprProgram::run()
+	std::map<std::string, const float*> variables;
+	//! Arrays with one value per frame
+	std::map<std::string, const float*> inputs;
+	std::map<std::string, Binding<Function0>> functions0;
+	std::map<std::string, Binding<Function1>> functions1;
+	std::map<std::string, Binding<Function2>> functions2;
+	//! Sample rate of integrate(), or 0 if it is not available
+	unsigned int integrateSampleRate = 0;
+	//! Converts number literals, so they get the exact same value as in exprtk
+	NumberParser parseNumber = nullptr;
+};
+
+
+/**
+ * An expression compiled to a list of instructions, each of which processes
+ * a whole block of frames. This avoids walking the expression tree for every
+ * sample and lets the compiler vectorize the arithmetic.
+ *
+ * Only a conservative subset of the exprtk syntax is supported: numbers,
+ * symbols, + - * / % ^, relational operators, parentheses, implicit
+ * multiplication and the common math functions. compile() fails for
+ * everything else, in which case the exprtk expression has to be used.
+ */
+class ExprProgram
+{
+public:
+	bool compile(const std::string& expression, const ExprSymbols& symbols, std::size_t maxFrames);
+
+	//! True if a frame may depend on the result of earlier frames, so run() must be called for single frames
+	bool isSequential() const { return m_sequential; }
+
+	//! Evaluates frames [offset, offset + frames) of the inputs
+	void run(float* out, std::size_t frames, std::size_t offset = 0);
+
+private:
+	enum class Op
+	{
+		Neg, Abs, Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh,
+		Exp, Log, Sqrt, Floor, Ceil, Round, Trunc, Frac, Sgn, PowInt,
+		Add, Sub, Mul, Div, Mod, Pow, Min, Max, Atan2,
+		Less, LessEqual, Greater, GreaterEqual,
+		Call0, Call1, Call2, Integrate
+	};
+
+	struct Instruction
+	{
+		Op op;
+		float* dst;
+		const float* a;
+		const float* b;
+		int exponent;
+		ExprSymbols::Function0 function0;
+		ExprSymbols::Function1 function1;
+		ExprSymbols::Function2 function2;
+		void* data;
+		std::size_t counter;
+	};
+
+	struct Operand
+	{
+		float* buffer;
+		bool constant;
+		bool reg;
+	};
+
+	class Parser;
+
+	void execute(const Instruction& in, std::size_t frames);
+
+	template<typename F>
+	static void unary(const Instruction& in, std::size_t frames, F&& fn)
+	{
+		for (std::size_t f = 0; f < frames; ++f) { in.dst[f] = fn(in.a[f]); }
+	}
+
+	template<typename F>
+	static void binary(const Instruction& in, std::size_t frames, F&& fn)
+	{
+		for (std::size_t f = 0; f < frames; ++f) { in.dst[f] = fn(in.a[f], in.b[f]); }
+	}
+
+	float* allocate();
+	Operand constant(float value);
+	Operand registerOperand();
+	void release(const Operand& operand);
+	Operand emit(Instruction in, std::initializer_list<Operand> operands, bool pure);
+
+	std::size_t m_maxFrames = 0;
+	std::vector<std::vector<float>> m_buffers;
+	std::vector<float*> m_freeRegisters;
+	//! Variables and inputs are copied into their buffers at the start of each run
+	std::vector<std::pair<const float*, float*>> m_variables;
+	std::vector<std::pair<const float*, float*>> m_inputs;
+	std::vector<double> m_counters;
+	std::vector<Instruction> m_code;
+	const float* m_result = nullptr;
+	unsigned int m_integrateSampleRate = 0;
+	bool m_sequential = false;
+} ;
+
+
+} // namespace lmms
+
+#endif
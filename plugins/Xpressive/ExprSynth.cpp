@@ -27,10 +27,15 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <random>
 #include <numbers>
 
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "ExprProgram.h"
 #include "lmms_math.h"
 #include "NotePlayHandle.h"
 #include "SampleFrame.h"
@@ -371,6 +376,36 @@ namespace SimpleRandom {
 
 static freefunc0<float,SimpleRandom::float_random_with_engine,false> simple_rand;
 
+// adapters for calling the functions from an ExprProgram without virtual dispatch
+template <typename Functor>
+float callPure(void*, float x)
+{
+	return Functor::process(x);
+}
+template <typename Function>
+float callFunction(void* function, float x)
+{
+	return static_cast<Function*>(function)->Function::operator()(x);
+}
+template <typename Function>
+float callFunction2(void* function, float x, float y)
+{
+	return static_cast<Function*>(function)->Function::operator()(x, y);
+}
+
+static bool parseNumber(const std::string& text, float& value)
+{
+	return exprtk::details::string_to_real(text, value);
+}
+
+static std::string symbolName(const char* name)
+{
+	std::string res = name;
+	std::transform(res.begin(), res.end(), res.begin(),
+		[](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	return res;
+}
+
 class ExprFrontData
 {
 public:
@@ -403,6 +438,9 @@ public:
 	RandomVectorFunction m_rand_vec;
 	IntegrateFunction<float> *m_integ_func;
 	LastSampleFunction<float> m_last_func;
+	ExprSymbols m_symbols;
+	ExprProgram m_program;
+	bool m_has_program = false;
 
 };
 
@@ -536,7 +574,8 @@ ExprFront::ExprFront(const char * expr, int last_func_samples)
 
 		m_data->m_symbol_table.add_constant("e", std::numbers::e_v<float>);
 
-		m_data->m_symbol_table.add_constant("seed", SimpleRandom::generator() & max_float_integer_mask);
+		const float seed = SimpleRandom::generator() & max_float_integer_mask;
+		m_data->m_symbol_table.add_constant("seed", seed);
 
 		m_data->m_symbol_table.add_function("sinew", sin_wave_func);
 		m_data->m_symbol_table.add_function("squarew", square_wave_func);
@@ -552,6 +591,27 @@ ExprFront::ExprFront(const char * expr, int last_func_samples)
 		m_data->m_symbol_table.add_function("randv", m_data->m_rand_vec);
 		m_data->m_symbol_table.add_function("randsv", randsv_func);
 		m_data->m_symbol_table.add_function("last", m_data->m_last_func);
+
+		// the same symbols for ExprProgram
+		ExprSymbols& symbols = m_data->m_symbols;
+		symbols.constants["pi"] = std::numbers::pi_v<float>;
+		symbols.constants["e"] = std::numbers::e_v<float>;
+		symbols.constants["seed"] = seed;
+		symbols.functions1["sinew"] = {callPure<sin_wave>, nullptr, false};
+		symbols.functions1["squarew"] = {callPure<square_wave>, nullptr, false};
+		symbols.functions1["trianglew"] = {callPure<triangle_wave>, nullptr, false};
+		symbols.functions1["saww"] = {callPure<saw_wave>, nullptr, false};
+		symbols.functions1["moogsaww"] = {callPure<moogsaw_wave>, nullptr, false};
+		symbols.functions1["moogw"] = {callPure<moog_wave>, nullptr, false};
+		symbols.functions1["expw"] = {callPure<exp_wave>, nullptr, false};
+		symbols.functions1["expnw"] = {callPure<exp2_wave>, nullptr, false};
+		symbols.functions1["cent"] = {callPure<harmonic_cent>, nullptr, false};
+		symbols.functions1["semitone"] = {callPure<harmonic_semitone>, nullptr, false};
+		symbols.functions0["rand"] = {SimpleRandom::float_random_with_engine::process, nullptr, true};
+		symbols.functions1["randv"] = {callFunction<RandomVectorFunction>, &m_data->m_rand_vec, false};
+		symbols.functions2["randsv"] = {callFunction2<RandomVectorSeedFunction>, &randsv_func, false};
+		symbols.functions1["last"] = {callFunction<LastSampleFunction<float>>, &m_data->m_last_func, true};
+		symbols.parseNumber = parseNumber;
 	}
 	catch(...)
 	{
@@ -610,6 +670,7 @@ bool ExprFront::add_variable(const char* name, float& ref)
 {
 	try
 	{
+		m_data->m_symbols.variables[symbolName(name)] = &ref;
 		return m_data->m_symbol_table.add_variable(name, ref);
 	}
 	catch(...)
@@ -623,6 +684,7 @@ bool ExprFront::add_constant(const char* name, float ref)
 {
 	try
 	{
+		m_data->m_symbols.constants[symbolName(name)] = ref;
 		return m_data->m_symbol_table.add_constant(name, ref);
 	}
 	catch(...)
@@ -640,12 +702,14 @@ bool ExprFront::add_cyclic_vector(const char* name, const float* data, size_t le
 		{
 			auto wvf = new WaveValueFunctionInterpolate<float>(data, length);
 			m_data->m_cyclics_interp.push_back(wvf);
+			m_data->m_symbols.functions1[symbolName(name)] = {callFunction<WaveValueFunctionInterpolate<float>>, wvf, false};
 			return m_data->m_symbol_table.add_function(name, *wvf);
 		}
 		else
 		{
 			auto wvf = new WaveValueFunction<float>(data, length);
 			m_data->m_cyclics.push_back(wvf);
+			m_data->m_symbols.functions1[symbolName(name)] = {callFunction<WaveValueFunction<float>>, wvf, false};
 			return m_data->m_symbol_table.add_function(name, *wvf);
 		}
 	}
@@ -682,6 +746,7 @@ void ExprFront::setIntegrate(const unsigned int* const frameCounter, const unsig
 		if ( ointeg > 0 )
 		{
 			m_data->m_integ_func = new IntegrateFunction<float>(frameCounter,sample_rate,ointeg);
+			m_data->m_symbols.integrateSampleRate = sample_rate;
 			try
 			{
 				m_data->m_symbol_table.add_function("integrate",*m_data->m_integ_func);
@@ -694,6 +759,55 @@ void ExprFront::setIntegrate(const unsigned int* const frameCounter, const unsig
 	}
 }
 
+void ExprFront::setFrameInput(const char* name, const float* data)
+{
+	const std::string symbol = symbolName(name);
+	m_data->m_symbols.variables.erase(symbol);
+	m_data->m_symbols.inputs[symbol] = data;
+}
+
+bool ExprFront::compileProgram(std::size_t maxFrames)
+{
+	m_data->m_has_program = false;
+	if (!m_valid)
+	{
+		return false;
+	}
+	try
+	{
+		m_data->m_has_program = m_data->m_program.compile(m_data->m_expression_string, m_data->m_symbols, maxFrames);
+	}
+	catch(...)
+	{
+		WARN_EXPRTK;
+	}
+	return m_data->m_has_program;
+}
+
+ExprProgram* ExprFront::program()
+{
+	return m_data->m_has_program ? &m_data->m_program : nullptr;
+}
+
+void ExprFront::runProgram(float* out, std::size_t frames, std::size_t offset)
+{
+	m_data->m_program.run(out, frames, offset);
+	// only sequential programs can use last(), and they are run a frame at a time
+	if (m_data->m_program.isSequential())
+	{
+		for (std::size_t frame = 0; frame < frames; ++frame)
+		{
+			m_data->m_last_func.setLastSample(out[frame]);
+		}
+	}
+}
+
+void ExprFront::seedRandom(unsigned int seed)
+{
+	SimpleRandom::generator.seed(seed);
+	SimpleRandom::dist.reset();
+}
+
 ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSample *gW3,
 	ExprFront *exprO1, ExprFront *exprO2,
 	NotePlayHandle *nph, const sample_rate_t sample_rate,
@@ -717,6 +831,12 @@ ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSam
 	m_frequency = m_nph->frequency();
 	m_rel_inc = 1000.0 / (m_sample_rate * m_rel_transition);//rel_transition in ms. compute how much increment in each frame
 
+	const fpp_t max_frames = Engine::audioEngine()->framesPerPeriod();
+	for (auto block : {&m_block_t, &m_block_f, &m_block_rel, &m_block_trel, &m_block_o1, &m_block_o2})
+	{
+		block->resize(max_frames);
+	}
+
 	auto init_expression_step2 = [this](ExprFront * e) {
 		e->add_cyclic_vector("W1", m_W1->m_samples,m_W1->m_length, m_W1->m_interpolate);
 		e->add_cyclic_vector("W2", m_W2->m_samples,m_W2->m_length, m_W2->m_interpolate);
@@ -726,7 +846,12 @@ ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSam
 		e->add_variable("rel",m_released);
 		e->add_variable("trel",m_note_rel_sec);
 		e->setIntegrate(&m_note_sample,m_sample_rate);
+		e->setFrameInput("t", m_block_t.data());
+		e->setFrameInput("f", m_block_f.data());
+		e->setFrameInput("rel", m_block_rel.data());
+		e->setFrameInput("trel", m_block_trel.data());
 		e->compile();
+		e->compileProgram(m_block_t.size());
 	};
 	init_expression_step2(m_exprO1);
 	init_expression_step2(m_exprO2);
@@ -770,7 +895,67 @@ void ExprSynth::renderOutput(fpp_t frames, SampleFrame* buf)
 		{
 			m_note_rel_sample = m_note_sample;
 		}
-		if (o1_valid && o2_valid)
+		ExprProgram* program1 = o1_valid ? m_exprO1->program() : nullptr;
+		ExprProgram* program2 = o2_valid ? m_exprO2->program() : nullptr;
+		if ((!o1_valid || program1) && (!o2_valid || program2) && frames <= m_block_t.size())
+		{
+			// advance the variables exactly like the per sample loops below
+			for (fpp_t frame = 0; frame < frames ; ++frame)
+			{
+				if (is_released && m_released < 1)
+				{
+					m_released = fmin(m_released+m_rel_inc, 1);
+				}
+				m_block_t[frame] = m_note_sample_sec;
+				m_block_f[frame] = m_frequency;
+				m_block_rel[frame] = m_released;
+				m_block_trel[frame] = m_note_rel_sec;
+				m_note_sample++;
+				m_note_sample_sec = m_note_sample / (float)m_sample_rate;
+				if (is_released)
+				{
+					m_note_rel_sec = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
+				}
+				m_frequency += freq_inc;
+			}
+
+			if ((program1 && program1->isSequential()) || (program2 && program2->isSequential()))
+			{
+				// rand() and last() depend on the order of evaluation, so keep it as it was
+				for (fpp_t frame = 0; frame < frames ; ++frame)
+				{
+					if (program1) { m_exprO1->runProgram(&m_block_o1[frame], 1, frame); }
+					if (program2) { m_exprO2->runProgram(&m_block_o2[frame], 1, frame); }
+				}
+			}
+			else
+			{
+				if (program1) { m_exprO1->runProgram(m_block_o1.data(), frames); }
+				if (program2) { m_exprO2->runProgram(m_block_o2.data(), frames); }
+			}
+
+			if (program1 && program2)
+			{
+				for (fpp_t frame = 0; frame < frames ; ++frame)
+				{
+					o1 = m_block_o1[frame];
+					o2 = m_block_o2[frame];
+					buf[frame][0] = (-pn1 + 0.5) * o1 + (-pn2 + 0.5) * o2;
+					buf[frame][1] = ( pn1 + 0.5) * o1 + ( pn2 + 0.5) * o2;
+				}
+			}
+			else
+			{
+				const std::vector<float>& out = program1 ? m_block_o1 : m_block_o2;
+				const float pn = program1 ? pn1 : pn2;
+				for (fpp_t frame = 0; frame < frames ; ++frame)
+				{
+					buf[frame][0] = (-pn + 0.5) * out[frame];
+					buf[frame][1] = ( pn + 0.5) * out[frame];
+				}
+			}
+		}
+		else if (o1_valid && o2_valid)
 		{
 			for (fpp_t frame = 0; frame < frames ; ++frame)
 			{
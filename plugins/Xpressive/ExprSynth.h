@@ -28,6 +28,7 @@
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <vector>
 #include "Graph.h"
 
 namespace lmms
@@ -35,6 +36,7 @@ namespace lmms
 
 
 class ExprFrontData;
+class ExprProgram;
 class FloatModel;
 class NotePlayHandle;
 class SampleFrame;
@@ -53,6 +55,16 @@ public:
 	bool add_constant(const char* name, float  ref);
 	bool add_cyclic_vector(const char* name, const float* data, size_t length, bool interp = false);
 	void setIntegrate(const unsigned int* frameCounter, unsigned int sample_rate);
+	//! Provides the values of a variable for each frame of a block, for the block evaluated program
+	void setFrameInput(const char* name, const float* data);
+	//! Compiles the expression for block evaluation, must be called after compile()
+	bool compileProgram(std::size_t maxFrames);
+	//! The block evaluated program, or nullptr if the expression is not supported by ExprProgram
+	ExprProgram* program();
+	//! Runs program() like ExprProgram::run() and keeps the history of last() like evaluate()
+	void runProgram(float* out, std::size_t frames, std::size_t offset = 0);
+	//! Restarts the random numbers of rand(), randv() and seed, to get reproducible results
+	static void seedRandom(unsigned int seed);
 	ExprFrontData* getData() { return m_data; }
 private:
 	ExprFrontData *m_data;
@@ -117,6 +129,14 @@ private:
 	float m_rel_transition;
 	float m_rel_inc;
 
+	// per frame values of t, f, rel and trel, and the results, for block evaluation
+	std::vector<float> m_block_t;
+	std::vector<float> m_block_f;
+	std::vector<float> m_block_rel;
+	std::vector<float> m_block_trel;
+	std::vector<float> m_block_o1;
+	std::vector<float> m_block_o2;
+
 } ;
 
 
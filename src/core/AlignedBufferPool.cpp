@@ -0,0 +1,86 @@
+/*
+ * AlignedBufferPool.cpp - float buffers carved from one aligned allocation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AlignedBufferPool.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace lmms
+{
+
+
+AlignedBufferPool::AlignedBufferPool(std::size_t buffers, std::size_t maxBufferSize)
+	: m_capacity(buffers * paddedSize(maxBufferSize))
+{
+	if (m_capacity == 0) { return; }
+	m_data = static_cast<float*>(::operator new(m_capacity * sizeof(float), std::align_val_t{Alignment}));
+}
+
+
+
+
+AlignedBufferPool::~AlignedBufferPool()
+{
+	if (m_data) { ::operator delete(m_data, std::align_val_t{Alignment}); }
+}
+
+
+
+
+AlignedBufferPool::AlignedBufferPool(AlignedBufferPool&& other) noexcept
+	: m_data(std::exchange(other.m_data, nullptr))
+	, m_capacity(std::exchange(other.m_capacity, 0))
+	, m_used(std::exchange(other.m_used, 0))
+{
+}
+
+
+
+
+AlignedBufferPool& AlignedBufferPool::operator=(AlignedBufferPool&& other) noexcept
+{
+	std::swap(m_data, other.m_data);
+	std::swap(m_capacity, other.m_capacity);
+	std::swap(m_used, other.m_used);
+	return *this;
+}
+
+
+
+
+float* AlignedBufferPool::allocate(std::size_t size)
+{
+	size = paddedSize(size);
+	if (size > m_capacity - m_used) { return nullptr; }
+
+	float* buffer = m_data + m_used;
+	std::fill_n(buffer, size, 0.f);
+	m_used += size;
+	return buffer;
+}
+
+
+} // namespace lmms
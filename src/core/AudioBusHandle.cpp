@@ -115,8 +115,12 @@ void AudioBusHandle::doProcessing()
 
 	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
 
-	// clear the buffer
-	zeroSampleFrames(m_buffer, fpp);
+	// clear the buffer, unless it is still silent from the last period
+	if (m_bufferDirty)
+	{
+		zeroSampleFrames(m_buffer, fpp);
+		m_bufferDirty = false;
+	}
 
 	//qDebug( "Playhandles: %d", m_playHandles.size() );
 	for (PlayHandle* ph : m_playHandles) // now we mix all playhandle buffers into our internal buffer
@@ -223,7 +227,8 @@ void AudioBusHandle::doProcessing()
 	// as of now there's no situation where we only have panning model but no volume model
 	// if we have neither, we don't have to do anything here - just pass the audio as is
 
-	// handle effects
+	// handle effects, which only write to the buffer while they are running
+	m_bufferDirty = m_bufferUsage || (m_effects && m_effects->isRunning());
 	const bool anyOutputAfterEffects = processEffects();
 	if (anyOutputAfterEffects || m_bufferUsage)
 	{
@@ -68,6 +68,14 @@ using LocklessListElement = LocklessList<PlayHandle*>::Element;
 
 static thread_local bool s_renderingThread = false;
 
+//! Number of worker threads to start in addition to the audio thread. Can be
+//! set through the configuration, e.g. to compare performance across thread counts.
+static int numWorkerThreads()
+{
+	const int renderThreads = ConfigManager::inst()->value("audioengine", "renderthreads").toInt();
+	return renderThreads > 0 ? renderThreads - 1 : QThread::idealThreadCount() - 1;
+}
+
 
 
 
@@ -75,12 +83,11 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_renderOnly( renderOnly ),
 	m_framesPerPeriod( DEFAULT_BUFFER_SIZE ),
 	m_baseSampleRate(std::max(ConfigManager::inst()->value("audioengine", "samplerate").toInt(), SUPPORTED_SAMPLERATES.front())),
-	m_inputBufferRead( 0 ),
-	m_inputBufferWrite( 1 ),
+	m_inputBufferFrames( 0 ),
 	m_outputBufferRead(nullptr),
 	m_outputBufferWrite(nullptr),
 	m_workers(),
-	m_numWorkers( QThread::idealThreadCount()-1 ),
+	m_numWorkers(numWorkerThreads()),
 	m_newPlayHandles( PlayHandle::MaxNumber ),
 	m_masterGain( 1.0f ),
 	m_audioDev( nullptr ),
@@ -89,14 +96,6 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_profiler(),
 	m_clearSignal(false)
 {
-	for( int i = 0; i < 2; ++i )
-	{
-		m_inputBufferFrames[i] = 0;
-		m_inputBufferSize[i] = DEFAULT_BUFFER_SIZE * 100;
-		m_inputBuffer[i] = new SampleFrame[ DEFAULT_BUFFER_SIZE * 100 ];
-		zeroSampleFrames(m_inputBuffer[i], m_inputBufferSize[i]);
-	}
-
 	// determine FIFO size and number of frames per period
 	int fifoSize = 1;
 
@@ -137,6 +136,12 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_outputBufferRead = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 	m_outputBufferWrite = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 
+	// devices may capture in larger blocks than our periods
+	const auto inputSize = std::max<std::size_t>(m_framesPerPeriod * 16, DEFAULT_BUFFER_SIZE * 100);
+	m_inputRing = std::make_unique<LocklessRingBuffer<SampleFrame>>(inputSize);
+	m_inputRingReader = std::make_unique<LocklessRingBufferReader<SampleFrame>>(*m_inputRing);
+	m_inputBuffer.resize(inputSize);
+
 
 	for( int i = 0; i < m_numWorkers+1; ++i )
 	{
@@ -174,12 +179,6 @@ AudioEngine::~AudioEngine()
 
 	delete m_midiClient;
 	delete m_audioDev;
-
-
-	for (const auto& input : m_inputBuffer)
-	{
-		delete[] input;
-	}
 }
 
 
@@ -251,29 +250,7 @@ bool AudioEngine::criticalXRuns() const
 
 void AudioEngine::pushInputFrames( SampleFrame* _ab, const f_cnt_t _frames )
 {
-	requestChangeInModel();
-
-	f_cnt_t frames = m_inputBufferFrames[ m_inputBufferWrite ];
-	auto size = m_inputBufferSize[m_inputBufferWrite];
-	SampleFrame* buf = m_inputBuffer[ m_inputBufferWrite ];
-
-	if( frames + _frames > size )
-	{
-		size = std::max(size * 2, frames + _frames);
-		auto ab = new SampleFrame[size];
-		memcpy( ab, buf, frames * sizeof( SampleFrame ) );
-		delete [] buf;
-
-		m_inputBufferSize[ m_inputBufferWrite ] = size;
-		m_inputBuffer[ m_inputBufferWrite ] = ab;
-
-		buf = ab;
-	}
-
-	memcpy( &buf[ frames ], _ab, _frames * sizeof( SampleFrame ) );
-	m_inputBufferFrames[ m_inputBufferWrite ] += _frames;
-
-	doneChangeInModel();
+	m_inputRing->write(_ab, _frames);
 }
 
 
@@ -312,13 +289,12 @@ void AudioEngine::renderStageNoteSetup()
 
 	swapBuffers();
 
-	// prepare master mix (clear internal buffers etc.)
-	Mixer * mixer = Engine::mixer();
-	mixer->prepareMasterMix();
-
 	// create play-handles for new notes, samples etc.
 	Engine::getSong()->processNextBuffer();
 
+	// with automation applied, controllers can be rendered before anybody reads them
+	Controller::updateControllers();
+
 	// add all play-handles that have to be added
 	for( LocklessListElement * e = m_newPlayHandles.popList(); e; )
 	{
@@ -327,6 +303,11 @@ void AudioEngine::renderStageNoteSetup()
 		m_newPlayHandles.free( e );
 		e = next;
 	}
+
+	// fade out voices exceeding the polyphony limits or the CPU budget
+	const auto voices = m_voiceManager.process(m_playHandles, m_profiler, outputSampleRate(),
+		!Engine::getSong()->isExporting());
+	m_profiler.setActiveVoices(voices);
 }
 
 
@@ -382,12 +363,21 @@ void AudioEngine::renderStageMix()
 {
 	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
 
+	// The output buffer is cleared lazily, consecutive silent periods don't touch it at all
+	if (!m_outputBufferWriteSilent)
+	{
+		zeroSampleFrames(m_outputBufferWrite.get(), m_framesPerPeriod);
+	}
+
 	Mixer *mixer = Engine::mixer();
-	mixer->masterMix(m_outputBufferWrite.get());
+	m_outputBufferWriteSilent = !mixer->masterMix(m_outputBufferWrite.get());
 
-	MixHelpers::multiply(m_outputBufferWrite.get(), m_masterGain, m_framesPerPeriod);
+	if (!m_outputBufferWriteSilent)
+	{
+		MixHelpers::multiply(m_outputBufferWrite.get(), m_masterGain, m_framesPerPeriod);
+	}
 
-	emit nextAudioBuffer(m_outputBufferRead.get());
+	m_outputTap.publish(m_outputBufferWrite.get(), m_framesPerPeriod);
 
 	// and trigger LFOs
 	EnvelopeAndLfoParameters::instances()->trigger();
@@ -397,6 +387,22 @@ void AudioEngine::renderStageMix()
 
 
 
+bool AudioEngine::isRenderingThread()
+{
+	return s_renderingThread;
+}
+
+
+
+
+void AudioEngine::setRenderingThread(bool rendering)
+{
+	s_renderingThread = rendering;
+}
+
+
+
+
 const SampleFrame* AudioEngine::renderNextBuffer()
 {
 	const auto lock = std::lock_guard{m_changeMutex};
@@ -404,11 +410,16 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 	m_profiler.startPeriod();
 	s_renderingThread = true;
 
+	// mixer channels and routes are edited without the lock, edits show up from the next period on
+	Engine::mixer()->startPeriod();
+
 	renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
 	renderStageInstruments();   // STAGE 1: run and render all play handles
 	renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
 	renderStageMix();           // STAGE 3: do master mix in mixer
 
+	Engine::mixer()->finishPeriod();
+
 	s_renderingThread = false;
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
 
@@ -420,12 +431,16 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 
 void AudioEngine::swapBuffers()
 {
-	m_inputBufferWrite = (m_inputBufferWrite + 1) % 2;
-	m_inputBufferRead = (m_inputBufferRead + 1) % 2;
-	m_inputBufferFrames[m_inputBufferWrite] = 0;
+	// take over the input captured since the last period
+	auto input = m_inputRingReader->read_max(m_inputBuffer.size());
+	m_inputBufferFrames = input.size();
+	for (f_cnt_t f = 0; f < m_inputBufferFrames; ++f)
+	{
+		m_inputBuffer[f] = input[f];
+	}
 
 	std::swap(m_outputBufferRead, m_outputBufferWrite);
-	zeroSampleFrames(m_outputBufferWrite.get(), m_framesPerPeriod);
+	std::swap(m_outputBufferReadSilent, m_outputBufferWriteSilent);
 }
 
 void AudioEngine::clear()
@@ -546,7 +561,11 @@ bool AudioEngine::addPlayHandle( PlayHandle* handle )
 	// Only add play handles if we have the CPU capacity to process them.
 	// Instrument play handles are not added during playback, but when the
 	// associated instrument is created, so add those unconditionally.
-	if (handle->type() == PlayHandle::Type::InstrumentPlayHandle || !criticalXRuns())
+	// Notes are always added if the voice manager is enabled, as it rather
+	// fades out less important voices than dropping new ones.
+	if (handle->type() == PlayHandle::Type::InstrumentPlayHandle
+		|| (handle->type() == PlayHandle::Type::NotePlayHandle && m_voiceManager.isEnabled())
+		|| !criticalXRuns())
 	{
 		m_newPlayHandles.push( handle );
 		handle->audioBusHandle()->addPlayHandle(handle);
@@ -59,6 +59,17 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 		m_detailLoad[i].store(newLoad * 0.05f + oldLoad * 0.95f, std::memory_order_relaxed);
 	}
 
+	// Estimate the cost of a single voice from the time spent rendering instruments.
+	// Averaged like the overall load, so the VoiceManager reacts to changes quickly.
+	if (m_activeVoices > 0)
+	{
+		const auto instruments = static_cast<std::size_t>(DetailType::Instruments);
+		const auto newVoiceLoad = 100.f * m_detailTime[instruments] / timeLimit / m_activeVoices;
+		const auto oldVoiceLoad = m_voiceLoad.load(std::memory_order_relaxed);
+		m_voiceLoad.store(oldVoiceLoad > 0 ? newVoiceLoad * 0.1f + oldVoiceLoad * 0.9f : newVoiceLoad,
+			std::memory_order_relaxed);
+	}
+
 	if( m_outputFile.isOpen() )
 	{
 		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
@@ -173,7 +173,9 @@ void AudioEngineWorkerThread::run()
 	{
 		m.lock();
 		queueReadyWaitCond->wait( &m );
+		AudioEngine::setRenderingThread(true);
 		globalJobQueue.run();
+		AudioEngine::setRenderingThread(false);
 		m.unlock();
 	}
 }
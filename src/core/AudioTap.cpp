@@ -0,0 +1,304 @@
+/*
+ * AudioTap.cpp - shared metering of audio buffers
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AudioTap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fftw3.h>
+
+#include "fft_helpers.h"
+
+namespace lmms
+{
+
+
+struct AudioTap::Fft
+{
+	static constexpr f_cnt_t Bins = SpectrumSize / 2 + 1;
+
+	Fft() :
+		window(SpectrumSize),
+		input(SpectrumSize),
+		history(SpectrumSize),
+		magnitudes(Bins),
+		output(fftwf_alloc_complex(Bins)),
+		plan(fftwf_plan_dft_r2c_1d(SpectrumSize, input.data(), output, FFTW_ESTIMATE))
+	{
+		precomputeWindow(window.data(), SpectrumSize, FFTWindow::BlackmanHarris);
+	}
+
+	~Fft()
+	{
+		fftwf_destroy_plan(plan);
+		fftwf_free(output);
+	}
+
+	std::vector<float> window;
+	std::vector<float> input;
+	//! The latest mono frames, oldest at historyPosition
+	std::vector<float> history;
+	std::size_t historyPosition = 0;
+	std::vector<float> magnitudes;
+	fftwf_complex* output;
+	fftwf_plan plan;
+};
+
+
+
+
+AudioTap::AudioTap(f_cnt_t capacity) :
+	m_queue(capacity),
+	m_reader(m_queue)
+{
+}
+
+
+
+
+AudioTap::~AudioTap()
+{
+	if (m_service) { m_service->removeTap(this); }
+}
+
+
+
+
+bool AudioTap::analyze(Delivery& delivery)
+{
+	auto& frames = delivery.frames;
+	if (frames.size() < m_queue.capacity()) { frames.resize(m_queue.capacity()); }
+
+	std::size_t count = 0;
+	{
+		const auto published = m_reader.read_max(frames.size());
+		count = published.size();
+		for (std::size_t f = 0; f < count; ++f)
+		{
+			frames[f] = published[f];
+		}
+	}
+	if (count == 0) { return false; }
+
+	auto peak = SampleFrame{};
+	auto squares = SampleFrame{};
+	for (std::size_t f = 0; f < count; ++f)
+	{
+		peak = peak.absMax(frames[f]);
+		squares += frames[f] * frames[f];
+	}
+	delivery.frameCount = static_cast<f_cnt_t>(count);
+	delivery.peak = peak;
+	delivery.rms = SampleFrame{std::sqrt(squares.left() / count), std::sqrt(squares.right() / count)};
+
+	delivery.hasSpectrum = std::any_of(m_subscribers.begin(), m_subscribers.end(),
+		[](const Subscriber& subscriber) { return subscriber.spectrum; });
+	if (delivery.hasSpectrum)
+	{
+		updateSpectrum(frames.data(), count);
+		delivery.spectrum.assign(m_spectrum.begin(), m_spectrum.end());
+	}
+
+	delivery.callbacks.clear();
+	for (const auto& subscriber : m_subscribers)
+	{
+		delivery.callbacks.push_back(subscriber.callback);
+	}
+	return true;
+}
+
+
+
+
+void AudioTap::Delivery::deliver() const
+{
+	static const auto noSpectrum = std::vector<float>{};
+	const auto analysis = Analysis{frames.data(), frameCount, peak, rms, hasSpectrum ? spectrum : noSpectrum};
+	for (const auto& callback : callbacks)
+	{
+		callback(analysis);
+	}
+}
+
+
+
+
+void AudioTap::updateSpectrum(const SampleFrame* frames, std::size_t count)
+{
+	auto& fft = *m_fft;
+	// only the latest frames matter if more than a block was published
+	const std::size_t skip = count > SpectrumSize ? count - SpectrumSize : 0;
+	for (std::size_t f = skip; f < count; ++f)
+	{
+		fft.history[fft.historyPosition] = frames[f].average();
+		fft.historyPosition = (fft.historyPosition + 1) % SpectrumSize;
+	}
+
+	for (std::size_t i = 0; i < SpectrumSize; ++i)
+	{
+		fft.input[i] = fft.history[(fft.historyPosition + i) % SpectrumSize] * fft.window[i];
+	}
+	fftwf_execute(fft.plan);
+
+	absspec(fft.output, fft.magnitudes.data(), Fft::Bins);
+	normalize(fft.magnitudes, m_spectrum, SpectrumSize);
+}
+
+
+
+
+AudioTapService::AudioTapService() = default;
+
+
+
+
+AudioTapService::~AudioTapService()
+{
+	{
+		QMutexLocker lock(&m_mutex);
+		requestInterruption();
+		m_tapsAdded.wakeAll();
+		for (auto tap : m_taps)
+		{
+			tap->m_service = nullptr;
+		}
+	}
+	wait();
+}
+
+
+
+
+int AudioTapService::subscribe(AudioTap& tap, AudioTap::Callback callback, bool spectrum)
+{
+	QMutexLocker lock(&m_mutex);
+
+	if (tap.m_subscribers.empty())
+	{
+		// drop what was left from earlier subscriptions
+		tap.m_reader.read_max(tap.m_queue.capacity());
+
+		tap.m_service = this;
+		m_taps.push_back(&tap);
+		tap.m_subscribed = true;
+		m_tapsAdded.wakeAll();
+	}
+
+	if (spectrum && !tap.m_fft)
+	{
+		// FFTW's planner is not thread safe, so the plan is made here like all others
+		tap.m_fft = std::make_unique<AudioTap::Fft>();
+		tap.m_spectrum.resize(AudioTap::Fft::Bins);
+	}
+
+	const int id = m_nextId++;
+	tap.m_subscribers.push_back({id, std::move(callback), spectrum});
+
+	if (!isRunning()) { start(QThread::LowPriority); }
+	return id;
+}
+
+
+
+
+void AudioTapService::unsubscribe(int id)
+{
+	{
+		QMutexLocker lock(&m_mutex);
+
+		for (auto it = m_taps.begin(); it != m_taps.end(); ++it)
+		{
+			auto& subscribers = (*it)->m_subscribers;
+			const auto subscriber = std::find_if(subscribers.begin(), subscribers.end(),
+				[id](const AudioTap::Subscriber& s) { return s.id == id; });
+			if (subscriber == subscribers.end()) { continue; }
+
+			subscribers.erase(subscriber);
+			if (subscribers.empty())
+			{
+				(*it)->m_subscribed = false;
+				m_taps.erase(it);
+			}
+			break;
+		}
+	}
+
+	// wait for callbacks collected before the subscriber was removed
+	if (QThread::currentThread() != this)
+	{
+		QMutexLocker waitForCallbacks(&m_callbackMutex);
+	}
+}
+
+
+
+
+void AudioTapService::removeTap(AudioTap* tap)
+{
+	QMutexLocker lock(&m_mutex);
+
+	tap->m_subscribed = false;
+	tap->m_subscribers.clear();
+	tap->m_service = nullptr;
+	m_taps.erase(std::remove(m_taps.begin(), m_taps.end(), tap), m_taps.end());
+}
+
+
+
+
+void AudioTapService::run()
+{
+	QMutexLocker lock(&m_mutex);
+	while (!isInterruptionRequested())
+	{
+		if (m_taps.empty())
+		{
+			m_tapsAdded.wait(&m_mutex);
+			continue;
+		}
+
+		if (m_deliveries.size() < m_taps.size()) { m_deliveries.resize(m_taps.size()); }
+		std::size_t ready = 0;
+		for (auto tap : m_taps)
+		{
+			if (tap->analyze(m_deliveries[ready])) { ++ready; }
+		}
+
+		// the callbacks may subscribe, unsubscribe or take locks of their own
+		{
+			QMutexLocker callingBack(&m_callbackMutex);
+			lock.unlock();
+			for (std::size_t i = 0; i < ready; ++i)
+			{
+				m_deliveries[i].deliver();
+			}
+		}
+
+		msleep(IntervalMs);
+		lock.relock();
+	}
+}
+
+
+} // namespace lmms
@@ -25,6 +25,7 @@
 #include "AutomatableModel.h"
 
 #include <QRegularExpression>
+#include <thread>
 
 #include "lmms_math.h"
 
@@ -38,7 +39,7 @@
 namespace lmms
 {
 
-long AutomatableModel::s_periodCounter = 0;
+std::atomic<long> AutomatableModel::s_periodCounter = 0;
 
 
 
@@ -58,8 +59,9 @@ AutomatableModel::AutomatableModel(
 	m_nextLink(this),
 	m_controllerConnection( nullptr ),
 	m_valueBuffer( static_cast<int>( Engine::audioEngine()->framesPerPeriod() ) ),
-	m_lastUpdatedPeriod( -1 ),
 	m_hasSampleExactData(false),
+	m_lastUpdatedPeriod( -1 ),
+	m_claimedPeriod( -1 ),
 	m_useControllerValue(true)
 
 {
@@ -175,6 +177,30 @@ void AutomatableModel::saveSettings( QDomDocument& doc, QDomElement& element, co
 
 
 
+std::unique_ptr<JournalDelta> AutomatableModel::saveJournalDelta()
+{
+	class ValueDelta : public JournalDelta
+	{
+	public:
+		explicit ValueDelta(float value) : m_value(value) {}
+
+		std::size_t size() const override { return sizeof(ValueDelta); }
+
+		void restore(JournallingObject* object) const override
+		{
+			static_cast<AutomatableModel*>(object)->setValue(m_value);
+		}
+
+	private:
+		float m_value;
+	};
+
+	return std::make_unique<ValueDelta>(m_value);
+}
+
+
+
+
 void AutomatableModel::loadSettings( const QDomElement& element, const QString& name )
 {
 	// compat code
@@ -323,6 +349,9 @@ void AutomatableModel::setValueInternal(const float value)
 		m_valueChanged = true;
 		emit dataChanged();
 	}
+	// the connections of a controller's own knobs decide which controllers it has to be
+	// evaluated after. Controller::addConnection() runs before this, so it can't see them.
+	if (qobject_cast<Controller*>(parent())) { Controller::updateEvaluationOrder(); }
 }
 
 
@@ -539,15 +568,39 @@ float AutomatableModel::controllerValue( int frameOffset ) const
 
 ValueBuffer * AutomatableModel::valueBuffer()
 {
-	QMutexLocker m( &m_valueBufferMutex );
+	const long period = s_periodCounter.load(std::memory_order_relaxed);
+
 	// if we've already calculated the valuebuffer this period, return the cached buffer
-	if( m_lastUpdatedPeriod == s_periodCounter )
+	if (m_lastUpdatedPeriod.load(std::memory_order_acquire) != period)
 	{
-		return m_hasSampleExactData
-			? &m_valueBuffer
-			: nullptr;
+		// The first thread to get here computes the buffer, all others wait until it is published.
+		// Waiting is rare and short, as it only happens if several threads read the model at once.
+		long claimed = m_claimedPeriod.load(std::memory_order_relaxed);
+		if (claimed != period && m_claimedPeriod.compare_exchange_strong(claimed, period, std::memory_order_acq_rel))
+		{
+			m_hasSampleExactData = updateValueBuffer();
+			m_lastUpdatedPeriod.store(period, std::memory_order_release);
+		}
+		else
+		{
+			while (m_lastUpdatedPeriod.load(std::memory_order_acquire) != period
+				&& s_periodCounter.load(std::memory_order_relaxed) == period)
+			{
+				std::this_thread::yield();
+			}
+		}
 	}
 
+	return m_hasSampleExactData
+		? &m_valueBuffer
+		: nullptr;
+}
+
+
+
+
+bool AutomatableModel::updateValueBuffer()
+{
 	float val = m_value; // make sure our m_value doesn't change midway
 
 	// TODO
@@ -577,13 +630,11 @@ ValueBuffer * AutomatableModel::valueBuffer()
 				}
 				break;
 			default:
-				qFatal("AutomatableModel::valueBuffer() "
+				qFatal("AutomatableModel::updateValueBuffer() "
 					"lacks implementation for a scale type");
 				break;
 			}
-			m_lastUpdatedPeriod = s_periodCounter;
-			m_hasSampleExactData = true;
-			return &m_valueBuffer;
+			return true;
 		}
 	}
 
@@ -602,9 +653,7 @@ ValueBuffer * AutomatableModel::valueBuffer()
 					{
 						nvalues[i] = fittedValue(values[i]);
 					}
-					m_lastUpdatedPeriod = s_periodCounter;
-					m_hasSampleExactData = true;
-					return &m_valueBuffer;
+					return true;
 				}
 		}
 	}
@@ -618,16 +667,12 @@ ValueBuffer * AutomatableModel::valueBuffer()
 	{
 		m_valueBuffer.interpolate(m_oldValue, val);
 		m_oldValue = val;
-		m_lastUpdatedPeriod = s_periodCounter;
-		m_hasSampleExactData = true;
-		return &m_valueBuffer;
+		return true;
 	}
 
-	// if we have no sample-exact source for a ValueBuffer, return NULL to signify that no data is available at the moment
+	// if we have no sample-exact source for a ValueBuffer, signify that no data is available at the moment
 	// in which case the recipient knows to use the static value() instead
-	m_lastUpdatedPeriod = s_periodCounter;
-	m_hasSampleExactData = false;
-	return nullptr;
+	return false;
 }
 
 
@@ -639,6 +684,7 @@ void AutomatableModel::unlinkControllerConnection()
 	}
 
 	m_controllerConnection = nullptr;
+	if (qobject_cast<Controller*>(parent())) { Controller::updateEvaluationOrder(); }
 }
 
 
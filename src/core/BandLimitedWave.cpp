@@ -26,11 +26,21 @@
 #include "BandLimitedWave.h"
 
 #include <QDataStream>
+#include <QFile>
+
+#include "WaveTableCache.h"
 
 namespace lmms
 {
 
-std::array<WaveMipMap, BandLimitedWave::NumWaveforms> BandLimitedWave::s_waveforms = {  };
+namespace
+{
+
+std::array<WaveMipMap, BandLimitedWave::NumWaveforms> s_generatedWaveforms = {  };
+
+}
+
+const WaveMipMap* BandLimitedWave::s_waveforms = s_generatedWaveforms.data();
 bool BandLimitedWave::s_wavesGenerated = false;
 QString BandLimitedWave::s_wavetableDir = "";
 
@@ -68,6 +78,18 @@ void BandLimitedWave::generateWaves()
 // don't generate if they already exist
 	if( s_wavesGenerated ) return;
 
+// use the tables from an earlier run if nothing changed
+	// Bump when changing how the waves are generated, to invalidate cached waves
+	constexpr std::uint64_t GeneratorVersion = 1;
+	const auto cacheKey = WaveTableCache::key( { GeneratorVersion, NumWaveforms, MAXTBL, MIPMAPSIZE, MIPMAPSIZE3, sizeof( sample_t ) } );
+	if( const auto cached = WaveTableCache::map( "bandlimited-waves", cacheKey, sizeof( s_generatedWaveforms ) ) )
+	{
+		s_waveforms = static_cast<const WaveMipMap*>( cached );
+		s_wavesGenerated = true;
+		return;
+	}
+
+	auto& waveforms = s_generatedWaveforms;
 
 	// set wavetable directory
 	s_wavetableDir = "data:wavetables/";
@@ -84,7 +106,7 @@ void BandLimitedWave::generateWaves()
 	{
 		saw_file.open( QIODevice::ReadOnly );
 		QDataStream in( &saw_file );
-		in >> s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)];
+		in >> waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)];
 		saw_file.close();
 	}
 	else
@@ -108,14 +130,14 @@ void BandLimitedWave::generateWaves()
 					s += amp * /*a2 **/ std::sin(static_cast<double>(ph * harm) / static_cast<double>(len) * 2 * pi_v<float>);
 					harm++;
 				} while( hlen > 2.0 );
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].setSampleAt( i, ph, s );
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].setSampleAt( i, ph, s );
 				max = std::max(max, std::abs(s));
 			}
 			// normalize
 			for( int ph = 0; ph < len; ph++ )
 			{
-				sample_t s = s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].sampleAt( i, ph ) / max;
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].setSampleAt( i, ph, s );
+				sample_t s = waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].sampleAt( i, ph ) / max;
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].setSampleAt( i, ph, s );
 			}
 		}
 	}
@@ -126,7 +148,7 @@ void BandLimitedWave::generateWaves()
 	{
 		sqr_file.open( QIODevice::ReadOnly );
 		QDataStream in( &sqr_file );
-		in >> s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)];
+		in >> waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)];
 		sqr_file.close();
 	}
 	else
@@ -150,14 +172,14 @@ void BandLimitedWave::generateWaves()
 					s += amp * /*a2 **/ std::sin(static_cast<double>(ph * harm) / static_cast<double>(len) * 2 * pi_v<float>);
 					harm += 2;
 				} while( hlen > 2.0 );
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)].setSampleAt( i, ph, s );
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)].setSampleAt( i, ph, s );
 				max = std::max(max, std::abs(s));
 			}
 			// normalize
 			for( int ph = 0; ph < len; ph++ )
 			{
-				sample_t s = s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)].sampleAt( i, ph ) / max;
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)].setSampleAt( i, ph, s );
+				sample_t s = waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)].sampleAt( i, ph ) / max;
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)].setSampleAt( i, ph, s );
 			}
 		}
 	}
@@ -167,7 +189,7 @@ void BandLimitedWave::generateWaves()
 	{
 		tri_file.open( QIODevice::ReadOnly );
 		QDataStream in( &tri_file );
-		in >> s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)];
+		in >> waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)];
 		tri_file.close();
 	}
 	else
@@ -192,14 +214,14 @@ void BandLimitedWave::generateWaves()
 							((harm + 1) % 4 == 0 ? 0.5 : 0.0)) * 2 * pi_v<float>);
 					harm += 2;
 				} while( hlen > 2.0 );
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].setSampleAt( i, ph, s );
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].setSampleAt( i, ph, s );
 				max = std::max(max, std::abs(s));
 			}
 			// normalize
 			for( int ph = 0; ph < len; ph++ )
 			{
-				sample_t s = s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].sampleAt( i, ph ) / max;
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].setSampleAt( i, ph, s );
+				sample_t s = waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].sampleAt( i, ph ) / max;
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].setSampleAt( i, ph, s );
 			}
 		}
 	}
@@ -210,7 +232,7 @@ void BandLimitedWave::generateWaves()
 	{
 		moog_file.open( QIODevice::ReadOnly );
 		QDataStream in( &moog_file );
-		in >> s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLMoog)];
+		in >> waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLMoog)];
 		moog_file.close();
 	}
 	else
@@ -222,15 +244,17 @@ void BandLimitedWave::generateWaves()
 			for( int ph = 0; ph < len; ph++ )
 			{
 				const int sawph = ( ph + static_cast<int>( len * 0.75 ) ) % len;
-				const sample_t saw = s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].sampleAt( i, sawph );
-				const sample_t tri = s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].sampleAt( i, ph );
-				s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLMoog)].setSampleAt( i, ph, ( saw + tri ) * 0.5f );
+				const sample_t saw = waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)].sampleAt( i, sawph );
+				const sample_t tri = waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)].sampleAt( i, ph );
+				waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLMoog)].setSampleAt( i, ph, ( saw + tri ) * 0.5f );
 			}
 		}
 	}
 
 // set the generated flag so we don't load/generate them again needlessly
 	s_wavesGenerated = true;
+	s_waveforms = waveforms.data();
+	WaveTableCache::store( "bandlimited-waves", cacheKey, waveforms.data(), sizeof( waveforms ) );
 
 
 // generate files, serialize mipmaps as QDataStreams and save them on disk
@@ -252,22 +276,22 @@ QFile moogfile( "path-to-wavetables/moog.bin" );
 
 sawfile.open( QIODevice::WriteOnly );
 QDataStream sawout( &sawfile );
-sawout << s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)];
+sawout << waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSaw)];
 sawfile.close();
 
 sqrfile.open( QIODevice::WriteOnly );
 QDataStream sqrout( &sqrfile );
-sqrout << s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)];
+sqrout << waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLSquare)];
 sqrfile.close();
 
 trifile.open( QIODevice::WriteOnly );
 QDataStream triout( &trifile );
-triout << s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)];
+triout << waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLTriangle)];
 trifile.close();
 
 moogfile.open( QIODevice::WriteOnly );
 QDataStream moogout( &moogfile );
-moogout << s_waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLMoog)];
+moogout << waveforms[static_cast<std::size_t>(BandLimitedWave::Waveform::BLMoog)];
 moogfile.close();
 
 */
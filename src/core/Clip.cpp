@@ -38,6 +38,10 @@
 namespace lmms
 {
 
+
+std::atomic<unsigned> Clip::s_layoutRevision = 0;
+
+
 /*! \brief Create a new Clip
  *
  *  Creates a new clip for the given track.
@@ -52,6 +56,7 @@ Clip::Clip( Track * track ) :
 	m_mutedModel( false, this, tr( "Mute" ) ),
 	m_selectViewOnCreate{false}
 {
+	connect(&m_mutedModel, &BoolModel::dataChanged, this, &Clip::invalidateLayout, Qt::DirectConnection);
 	if( getTrack() )
 	{
 		getTrack()->addClip( this );
@@ -81,6 +86,7 @@ Clip::Clip(const Clip& other):
 	m_selectViewOnCreate{other.m_selectViewOnCreate},
 	m_color(other.m_color)
 {
+	connect(&m_mutedModel, &BoolModel::dataChanged, this, &Clip::invalidateLayout, Qt::DirectConnection);
 	if (getTrack())
 	{
 		getTrack()->addClip(this);
@@ -119,6 +125,7 @@ void Clip::movePosition( const TimePos & pos )
 	{
 		Engine::audioEngine()->requestChangeInModel();
 		m_startPosition = newPos;
+		invalidateLayout();
 		Engine::audioEngine()->doneChangeInModel();
 		Engine::getSong()->updateLength();
 		emit positionChanged();
@@ -138,6 +145,7 @@ void Clip::movePosition( const TimePos & pos )
 void Clip::changeLength( const TimePos & length )
 {
 	m_length = length;
+	invalidateLayout();
 	Engine::getSong()->updateLength();
 	emit lengthChanged();
 }
@@ -220,6 +228,7 @@ TimePos Clip::startTimeOffset() const
 void Clip::setStartTimeOffset( const TimePos &startTimeOffset )
 {
 	m_startTimeOffset = startTimeOffset;
+	invalidateLayout();
 }
 
 void Clip::setColor(const std::optional<QColor>& color)
@@ -26,6 +26,7 @@
 
 #include <QDomElement>
 
+#include <unordered_set>
 #include <vector>
 
 #include "AudioEngine.h"
@@ -41,6 +42,20 @@ namespace lmms
 
 long Controller::s_periods = 0;
 std::vector<Controller*> Controller::s_controllers;
+ControllerVector Controller::s_evaluationOrder;
+
+
+namespace
+{
+
+//! Controllers may outlive the audio engine on shutdown, nothing renders then
+AudioEngine::RequestChangesGuard lockAudioEngine()
+{
+	const auto audioEngine = Engine::audioEngine();
+	return audioEngine ? audioEngine->requestChangesGuard() : AudioEngine::RequestChangesGuard{};
+}
+
+} // namespace
 
 
 
@@ -55,7 +70,11 @@ Controller::Controller( ControllerType _type, Model * _parent,
 {
 	if( _type != ControllerType::Dummy && _type != ControllerType::Midi )
 	{
-		s_controllers.push_back(this);
+		{
+			// the audio engine triggers all controllers every period
+			const auto guard = lockAudioEngine();
+			s_controllers.push_back(this);
+		}
 		// Determine which name to use
 		for ( uint i=s_controllers.size(); ; i++ )
 		{
@@ -86,10 +105,15 @@ Controller::Controller( ControllerType _type, Model * _parent,
 
 Controller::~Controller()
 {
-	auto it = std::find(s_controllers.begin(), s_controllers.end(), this);
-	if (it != s_controllers.end())
+	auto order = sortControllers(this);
 	{
-		s_controllers.erase(it);
+		const auto guard = lockAudioEngine();
+		auto it = std::find(s_controllers.begin(), s_controllers.end(), this);
+		if (it != s_controllers.end())
+		{
+			s_controllers.erase(it);
+		}
+		s_evaluationOrder.swap(order);
 	}
 
 	m_valueBuffer.clear();
@@ -171,6 +195,72 @@ void Controller::triggerFrameCounter()
 
 
 
+void Controller::updateControllers()
+{
+	for (Controller* controller : s_evaluationOrder)
+	{
+		if (controller->m_bufferLastUpdated != s_periods)
+		{
+			controller->updateValueBuffer();
+		}
+	}
+}
+
+
+
+ControllerVector Controller::dependencies() const
+{
+	ControllerVector result;
+	for (QObject* child : children())
+	{
+		const auto model = qobject_cast<AutomatableModel*>(child);
+		const auto connection = model ? model->controllerConnection() : nullptr;
+		if (connection && connection->getController()->connectionCount() > 0)
+		{
+			result.push_back(connection->getController());
+		}
+	}
+	return result;
+}
+
+
+
+ControllerVector Controller::sortControllers(const Controller* removed)
+{
+	auto order = ControllerVector{};
+	auto visited = std::unordered_set<const Controller*>{removed};
+
+	// depth first, so every controller follows the ones modulating it
+	const auto visit = [&](Controller* controller, auto& visit) -> void {
+		// visited already, or a cycle which the connection dialog should have prevented
+		if (!visited.insert(controller).second) { return; }
+
+		for (Controller* dependency : controller->dependencies())
+		{
+			visit(dependency, visit);
+		}
+		order.push_back(controller);
+	};
+
+	for (Controller* controller : s_controllers)
+	{
+		if (controller->connectionCount() > 0) { visit(controller, visit); }
+	}
+	return order;
+}
+
+
+
+void Controller::updateEvaluationOrder()
+{
+	// sorted here, so the audio thread neither allocates nor walks the models
+	auto order = sortControllers();
+	const auto guard = lockAudioEngine();
+	s_evaluationOrder.swap(order);
+}
+
+
+
 void Controller::resetFrameCounter()
 {
 	for (Controller * controller : s_controllers)
@@ -295,6 +385,7 @@ gui::ControllerDialog * Controller::createDialog( QWidget * _parent )
 void Controller::addConnection( ControllerConnection * )
 {
 	m_connectionCount++;
+	updateEvaluationOrder();
 }
 
 
@@ -304,6 +395,7 @@ void Controller::removeConnection( ControllerConnection * )
 {
 	m_connectionCount--;
 	Q_ASSERT( m_connectionCount >= 0 );
+	updateEvaluationOrder();
 }
 
 
@@ -27,9 +27,11 @@
 #include "DataFile.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <map>
 
+#include <QBuffer>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
@@ -37,6 +39,7 @@
 #include <QMessageBox>
 #include <QRegularExpression>
 #include <QSaveFile>
+#include <QXmlStreamReader>
 
 #include "base64.h"
 #include "ConfigManager.h"
@@ -47,6 +50,7 @@
 #include "LocaleHelper.h"
 #include "Note.h"
 #include "PluginFactory.h"
+#include "ProjectContainer.h"
 #include "ProjectVersion.h"
 #include "SongEditor.h"
 #include "TextFloat.h"
@@ -70,7 +74,7 @@ const DataFile::ResourcesMap DataFile::ELEMENTS_WITH_RESOURCES = {
 };
 
 // Vector with all the upgrade methods
-const std::vector<DataFile::UpgradeMethod> DataFile::UPGRADE_METHODS = {
+const std::vector<DataFile::Upgrade> DataFile::UPGRADE_METHODS = {
 	&DataFile::upgrade_0_2_1_20070501   ,   &DataFile::upgrade_0_2_1_20070508,
 	&DataFile::upgrade_0_3_0_rc2        ,   &DataFile::upgrade_0_3_0,
 	&DataFile::upgrade_0_4_0_20080104   ,   &DataFile::upgrade_0_4_0_20080118,
@@ -160,6 +164,16 @@ DataFile::DataFile( const QString & _fileName ) :
 	m_head(),
 	m_fileVersion( UPGRADE_METHODS.size() )
 {
+	if (auto container = ProjectContainer::open(_fileName))
+	{
+		m_container = std::move(container);
+		auto buffer = QBuffer{};
+		buffer.setData(m_container->xml());
+		buffer.open(QIODevice::ReadOnly);
+		loadData(buffer, _fileName);
+		return;
+	}
+
 	QFile inFile( _fileName );
 	if( !inFile.open( QIODevice::ReadOnly ) )
 	{
@@ -177,7 +191,7 @@ DataFile::DataFile( const QString & _fileName ) :
 		return;
 	}
 
-	loadData( inFile.readAll(), _fileName );
+	loadData(inFile, _fileName);
 }
 
 
@@ -190,7 +204,10 @@ DataFile::DataFile( const QByteArray & _data ) :
 	m_head(),
 	m_fileVersion( UPGRADE_METHODS.size() )
 {
-	loadData( _data, "<internal data>" );
+	auto buffer = QBuffer{};
+	buffer.setData(_data);
+	buffer.open(QIODevice::ReadOnly);
+	loadData(buffer, "<internal data>");
 }
 
 
@@ -202,7 +219,7 @@ bool DataFile::validate( QString extension )
 	switch( m_type )
 	{
 	case Type::SongProject:
-		if( extension == "mmp" || extension == "mmpz" )
+		if( extension == "mmp" || extension == "mmpz" || extension == "mmpc" )
 		{
 			return true;
 		}
@@ -226,7 +243,7 @@ bool DataFile::validate( QString extension )
 		}
 		break;
 	case Type::Unknown:
-		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" ||
+		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" || extension == "mmpc" ||
 				extension == "xpf" || extension == "xml" ||
 				( extension == "xiz" && ! getPluginFactory()->pluginSupportingExtension(extension).isNull()) ||
 				extension == "sf2" || extension == "sf3" || extension == "pat" || extension == "mid" ||
@@ -268,7 +285,8 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 		case Type::SongProject:
 			if( extension != "mmp" &&
 					extension != "mpt" &&
-					extension != "mmpz" )
+					extension != "mmpz" &&
+					extension != "mmpc" )
 			{
 				if( ConfigManager::inst()->value( "app",
 						"nommpz" ).toInt() == 0 )
@@ -298,7 +316,7 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 
 
 
-void DataFile::write( QTextStream & _strm )
+bool DataFile::write( QTextStream & _strm )
 {
 	if( type() == Type::SongProject || type() == Type::SongProjectTemplate
 					|| type() == Type::InstrumentTrackSettings )
@@ -306,7 +324,14 @@ void DataFile::write( QTextStream & _strm )
 		cleanMetaNodes( documentElement() );
 	}
 
+	// other files have to contain the samples themselves
+	if (m_container && !m_container->embedSamples(*this))
+	{
+		return false;
+	}
+
 	save(_strm, 2);
+	return true;
 }
 
 
@@ -401,18 +426,43 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 		return false;
 	}
 
+	bool written = true;
 	const QString extension = fullName.section('.', -1);
-	if (extension == "mmpz" || extension == "xptz")
+	if (extension == "mmpc")
+	{
+		// samples still embedded as Base64, e.g. when converting a .mmpz file, are moved into the container
+		const auto container = m_container ? m_container : std::make_shared<ProjectContainer>();
+		container->extractSamples(*this);
+
+		cleanMetaNodes(documentElement());
+		QString xml;
+		QTextStream ts(&xml);
+		save(ts, 2);
+		if (!container->write(outfile, xml.toUtf8()))
+		{
+			outfile.cancelWriting();
+		}
+	}
+	else if (extension == "mmpz" || extension == "xptz")
 	{
 		QString xml;
 		QTextStream ts( &xml );
-		write( ts );
-		outfile.write( qCompress( xml.toUtf8() ) );
+		written = write( ts );
+		if (written) { outfile.write( qCompress( xml.toUtf8() ) ); }
 	}
 	else
 	{
 		QTextStream ts( &outfile );
-		write( ts );
+		written = write( ts );
+	}
+
+	if (!written)
+	{
+		// the temporary file is discarded, so an existing file stays as it was
+		showError(SongEditor::tr("Could not write file"),
+			SongEditor::tr("The project contains a sample that is too large to be embedded into %1. "
+				"Please save it as a project container (.mmpc) instead.").arg(fullName));
+		return false;
 	}
 
 	if (!outfile.commit())
@@ -650,28 +700,19 @@ void DataFile::cleanMetaNodes( QDomElement _de )
 	}
 }
 
-void DataFile::mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map)
+void DataFile::mapSrcAttribute(QDomElement& element, const QMap<QString, QString>& map)
 {
-	for (const auto& [elem, srcAttrs] : ELEMENTS_WITH_RESOURCES)
+	const auto resource = ELEMENTS_WITH_RESOURCES.find(element.tagName());
+	if (resource == ELEMENTS_WITH_RESOURCES.end()) { return; }
+
+	for (const auto& srcAttr : resource->second)
 	{
-		auto elements = elementsByTagName(elem);
+		if (!element.hasAttribute(srcAttr)) { continue; }
 
-		for (const auto& srcAttr : srcAttrs)
+		const auto it = map.constFind(element.attribute(srcAttr));
+		if (it != map.constEnd())
 		{
-			for (int i = 0; i < elements.length(); ++i)
-			{
-				auto item = elements.item(i).toElement();
-
-				if (item.isNull() || !item.hasAttribute(srcAttr)) { continue; }
-
-				const QString srcVal = item.attribute(srcAttr);
-
-				const auto it = map.constFind(srcVal);
-				if (it != map.constEnd())
-				{
-					item.setAttribute(srcAttr, *it);
-				}
-			}
+			element.setAttribute(srcAttr, *it);
 		}
 	}
 }
@@ -1748,24 +1789,19 @@ void DataFile::upgrade_automationNodes()
 }
 
 // Convert the negative length notes to StepNotes
-void DataFile::upgrade_noteTypes()
+void DataFile::upgrade_noteTypes(QDomElement& element)
 {
-	const auto notes = elementsByTagName("note");
+	if (element.tagName() != "note") { return; }
 
-	for (int i = 0; i < notes.size(); ++i)
+	const auto noteSize = element.attribute("len").toInt();
+	if (noteSize < 0)
 	{
-		auto note = notes.item(i).toElement();
-
-		const auto noteSize = note.attribute("len").toInt();
-		if (noteSize < 0)
-		{
-			note.setAttribute("len", DefaultTicksPerBar / 16);
-			note.setAttribute("type", static_cast<int>(Note::Type::Step));
-		}
+		element.setAttribute("len", DefaultTicksPerBar / 16);
+		element.setAttribute("type", static_cast<int>(Note::Type::Step));
 	}
 }
 
-void DataFile::upgrade_fixCMTDelays()
+void DataFile::upgrade_fixCMTDelays(QDomElement& element)
 {
 	static const QMap<QString, QString> nameMap {
 		{ "delay_0,01s", "delay_0.01s" },
@@ -1774,31 +1810,20 @@ void DataFile::upgrade_fixCMTDelays()
 		{ "fbdelay_0,1s", "fbdelay_0.1s" }
 	};
 
-	const auto effects = elementsByTagName("effect");
+	// Check the value of the plugin attribute (XML) of all attributes (LMMS) ...
+	if (element.tagName() != "attribute" || element.attribute("name") != "plugin") { return; }
 
-	for (int i = 0; i < effects.size(); ++i)
-	{
-		auto effect = effects.item(i).toElement();
+	const auto it = nameMap.constFind(element.attribute("value"));
+	if (it == nameMap.constEnd()) { return; }
 
-		// We are only interested in LADSPA plugins
-		if (effect.attribute("name") != "ladspaeffect") { continue; }
-
-		// Fetch all attributes (LMMS) beneath the LADSPA effect so that we can check the value of the plugin attribute (XML)
-		auto attributes = effect.elementsByTagName("attribute");
-		for (int j = 0; j < attributes.size(); ++j)
+	// ... beneath a LADSPA effect, as we are only interested in LADSPA plugins
+	for (auto ancestor = element.parentNode().toElement(); !ancestor.isNull();
+		ancestor = ancestor.parentNode().toElement())
+	{
+		if (ancestor.tagName() == "effect" && ancestor.attribute("name") == "ladspaeffect")
 		{
-			auto attribute = attributes.item(j).toElement();
-
-			if (attribute.attribute("name") == "plugin")
-			{
-				const auto attributeValue = attribute.attribute("value");
-
-				const auto it = nameMap.constFind(attributeValue);
-				if (it != nameMap.constEnd())
-				{
-					attribute.setAttribute("value", *it);
-				}
-			}
+			element.setAttribute("value", *it);
+			return;
 		}
 	}
 }
@@ -1823,87 +1848,48 @@ void DataFile::upgrade_extendedNoteRange()
  * Older projects were made without this feature and would sound differently if loaded
  * with the new default setting. This upgrade routine preserves their old behavior.
  */
-void DataFile::upgrade_defaultTripleOscillatorHQ()
+void DataFile::upgrade_defaultTripleOscillatorHQ(QDomElement& element)
 {
-	QDomNodeList tripleoscillators = elementsByTagName("tripleoscillator");
-	for (int i = 0; !tripleoscillators.item(i).isNull(); i++)
+	if (element.tagName() != "tripleoscillator") { return; }
+
+	for (int j = 1; j <= 3; j++)
 	{
-		for (int j = 1; j <= 3; j++)
+		// Only set the attribute if it does not exist (default template has it but reports as 1.2.0)
+		if (element.attribute("useWaveTable" + QString::number(j)) == "")
 		{
-			// Only set the attribute if it does not exist (default template has it but reports as 1.2.0)
-			if (tripleoscillators.item(i).toElement().attribute("useWaveTable" + QString::number(j)) == "")
-			{
-				tripleoscillators.item(i).toElement().setAttribute("useWaveTable" + QString::number(j), 0);
-			}
+			element.setAttribute("useWaveTable" + QString::number(j), 0);
 		}
 	}
 }
 
 
 // Remove FX prefix from mixer and related nodes
-void DataFile::upgrade_mixerRename()
+void DataFile::upgrade_mixerRename(QDomElement& element)
 {
 	// Change nodename <fxmixer> to <mixer>
-	QDomNodeList fxmixer = elementsByTagName("fxmixer");
-	for (int i = 0; i < fxmixer.length(); ++i)
+	if (element.tagName() == "fxmixer")
 	{
-		auto item = fxmixer.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		item.setTagName("mixer");
+		element.setTagName("mixer");
 	}
-
 	// Change nodename <fxchannel> to <mixerchannel>
-	QDomNodeList fxchannel = elementsByTagName("fxchannel");
-	for (int i = 0; i < fxchannel.length(); ++i)
+	else if (element.tagName() == "fxchannel")
 	{
-		auto item = fxchannel.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		item.setTagName("mixerchannel");
+		element.setTagName("mixerchannel");
 	}
-
-	// Change the attribute fxch of element <instrumenttrack> to mixch
-	QDomNodeList fxch = elementsByTagName("instrumenttrack");
-	for (int i = 0; i < fxch.length(); ++i)
+	// Change the attribute fxch of elements <instrumenttrack> and <sampletrack> to mixch
+	else if ((element.tagName() == "instrumenttrack" || element.tagName() == "sampletrack")
+		&& element.hasAttribute("fxch"))
 	{
-		auto item = fxch.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		if (item.hasAttribute("fxch"))
-		{
-			item.setAttribute("mixch", item.attribute("fxch"));
-			item.removeAttribute("fxch");
-		}
-	}
-	// Change the attribute fxch of element <sampletrack> to mixch
-	fxch = elementsByTagName("sampletrack");
-	for (int i = 0; i < fxch.length(); ++i)
-	{
-		auto item = fxch.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		if (item.hasAttribute("fxch"))
-		{
-			item.setAttribute("mixch", item.attribute("fxch"));
-			item.removeAttribute("fxch");
-		}
+		element.setAttribute("mixch", element.attribute("fxch"));
+		element.removeAttribute("fxch");
 	}
 }
 
 
 // Rename BB to pattern and TCO to clip
-void DataFile::upgrade_bbTcoRename()
+void DataFile::upgrade_bbTcoRename(QDomElement& element)
 {
-	std::vector<std::pair<const char *, const char *>> names {
+	static const QMap<QString, QString> names {
 		{"automationpattern", "automationclip"},
 		{"bbtco", "patternclip"},
 		{"pattern", "midiclip"},
@@ -1912,41 +1898,30 @@ void DataFile::upgrade_bbTcoRename()
 		{"bbtrackcontainer", "patternstore"},
 	};
 	// Replace names of XML tags
-	for (auto name : names)
+	const auto it = names.constFind(element.tagName());
+	if (it != names.constEnd())
 	{
-		QDomNodeList elements = elementsByTagName(name.first);
-		for (int i = 0; !elements.item(i).isNull(); ++i)
-		{
-			elements.item(i).toElement().setTagName(name.second);
-		}
+		element.setTagName(*it);
 	}
 	// Replace "Beat/Bassline" with "Pattern" in track names
-	QDomNodeList elements = elementsByTagName("track");
-	for (int i = 0; !elements.item(i).isNull(); ++i)
+	else if (element.tagName() == "track")
 	{
-		auto e = elements.item(i).toElement();
 		static_assert(Track::Type::Pattern == static_cast<Track::Type>(1), "Must be type=1 for backwards compatibility");
-		if (static_cast<Track::Type>(e.attribute("type").toInt()) == Track::Type::Pattern)
+		if (static_cast<Track::Type>(element.attribute("type").toInt()) == Track::Type::Pattern)
 		{
-			e.setAttribute("name", e.attribute("name").replace("Beat/Bassline", "Pattern"));
+			element.setAttribute("name", element.attribute("name").replace("Beat/Bassline", "Pattern"));
 		}
 	}
 }
 
 
 // Set LFO speed to 0.01 on projects made before sample-and-hold PR
-void DataFile::upgrade_sampleAndHold()
+void DataFile::upgrade_sampleAndHold(QDomElement& element)
 {
-	QDomNodeList elements = elementsByTagName("lfocontroller");
-	for (int i = 0; i < elements.length(); ++i)
+	// Correct old random wave LFO speeds
+	if (element.tagName() == "lfocontroller" && element.attribute("wave").toInt() == 6)
 	{
-		if (elements.item(i).isNull()) { continue; }
-		auto e = elements.item(i).toElement();
-		// Correct old random wave LFO speeds
-		if (e.attribute("wave").toInt() == 6)
-		{
-			e.setAttribute("speed", 0.01f);
-		}
+		element.setAttribute("speed", 0.01f);
 	}
 }
 
@@ -2004,31 +1979,27 @@ static QMap<QString, QString> buildReplacementMap()
 }
 
 // Change loops' filenames in <sampleclip>s
-void DataFile::upgrade_loopsRename()
+void DataFile::upgrade_loopsRename(QDomElement& element)
 {
 	static const QMap<QString, QString> namesToNamesWithBPMsMap = buildReplacementMap();
 
-	mapSrcAttributeInElementsWithResources(namesToNamesWithBPMsMap);
+	mapSrcAttribute(element, namesToNamesWithBPMsMap);
 }
 
 //! Update MIDI CC indexes, so that they are counted from 0. Older releases of LMMS
 //! count the CCs from 1.
-void DataFile::upgrade_midiCCIndexing()
+void DataFile::upgrade_midiCCIndexing(QDomElement& element)
 {
 	static constexpr std::array attributesToUpdate{"inputcontroller", "outputcontroller"};
 
-	QDomNodeList elements = elementsByTagName("Midicontroller");
-	for(int i = 0; i < elements.length(); i++)
+	if (element.tagName() != "Midicontroller") { return; }
+
+	for (const char* attrName : attributesToUpdate)
 	{
-		if (elements.item(i).isNull()) { continue; }
-		auto element = elements.item(i).toElement();
-		for (const char* attrName : attributesToUpdate)
+		if (element.hasAttribute(attrName))
 		{
-			if (element.hasAttribute(attrName))
-			{
-				int cc = element.attribute(attrName).toInt();
-				element.setAttribute(attrName, cc - 1);
-			}
+			int cc = element.attribute(attrName).toInt();
+			element.setAttribute(attrName, cc - 1);
 		}
 	}
 }
@@ -2066,7 +2037,7 @@ void DataFile::findProblematicLadspaPlugins()
 	}
 }
 
-void DataFile::upgrade_fixBassLoopsTypo()
+void DataFile::upgrade_fixBassLoopsTypo(QDomElement& element)
 {
 	static const QMap<QString, QString> replacementMap = {
 		{ "bassloopes/briff01.ogg", "bassloops/briff01 - 140 BPM.ogg" },
@@ -2081,19 +2052,50 @@ void DataFile::upgrade_fixBassLoopsTypo()
 		{ "bassloopes/techno_synth04.ogg", "bassloops/techno_synth04 - 140 BPM.ogg" }
 	};
 
-	mapSrcAttributeInElementsWithResources(replacementMap);
+	mapSrcAttribute(element, replacementMap);
+}
+
+std::vector<DataFile::ElementUpgrade> DataFile::elementUpgrades(std::size_t from)
+{
+	auto upgrades = std::vector<ElementUpgrade>{};
+	for (auto it = UPGRADE_METHODS.begin() + std::min(from, UPGRADE_METHODS.size());
+		it != UPGRADE_METHODS.end() && it->element; ++it)
+	{
+		upgrades.push_back(it->element);
+	}
+	return upgrades;
+}
+
+static void upgradeElements(QDomElement element, const std::vector<void(*)(QDomElement&)>& upgrades)
+{
+	for (const auto upgrade : upgrades)
+	{
+		upgrade(element);
+	}
+	for (auto child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+	{
+		upgradeElements(child, upgrades);
+	}
 }
 
 void DataFile::upgrade()
 {
-	// Runs all necessary upgrade methods
-	std::size_t max = std::min(static_cast<std::size_t>(m_fileVersion), UPGRADE_METHODS.size());
-	std::for_each( UPGRADE_METHODS.begin() + max, UPGRADE_METHODS.end(),
-		[this](UpgradeMethod um)
+	// Runs all necessary upgrade methods. Consecutive element upgrades are
+	// done together, so the document is only walked once for all of them.
+	std::size_t index = std::min(static_cast<std::size_t>(m_fileVersion), UPGRADE_METHODS.size());
+	if (m_upgradedWhileParsing) { index += elementUpgrades(index).size(); }
+	while (index < UPGRADE_METHODS.size())
+	{
+		if (const auto method = UPGRADE_METHODS[index].method)
 		{
-			(this->*um)();
+			(this->*method)();
+			++index;
+			continue;
 		}
-	);
+		const auto upgrades = elementUpgrades(index);
+		upgradeElements(documentElement(), upgrades);
+		index += upgrades.size();
+	}
 
 	// Bump the file version (which should be the size of the upgrade methods vector)
 	m_fileVersion = UPGRADE_METHODS.size();
@@ -2125,57 +2127,179 @@ void DataFile::upgrade()
 
 
 
-void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
+bool DataFile::parse(QIODevice& input, QString& errorMsg, int& line, int& column)
 {
-	QString errorMsg;
-	int line = -1, col = -1;
-	if (!lmms::setContent(*this, _data, &errorMsg, &line, &col))
+	auto reader = QXmlStreamReader{&input};
+	reader.setNamespaceProcessing(false);
+
+	auto upgrades = std::vector<ElementUpgrade>{};
+	// The document itself while null, as its data is only created with the first node
+	QDomNode parent;
+	const auto append = [&](const QDomNode& node) {
+		return parent.isNull() ? appendChild(node) : parent.appendChild(node);
+	};
+
+	while (!reader.atEnd())
 	{
-		// parsing failed? then try to uncompress data
-		QByteArray uncompressed = qUncompress( _data );
-		if( !uncompressed.isEmpty() )
+		switch (reader.readNext())
 		{
-			if (lmms::setContent(*this, uncompressed, &errorMsg, &line, &col))
+		case QXmlStreamReader::StartDocument:
+			if (!reader.documentVersion().isEmpty())
 			{
-				line = col = -1;
+				appendChild(createProcessingInstruction("xml",
+					QString{"version=\"%1\""}.arg(reader.documentVersion().toString())));
 			}
+			break;
+		case QXmlStreamReader::DTD:
+		{
+			// Keep the declaration and the document type, in case the file is written again
+			const QDomNode declaration = firstChild();
+			QDomDocument::operator=(QDomDocument{reader.dtdName().toString()});
+			if (!declaration.isNull()) { appendChild(importNode(declaration, false)); }
+			break;
 		}
-		if( line >= 0 && col >= 0 )
+		case QXmlStreamReader::StartElement:
 		{
-			using gui::SongEditor;
+			QDomElement element = createElement(reader.qualifiedName().toString());
+			for (const auto& attribute : reader.attributes())
+			{
+				element.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+			}
+			const bool isRoot = parent.isNull();
+			append(element);
+
+			if (isRoot)
+			{
+				if (!element.hasAttribute("version") || element.attribute("version") == "1.0")
+				{
+					// The file versioning is now a unsigned int, not maj.min, so we use
+					// legacyFileVersion() to retrieve the appropriate version
+					m_fileVersion = legacyFileVersion();
+				}
+				else
+				{
+					bool success;
+					m_fileVersion = element.attribute("version").toUInt(&success);
+					if (!success) { qWarning("File Version conversion failure."); }
+				}
 
-			qWarning() << "at line" << line << "column" << errorMsg;
-			if (gui::getGUI() != nullptr)
+				// Now that the version is known, the leading element upgrades
+				// can be done while reading instead of in a separate pass
+				upgrades = elementUpgrades(m_fileVersion);
+				m_upgradedWhileParsing = !upgrades.empty();
+			}
+			for (const auto upgrade : upgrades)
 			{
-				QMessageBox::critical( nullptr,
-					SongEditor::tr( "Error in file" ),
-					SongEditor::tr( "The file %1 seems to contain "
-							"errors and therefore can't be "
-							"loaded." ).
-								arg( _sourceFile ) );
+				upgrade(element);
 			}
 
-			return;
+			parent = element;
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			parent = parent.parentNode().isDocument() ? QDomNode{} : parent.parentNode();
+			break;
+		case QXmlStreamReader::Characters:
+			if (reader.isCDATA())
+			{
+				append(createCDATASection(reader.text().toString()));
+			}
+			else if (!reader.isWhitespace())
+			{
+				append(createTextNode(reader.text().toString()));
+			}
+			break;
+		case QXmlStreamReader::Comment:
+			append(createComment(reader.text().toString()));
+			break;
+		case QXmlStreamReader::ProcessingInstruction:
+			append(createProcessingInstruction(reader.processingInstructionTarget().toString(),
+				reader.processingInstructionData().toString()));
+			break;
+		default:
+			break;
 		}
 	}
 
-	QDomElement root = documentElement();
-	m_type = type( root.attribute( "type" ) );
-	m_head = root.elementsByTagName( "head" ).item( 0 ).toElement();
+	if (reader.hasError())
+	{
+		errorMsg = reader.errorString();
+		line = static_cast<int>(reader.lineNumber());
+		column = static_cast<int>(reader.columnNumber());
+		return false;
+	}
+	return true;
+}
+
 
-	if (!root.hasAttribute("version") || root.attribute("version")=="1.0")
+//! Compressed files (mmpz) start with the uncompressed size followed by a zlib stream,
+//! while XML starts with the declaration or the root element, possibly after a byte order mark.
+//! This is only a guess, as the size may start with a byte that looks like XML.
+static bool isCompressed(QIODevice& input)
+{
+	for (const char c : input.peek(16))
 	{
-		// The file versioning is now a unsigned int, not maj.min, so we use
-		// legacyFileVersion() to retrieve the appropriate version
-		m_fileVersion = legacyFileVersion();
+		// UTF-8 and UTF-16 byte order marks
+		if (c == '<' || c == '\xEF' || c == '\xFE' || c == '\xFF') { return false; }
+		if (!std::isspace(static_cast<unsigned char>(c))) { return true; }
 	}
-	else
+	return false;
+}
+
+
+void DataFile::loadData(QIODevice& input, const QString& sourceFile)
+{
+	// The document is built while reading, so uncompressed files are never
+	// held in memory completely and compressed ones only until they are parsed
+	const auto parseCompressed = [this, &input](QString& errorMsg, int& line, int& col) {
+		auto buffer = QBuffer{};
+		buffer.setData(qUncompress(input.readAll()));
+		buffer.open(QIODevice::ReadOnly);
+		return parse(buffer, errorMsg, line, col);
+	};
+
+	QString errorMsg;
+	int line = -1, col = -1;
+	const qint64 start = input.pos();
+	const bool compressed = isCompressed(input);
+	bool success = compressed
+		? parseCompressed(errorMsg, line, col)
+		: parse(input, errorMsg, line, col);
+
+	if (!success && input.seek(start))
 	{
-		bool success;
-		m_fileVersion = root.attribute( "version" ).toUInt( &success );
-		if( !success ) qWarning("File Version conversion failure.");
+		// the guess may be wrong, but if both fail the error of the guessed format is reported
+		QString otherErrorMsg;
+		int otherLine = -1, otherCol = -1;
+		clear();
+		success = compressed
+			? parse(input, otherErrorMsg, otherLine, otherCol)
+			: parseCompressed(otherErrorMsg, otherLine, otherCol);
+	}
+
+	if (!success)
+	{
+		using gui::SongEditor;
+
+		clear();
+		qWarning() << "at line" << line << "column" << col << errorMsg;
+		if (gui::getGUI() != nullptr)
+		{
+			QMessageBox::critical( nullptr,
+				SongEditor::tr( "Error in file" ),
+				SongEditor::tr( "The file %1 seems to contain "
+						"errors and therefore can't be "
+						"loaded." ).
+							arg( sourceFile ) );
+		}
+
+		return;
 	}
 
+	QDomElement root = documentElement();
+	m_type = type( root.attribute( "type" ) );
+	m_head = root.elementsByTagName( "head" ).item( 0 ).toElement();
+
 	if (root.hasAttribute("creatorversion"))
 	{
 		using gui::SongEditor;
@@ -2188,7 +2312,7 @@ void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
 		 !=  openedWith.setCompareType(ProjectVersion::CompareType::Minor)
 		 && gui::getGUI() != nullptr && root.attribute("type") == "song"
 		){
-			auto projectType = _sourceFile.endsWith(".mpt") ?
+			auto projectType = sourceFile.endsWith(".mpt") ?
 				SongEditor::tr("template") : SongEditor::tr("project");
 
 			gui::TextFloat::displayMessage(
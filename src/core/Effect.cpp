@@ -23,6 +23,9 @@
  *
  */
 
+#include <cassert>
+#include <cmath>
+
 #include <QDomElement>
 
 #include "Effect.h"
@@ -31,12 +34,74 @@
 #include "EffectView.h"
 
 #include "ConfigManager.h"
+#include "OversamplingHelpers.h"
 #include "SampleFrame.h"
 
 namespace lmms
 {
 
 
+struct Effect::Oversampler
+{
+	std::array<Upsampler<MaxOversamplingStages>, DEFAULT_CHANNELS> upsamplers;
+	std::array<Downsampler<MaxOversamplingStages>, DEFAULT_CHANNELS> downsamplers;
+	//! Holds a whole period at the oversampled rate, so processing doesn't allocate
+	std::vector<SampleFrame> buffer;
+};
+
+
+namespace
+{
+
+/*
+ * In the past, the RMS was calculated then compared with a threshold of 10^(-10).
+ * Now we use a different algorithm to determine whether a buffer is non-quiet, so
+ * a new threshold is needed for the best compatibility. The following is how it's derived.
+ *
+ * Old method:
+ * RMS = average (L^2 + R^2) across stereo buffer.
+ * RMS threshold = 10^(-10)
+ *
+ * So for a single channel, it would be:
+ * RMS/2 = average M^2 across single channel buffer.
+ * RMS/2 threshold = 5^(-11)
+ *
+ * The new algorithm for determining whether a buffer is non-silent compares M with the threshold,
+ * not M^2, so the square root of M^2's threshold should give us the most compatible threshold for
+ * the new algorithm:
+ *
+ * (RMS/2)^0.5 = (5^(-11))^0.5 = 0.0001431 (approx.)
+ *
+ * In practice though, the exact value shouldn't really matter so long as it's sufficiently small.
+ */
+constexpr auto AutoQuitThreshold = 0.0001431f;
+
+//! Group delay at DC of an up- and downsampling chain, taken as the centroid of its impulse response
+float measureLatency(int stages, float sampleRate)
+{
+	constexpr int ResponseLength = 512;
+
+	auto upsampler = Upsampler<Effect::MaxOversamplingStages>{};
+	auto downsampler = Downsampler<Effect::MaxOversamplingStages>{};
+	upsampler.setup(stages, sampleRate);
+	downsampler.setup(stages, sampleRate);
+
+	auto samples = std::array<float, 1 << Effect::MaxOversamplingStages>{};
+	float sum = 0.f;
+	float weightedSum = 0.f;
+	for (int i = 0; i < ResponseLength; ++i)
+	{
+		upsampler.processSample(samples.data(), i == 0 ? 1.f : 0.f);
+		const float out = downsampler.processSample(samples.data());
+		sum += out;
+		weightedSum += i * out;
+	}
+	return sum != 0.f ? weightedSum / sum : 0.f;
+}
+
+} // namespace
+
+
 Effect::Effect( const Plugin::Descriptor * _desc,
 			Model * _parent,
 			const Descriptor::SubPluginFeatures::Key * _key ) :
@@ -48,6 +113,7 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	m_enabledModel( true, this, tr( "Effect enabled" ) ),
 	m_wetDryModel( 1.0f, -1.0f, 1.0f, 0.01f, this, tr( "Wet/Dry mix" ) ),
 	m_autoQuitModel( 1.0f, 1.0f, 8000.0f, 100.0f, 1.0f, this, tr( "Decay" ) ),
+	m_oversamplingModel(0, 0, MaxOversamplingStages, this, tr("Oversampling")),
 	m_autoQuitEnabled(ConfigManager::inst()->value("ui", "disableautoquit", "1").toInt() == 0)
 {
 	m_wetDryModel.setCenterValue(0);
@@ -55,13 +121,25 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	// Call the virtual method onEnabledChanged so that effects can react to changes,
 	// e.g. by resetting state.
 	connect(&m_enabledModel, &BoolModel::dataChanged, [this] { onEnabledChanged(); });
+
+	connect(&m_oversamplingModel, &IntModel::dataChanged, this, &Effect::updateOversampling);
+	connect(Engine::audioEngine(), &AudioEngine::sampleRateChanged, this, &Effect::updateOversampling);
 }
 
+
+
+
+Effect::~Effect() = default;
+
+
+
+
 void Effect::saveSettings( QDomDocument & _doc, QDomElement & _this )
 {
 	m_enabledModel.saveSettings( _doc, _this, "on" );
 	m_wetDryModel.saveSettings( _doc, _this, "wet" );
 	m_autoQuitModel.saveSettings( _doc, _this, "autoquit" );
+	m_oversamplingModel.saveSettings(_doc, _this, "oversampling");
 	controls()->saveState( _doc, _this );
 }
 
@@ -73,6 +151,7 @@ void Effect::loadSettings( const QDomElement & _this )
 	m_enabledModel.loadSettings( _this, "on" );
 	m_wetDryModel.loadSettings( _this, "wet" );
 	m_autoQuitModel.loadSettings( _this, "autoquit" );
+	m_oversamplingModel.loadSettings(_this, "oversampling");
 
 	QDomNode node = _this.firstChild();
 	while( !node.isNull() )
@@ -99,7 +178,7 @@ bool Effect::processAudioBuffer(SampleFrame* buf, const fpp_t frames)
 		return false;
 	}
 
-	const auto status = processImpl(buf, frames);
+	const auto status = m_oversampler ? processOversampled(buf, frames) : processImpl(buf, frames);
 	switch (status)
 	{
 		case ProcessStatus::Continue:
@@ -119,6 +198,35 @@ bool Effect::processAudioBuffer(SampleFrame* buf, const fpp_t frames)
 
 
 
+bool Effect::processAudioBuffer(PlanarBuffer::View buf)
+{
+	assert(isPlanar() && !m_oversampler);
+
+	if (!isOkay() || dontRun() || !isEnabled() || !isRunning())
+	{
+		processBypassedImpl();
+		return false;
+	}
+
+	switch (processPlanarImpl(buf))
+	{
+		case ProcessStatus::Continue:
+			break;
+		case ProcessStatus::ContinueIfNotQuiet:
+			handleAutoQuit(buf);
+			break;
+		case ProcessStatus::Sleep:
+			return false;
+		default:
+			break;
+	}
+
+	return isRunning();
+}
+
+
+
+
 Effect * Effect::instantiate( const QString& pluginName,
 				Model * _parent,
 				Descriptor::SubPluginFeatures::Key * _key )
@@ -149,36 +257,13 @@ void Effect::handleAutoQuit(std::span<const SampleFrame> output)
 		return;
 	}
 
-	/*
-	 * In the past, the RMS was calculated then compared with a threshold of 10^(-10).
-	 * Now we use a different algorithm to determine whether a buffer is non-quiet, so
-	 * a new threshold is needed for the best compatibility. The following is how it's derived.
-	 *
-	 * Old method:
-	 * RMS = average (L^2 + R^2) across stereo buffer.
-	 * RMS threshold = 10^(-10)
-	 *
-	 * So for a single channel, it would be:
-	 * RMS/2 = average M^2 across single channel buffer.
-	 * RMS/2 threshold = 5^(-11)
-	 *
-	 * The new algorithm for determining whether a buffer is non-silent compares M with the threshold,
-	 * not M^2, so the square root of M^2's threshold should give us the most compatible threshold for
-	 * the new algorithm:
-	 *
-	 * (RMS/2)^0.5 = (5^(-11))^0.5 = 0.0001431 (approx.)
-	 *
-	 * In practice though, the exact value shouldn't really matter so long as it's sufficiently small.
-	 */
-	static constexpr auto threshold = 0.0001431f;
-
 	// Check whether we need to continue processing input. Restart the
 	// counter if the threshold has been exceeded.
 
 	for (const SampleFrame& frame : output)
 	{
 		const auto abs = frame.abs();
-		if (abs.left() >= threshold || abs.right() >= threshold)
+		if (abs.left() >= AutoQuitThreshold || abs.right() >= AutoQuitThreshold)
 		{
 			// The output buffer is not quiet
 			m_quietBufferCount = 0;
@@ -186,6 +271,39 @@ void Effect::handleAutoQuit(std::span<const SampleFrame> output)
 		}
 	}
 
+	handleQuietBuffer();
+}
+
+
+
+
+void Effect::handleAutoQuit(PlanarBuffer::View output)
+{
+	if (!m_autoQuitEnabled)
+	{
+		return;
+	}
+
+	for (proc_ch_t ch = 0; ch < output.channels(); ++ch)
+	{
+		for (const float sample : output.buffer(ch))
+		{
+			if (std::abs(sample) >= AutoQuitThreshold)
+			{
+				m_quietBufferCount = 0;
+				return;
+			}
+		}
+	}
+
+	handleQuietBuffer();
+}
+
+
+
+
+void Effect::handleQuietBuffer()
+{
 	// The output buffer is quiet, so check if auto-quit should be activated yet
 	if (++m_quietBufferCount > timeout())
 	{
@@ -197,6 +315,76 @@ void Effect::handleAutoQuit(std::span<const SampleFrame> output)
 
 
 
+Effect::ProcessStatus Effect::processOversampled(SampleFrame* buf, const fpp_t frames)
+{
+	const int factor = oversamplingFactor();
+	auto& oversampler = *m_oversampler;
+	SampleFrame* oversampled = oversampler.buffer.data();
+	assert(frames * factor <= oversampler.buffer.size());
+
+	auto samples = std::array<float, 1 << MaxOversamplingStages>{};
+	for (fpp_t f = 0; f < frames; ++f)
+	{
+		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		{
+			oversampler.upsamplers[ch].processSample(samples.data(), buf[f][ch]);
+			for (int i = 0; i < factor; ++i)
+			{
+				oversampled[f * factor + i][ch] = samples[i];
+			}
+		}
+	}
+
+	const auto status = processImpl(oversampled, frames * factor);
+
+	for (fpp_t f = 0; f < frames; ++f)
+	{
+		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		{
+			for (int i = 0; i < factor; ++i)
+			{
+				samples[i] = oversampled[f * factor + i][ch];
+			}
+			buf[f][ch] = oversampler.downsamplers[ch].processSample(samples.data());
+		}
+	}
+
+	return status;
+}
+
+
+
+
+void Effect::updateOversampling()
+{
+	const int stages = supportsOversampling() ? m_oversamplingModel.value() : 0;
+	if (stages == 0 && !m_oversampler) { return; }
+
+	// set everything up before locking the engine, it only has to swap it in
+	auto oversampler = std::unique_ptr<Oversampler>{};
+	float latency = 0.f;
+	if (stages > 0)
+	{
+		const auto sampleRate = static_cast<float>(Engine::audioEngine()->outputSampleRate());
+		oversampler = std::make_unique<Oversampler>();
+		for (auto& upsampler : oversampler->upsamplers) { upsampler.setup(stages, sampleRate); }
+		for (auto& downsampler : oversampler->downsamplers) { downsampler.setup(stages, sampleRate); }
+		oversampler->buffer.resize(Engine::audioEngine()->framesPerPeriod() << stages);
+		latency = measureLatency(stages, sampleRate);
+	}
+
+	{
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		std::swap(m_oversampler, oversampler);
+		m_oversamplingStages = stages;
+		m_oversamplingLatency = latency;
+		onOversamplingChanged();
+	}
+}
+
+
+
+
 gui::PluginView * Effect::instantiateView( QWidget * _parent )
 {
 	return new gui::EffectView( this, _parent );
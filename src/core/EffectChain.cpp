@@ -25,6 +25,7 @@
 
 
 #include <QDomElement>
+#include <algorithm>
 #include <cassert>
 
 #include "EffectChain.h"
@@ -39,7 +40,8 @@ namespace lmms
 EffectChain::EffectChain( Model * _parent ) :
 	Model( _parent ),
 	SerializingObject(),
-	m_enabledModel( false, nullptr, tr( "Effects enabled" ) )
+	m_enabledModel( false, nullptr, tr( "Effects enabled" ) ),
+	m_planarBuffer(Engine::audioEngine()->framesPerPeriod())
 {
 }
 
@@ -191,18 +193,55 @@ bool EffectChain::processAudioBuffer( SampleFrame* _buf, const fpp_t _frames, bo
 		return false;
 	}
 
-	MixHelpers::sanitize( _buf, _frames );
+	// a silent buffer passed through sleeping effects stays silent
+	if (!hasInputNoise && !isRunning())
+	{
+		return false;
+	}
+
+	// silent input contains no infs/nans
+	if (hasInputNoise)
+	{
+		MixHelpers::sanitize( _buf, _frames );
+	}
+
+	const auto interleaved = std::span{_buf, _frames};
+	const auto planar = m_planarBuffer.view(_frames);
+	// convert only where planar and native effects meet
+	bool isPlanar = false;
 
 	bool moreEffects = false;
 	for (const auto& effect : m_effects)
 	{
-		if (hasInputNoise || effect->isRunning())
+		if (!hasInputNoise && !effect->isRunning()) { continue; }
+
+		if (effect->isPlanar())
+		{
+			if (!isPlanar)
+			{
+				m_planarBuffer.deinterleave(interleaved);
+				isPlanar = true;
+			}
+			moreEffects |= effect->processAudioBuffer(planar);
+			MixHelpers::sanitize(planar);
+		}
+		else
 		{
+			if (isPlanar)
+			{
+				m_planarBuffer.interleave(interleaved);
+				isPlanar = false;
+			}
 			moreEffects |= effect->processAudioBuffer(_buf, _frames);
 			MixHelpers::sanitize(_buf, _frames);
 		}
 	}
 
+	if (isPlanar)
+	{
+		m_planarBuffer.interleave(interleaved);
+	}
+
 	return moreEffects;
 }
 
@@ -225,6 +264,15 @@ void EffectChain::startRunning()
 
 
 
+bool EffectChain::isRunning() const
+{
+	return m_enabledModel.value()
+		&& std::any_of(m_effects.begin(), m_effects.end(), [](const Effect* effect) { return effect->isRunning(); });
+}
+
+
+
+
 void EffectChain::clear()
 {
 	emit aboutToClear();
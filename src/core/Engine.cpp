@@ -36,6 +36,7 @@
 #include "Song.h"
 #include "BandLimitedWave.h"
 #include "Oscillator.h"
+#include "WaveTableCache.h"
 
 namespace lmms
 {
@@ -118,6 +119,9 @@ void Engine::destroy()
 
 	delete ConfigManager::inst();
 
+	// Plans created since startup make the next one faster
+	WaveTableCache::saveFftwWisdom();
+
 	// The oscillator FFT plans remain throughout the application lifecycle
 	// due to being expensive to create, and being used whenever a userwave form is changed
 	Oscillator::destroyFFTPlans();
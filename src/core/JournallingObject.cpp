@@ -66,6 +66,14 @@ void JournallingObject::addJournalCheckPoint()
 
 
 
+std::unique_ptr<JournalDelta> JournallingObject::saveJournalDelta()
+{
+	return nullptr;
+}
+
+
+
+
 QDomElement JournallingObject::saveState( QDomDocument & _doc,
 							QDomElement & _parent )
 {
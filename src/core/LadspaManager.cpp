@@ -27,6 +27,7 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QJsonObject>
 #include <QLibrary>
 #include <QList>
 #include <QRegularExpression>
@@ -35,6 +36,7 @@
 
 #include "ConfigManager.h"
 #include "LadspaManager.h"
+#include "PluginCache.h"
 #include "PluginFactory.h"
 #include "lmms_constants.h"
 
@@ -64,6 +66,9 @@ LadspaManager::LadspaManager()
 	ladspaDirectories.push_back( "/Library/Audio/Plug-Ins/LADSPA" );
 #endif
 
+	// libraries known from the last run are only loaded once a plugin is used
+	PluginCache cache( "ladspa" );
+
 	for (const auto& ladspaDirectory : ladspaDirectories)
 	{
 		// Skip empty entries as QDir will interpret it as the working directory
@@ -91,6 +96,12 @@ LadspaManager::LadspaManager()
 				continue;
 			}
 
+			if( const auto cached = cache.find( f ) )
+			{
+				addCachedPlugins( cached->value( "plugins" ).toArray(), f );
+				continue;
+			}
+
 			QLibrary plugin_lib( f.absoluteFilePath() );
 
 			if( plugin_lib.load() == true )
@@ -98,8 +109,8 @@ LadspaManager::LadspaManager()
 				auto descriptorFunction = (LADSPA_Descriptor_Function)plugin_lib.resolve("ladspa_descriptor");
 				if( descriptorFunction != nullptr )
 				{
-					addPlugins( descriptorFunction,
-							f.fileName() );
+					cache.insert( f, QJsonObject{ { "plugins",
+						addPlugins( descriptorFunction, f ) } } );
 				}
 			}
 			else
@@ -142,45 +153,93 @@ LadspaManagerDescription * LadspaManager::getDescription(
 
 
 
-void LadspaManager::addPlugins(
+QJsonArray LadspaManager::addPlugins(
 		LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file )
+						const QFileInfo & _file )
 {
+	QJsonArray cacheEntry;
+
 	for (long pluginIndex = 0; const auto descriptor = _descriptor_func(pluginIndex); ++pluginIndex)
 	{
-		ladspa_key_t key( _file, QString( descriptor->Label ) );
-		if( m_ladspaManagerMap.contains( key ) )
-		{
-			continue;
-		}
-
 		auto plugIn = new LadspaManagerDescription;
 		plugIn->descriptorFunction = _descriptor_func;
+		plugIn->library = _file.absoluteFilePath();
 		plugIn->index = pluginIndex;
 		plugIn->inputChannels = getPluginInputs( descriptor );
 		plugIn->outputChannels = getPluginOutputs( descriptor );
+		plugIn->name = descriptor->Name;
+		plugIn->properties = descriptor->Properties;
+
+		cacheEntry.append( QJsonObject{
+			{ "label", descriptor->Label },
+			{ "name", plugIn->name },
+			{ "index", static_cast<int>( pluginIndex ) },
+			{ "inputs", plugIn->inputChannels },
+			{ "outputs", plugIn->outputChannels },
+			{ "properties", static_cast<int>( plugIn->properties ) }
+		} );
+
+		addPlugin( ladspa_key_t( _file.fileName(), QString( descriptor->Label ) ), plugIn );
+	}
 
-		if( plugIn->inputChannels == 0 && plugIn->outputChannels > 0 )
-		{
-			plugIn->type = LadspaPluginType::Source;
-		}
-		else if( plugIn->inputChannels > 0 &&
-				       plugIn->outputChannels > 0 )
-		{
-			plugIn->type = LadspaPluginType::Transfer;
-		}
-		else if( plugIn->inputChannels > 0 &&
-				       plugIn->outputChannels == 0 )
-		{
-			plugIn->type = LadspaPluginType::Sink;
-		}
-		else
-		{
-			plugIn->type = LadspaPluginType::Other;
-		}
+	return cacheEntry;
+}
+
+
+
+
+void LadspaManager::addCachedPlugins( const QJsonArray & _plugins,
+						const QFileInfo & _file )
+{
+	for( const auto& value : _plugins )
+	{
+		const QJsonObject entry = value.toObject();
+
+		auto plugIn = new LadspaManagerDescription;
+		plugIn->descriptorFunction = nullptr;
+		plugIn->library = _file.absoluteFilePath();
+		plugIn->index = entry.value( "index" ).toInt();
+		plugIn->inputChannels = entry.value( "inputs" ).toInt();
+		plugIn->outputChannels = entry.value( "outputs" ).toInt();
+		plugIn->name = entry.value( "name" ).toString();
+		plugIn->properties = entry.value( "properties" ).toInt();
+
+		addPlugin( ladspa_key_t( _file.fileName(), entry.value( "label" ).toString() ), plugIn );
+	}
+}
+
+
+
+
+void LadspaManager::addPlugin( const ladspa_key_t & _key,
+					LadspaManagerDescription * _plugin )
+{
+	if( m_ladspaManagerMap.contains( _key ) )
+	{
+		delete _plugin;
+		return;
+	}
 
-		m_ladspaManagerMap[key] = plugIn;
+	if( _plugin->inputChannels == 0 && _plugin->outputChannels > 0 )
+	{
+		_plugin->type = LadspaPluginType::Source;
+	}
+	else if( _plugin->inputChannels > 0 &&
+			       _plugin->outputChannels > 0 )
+	{
+		_plugin->type = LadspaPluginType::Transfer;
+	}
+	else if( _plugin->inputChannels > 0 &&
+			       _plugin->outputChannels == 0 )
+	{
+		_plugin->type = LadspaPluginType::Sink;
+	}
+	else
+	{
+		_plugin->type = LadspaPluginType::Other;
 	}
+
+	m_ladspaManagerMap[_key] = _plugin;
 }
 
 
@@ -278,8 +337,8 @@ QString LadspaManager::getLabel( const ladspa_key_t & _plugin )
 bool LadspaManager::hasRealTimeDependency(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_REALTIME( descriptor->Properties )
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? LADSPA_IS_REALTIME( description->properties )
 					   : false );
 }
 
@@ -288,8 +347,8 @@ bool LadspaManager::hasRealTimeDependency(
 
 bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_INPLACE_BROKEN( descriptor->Properties )
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? LADSPA_IS_INPLACE_BROKEN( description->properties )
 					   : false );
 }
 
@@ -299,8 +358,8 @@ bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 bool LadspaManager::isRealTimeCapable(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_HARD_RT_CAPABLE( descriptor->Properties )
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? LADSPA_IS_HARD_RT_CAPABLE( description->properties )
 					   : false );
 }
 
@@ -309,8 +368,8 @@ bool LadspaManager::isRealTimeCapable(
 
 QString LadspaManager::getName( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Name : "" );
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? description->name : "" );
 }
 
 
@@ -567,6 +626,23 @@ const LADSPA_Descriptor * LadspaManager::getDescriptor(const ladspa_key_t & _plu
 	{
 		auto const plugin = *it;
 
+		if( plugin->descriptorFunction == nullptr )
+		{
+			// the plugin was listed from the cache, load it now
+			QLibrary library( plugin->library );
+			if( !library.load() )
+			{
+				qWarning() << library.errorString();
+				return nullptr;
+			}
+			plugin->descriptorFunction = reinterpret_cast<LADSPA_Descriptor_Function>(
+								library.resolve( "ladspa_descriptor" ) );
+			if( plugin->descriptorFunction == nullptr )
+			{
+				return nullptr;
+			}
+		}
+
 		LADSPA_Descriptor_Function descriptorFunction = plugin->descriptorFunction;
 		const LADSPA_Descriptor* descriptor = descriptorFunction(plugin->index);
 
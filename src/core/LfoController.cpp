@@ -25,6 +25,8 @@
 
 #include "LfoController.h"
 
+#include <algorithm>
+
 #include <QDomElement>
 #include <QFileInfo>
 
@@ -36,6 +38,51 @@
 namespace lmms
 {
 
+namespace
+{
+
+//! Frames between the points of slow, smooth waves that are computed exactly
+constexpr auto ControlInterval = std::size_t{32};
+//! Fewer points per cycle would round off the wave noticeably
+constexpr auto MinControlPointsPerCycle = 64.f;
+
+template<class Wave>
+void renderWave(float* out, std::size_t frames, float phase, float increment, Wave wave)
+{
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		out[f] = wave(phase + f * increment);
+	}
+}
+
+//! Computes the wave every ControlInterval frames only, and interpolates linearly in between
+template<class Wave>
+void renderWaveAtControlRate(float* out, std::size_t frames, float phase, float increment, Wave wave)
+{
+	float previous = wave(phase);
+	for (std::size_t start = 0; start < frames; start += ControlInterval)
+	{
+		const float next = wave(phase + (start + ControlInterval) * increment);
+		const float step = (next - previous) / ControlInterval;
+		const std::size_t end = std::min(start + ControlInterval, frames);
+		for (std::size_t f = start; f < end; ++f)
+		{
+			out[f] = previous + step * (f - start);
+		}
+		previous = next;
+	}
+}
+
+template<class Wave>
+void renderSmoothWave(float* out, std::size_t frames, float phase, float increment, Wave wave, bool controlRate)
+{
+	if (controlRate) { renderWaveAtControlRate(out, frames, phase, increment, wave); }
+	else { renderWave(out, frames, phase, increment, wave); }
+}
+
+} // namespace
+
+
 
 LfoController::LfoController( Model * _parent ) :
 	Controller( ControllerType::Lfo, _parent, tr( "LFO Controller" ) ),
@@ -49,12 +96,9 @@ LfoController::LfoController( Model * _parent ) :
 	m_duration( 1000 ),
 	m_phaseOffset( 0 ),
 	m_currentPhase( 0 ),
-	m_sampleFunction( &Oscillator::sinSample ),
 	m_userDefSampleBuffer(std::make_shared<SampleBuffer>())
 {
 	setSampleExact( true );
-	connect( &m_waveModel, SIGNAL(dataChanged()),
-			this, SLOT(updateSampleFunction()), Qt::DirectConnection );
 
 	connect( &m_speedModel, SIGNAL(dataChanged()),
 			this, SLOT(updateDuration()), Qt::DirectConnection );
@@ -85,11 +129,13 @@ LfoController::~LfoController()
 }
 
 
+
+
+
 void LfoController::updateValueBuffer()
 {
 	m_phaseOffset = m_phaseModel.value() / 360.0;
 	float phase = m_currentPhase + m_phaseOffset;
-	float phasePrev = 0.0f;
 
 	// roll phase up until we're in sync with period counter
 	m_bufferLastUpdated++;
@@ -100,49 +146,81 @@ void LfoController::updateValueBuffer()
 		m_bufferLastUpdated += diff;
 	}
 
-	float amount = m_amountModel.value();
-	ValueBuffer *amountBuffer = m_amountModel.valueBuffer();
-	int amountInc = amountBuffer ? 1 : 0;
-	float *amountPtr = amountBuffer ? &(amountBuffer->values()[ 0 ] ) : &amount;
-	Oscillator::WaveShape waveshape = static_cast<Oscillator::WaveShape>(m_waveModel.value());
+	float* values = m_valueBuffer.values();
+	const auto frames = static_cast<std::size_t>(m_valueBuffer.length());
+	const float increment = 1.0f / m_duration;
+	const bool controlRate = m_duration >= ControlInterval * MinControlPointsPerCycle;
 
-	for( float& f : m_valueBuffer )
+	// render the bare wave first, choosing the shape once instead of per sample
+	switch (static_cast<Oscillator::WaveShape>(m_waveModel.value()))
 	{
-		float currentSample = 0;
-		switch (waveshape)
-		{
-		case Oscillator::WaveShape::WhiteNoise:
+	case Oscillator::WaveShape::Sine:
+		renderSmoothWave(values, frames, phase, increment, [](float p) { return Oscillator::sinSample(p); }, controlRate);
+		break;
+	case Oscillator::WaveShape::Triangle:
+		renderSmoothWave(values, frames, phase, increment, [](float p) { return Oscillator::triangleSample(p); }, controlRate);
+		break;
+	case Oscillator::WaveShape::Exponential:
+		renderSmoothWave(values, frames, phase, increment, [](float p) { return Oscillator::expSample(p); }, controlRate);
+		break;
+	// these jump, which interpolation would smear
+	case Oscillator::WaveShape::Saw:
+		renderWave(values, frames, phase, increment, [](float p) { return Oscillator::sawSample(p); });
+		break;
+	case Oscillator::WaveShape::Square:
+		renderWave(values, frames, phase, increment, [](float p) { return Oscillator::squareSample(p); });
+		break;
+	case Oscillator::WaveShape::MoogSaw:
+		renderWave(values, frames, phase, increment, [](float p) { return Oscillator::moogSawSample(p); });
+		break;
+	case Oscillator::WaveShape::UserDefined:
+	{
+		const SampleBuffer* buffer = m_userDefSampleBuffer.get();
+		renderWave(values, frames, phase, increment,
+			[buffer](float p) { return Oscillator::userWaveSample(buffer, p); });
+		break;
+	}
+	case Oscillator::WaveShape::WhiteNoise:
+	{
+		float phasePrev = 0.0f;
+		for (std::size_t f = 0; f < frames; ++f)
 		{
-			if (absFraction(phase) < absFraction(phasePrev))
+			const float p = phase + f * increment;
+			if (absFraction(p) < absFraction(phasePrev))
 			{
 				// Resample when phase period has completed
-				m_heldSample = m_sampleFunction(phase);
+				m_heldSample = Oscillator::noiseSample(p);
 			}
-			currentSample = m_heldSample;
-			break;
+			values[f] = m_heldSample;
+			phasePrev = p;
 		}
-		case Oscillator::WaveShape::UserDefined:
+		break;
+	}
+	default:
+		std::fill_n(values, frames, 0.f);
+		break;
+	}
+
+	// then scale and offset it in one pass
+	const float base = m_baseModel.value();
+	if (const ValueBuffer* amountBuffer = m_amountModel.valueBuffer())
+	{
+		const float* amount = amountBuffer->values();
+		for (std::size_t f = 0; f < frames; ++f)
 		{
-			currentSample = Oscillator::userWaveSample(m_userDefSampleBuffer.get(), phase);
-			break;
+			values[f] = std::clamp(base + amount[f] * values[f] / 2.0f, 0.0f, 1.0f);
 		}
-		default:
+	}
+	else
+	{
+		const float amount = m_amountModel.value();
+		for (std::size_t f = 0; f < frames; ++f)
 		{
-			if (m_sampleFunction != nullptr)
-			{
-				currentSample = m_sampleFunction(phase);
-			}
+			values[f] = std::clamp(base + amount * values[f] / 2.0f, 0.0f, 1.0f);
 		}
 	}
 
-		f = std::clamp(m_baseModel.value() + (*amountPtr * currentSample / 2.0f), 0.0f, 1.0f);
-
-		phasePrev = phase;
-		phase += 1.0 / m_duration;
-		amountPtr += amountInc;
-	}
-
-	m_currentPhase = absFraction(phase - m_phaseOffset);
+	m_currentPhase = absFraction(phase + frames * increment - m_phaseOffset);
 	m_bufferLastUpdated = s_periods;
 }
 
@@ -174,43 +252,6 @@ void LfoController::updateDuration()
 	m_duration = newDurationF;
 }
 
-void LfoController::updateSampleFunction()
-{
-	switch( static_cast<Oscillator::WaveShape>(m_waveModel.value()) )
-	{
-		case Oscillator::WaveShape::Sine:
-		default:
-			m_sampleFunction = &Oscillator::sinSample;
-			break;
-		case Oscillator::WaveShape::Triangle:
-			m_sampleFunction = &Oscillator::triangleSample;
-			break;
-		case Oscillator::WaveShape::Saw:
-			m_sampleFunction = &Oscillator::sawSample;
-			break;
-		case Oscillator::WaveShape::Square:
-			m_sampleFunction = &Oscillator::squareSample;
-			break;
-		case Oscillator::WaveShape::MoogSaw:
-			m_sampleFunction = &Oscillator::moogSawSample;
-			break;
-		case Oscillator::WaveShape::Exponential:
-			m_sampleFunction = &Oscillator::expSample;
-			break;
-		case Oscillator::WaveShape::WhiteNoise:
-			m_sampleFunction = &Oscillator::noiseSample;
-			break;
-		case Oscillator::WaveShape::UserDefined:
-			m_sampleFunction = nullptr;
-			/*TODO: If C++11 is allowed, should change the type of
-			 m_sampleFunction be std::function<sample_t(const float)>
-			 and use the line below:
-			*/
-			//m_sampleFunction = &(m_userDefSampleBuffer->userWaveSample)
-			break;
-	}
-}
-
 
 
 void LfoController::saveSettings( QDomDocument & _doc, QDomElement & _this )
@@ -247,8 +288,6 @@ void LfoController::loadSettings( const QDomElement & _this )
 		}
 		else { Engine::getSong()->collectError(QString("%1: %2").arg(tr("Sample not found"), userWaveFile)); }
 	}
-
-	updateSampleFunction();
 }
 
 
@@ -28,6 +28,7 @@
 #include <cstdio>
 #endif
 
+#include <algorithm>
 #include <cmath>
 
 #include "ValueBuffer.h"
@@ -124,6 +125,34 @@ bool sanitize( SampleFrame* src, int frames )
 }
 
 
+bool sanitize(PlanarBufferView<float, DEFAULT_CHANNELS> buffer)
+{
+	if (!useNaNHandler())
+	{
+		return false;
+	}
+
+	for (proc_ch_t ch = 0; ch < buffer.channels(); ++ch)
+	{
+		for (float& sample : buffer.buffer(ch))
+		{
+			if (std::isinf(sample) || std::isnan(sample))
+			{
+				// Clear the whole buffer if a problem is found
+				for (proc_ch_t other = 0; other < buffer.channels(); ++other)
+				{
+					std::ranges::fill(buffer.buffer(other), 0.f);
+				}
+				return true;
+			}
+			sample = std::clamp(sample, -1000.f, 1000.f);
+		}
+	}
+
+	return false;
+}
+
+
 struct AddOp
 {
 	void operator()( SampleFrame& dst, const SampleFrame& src ) const
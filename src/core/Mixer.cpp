@@ -23,6 +23,7 @@
  */
 
 #include <QDomElement>
+#include <QTimer>
 
 #include "AudioEngine.h"
 #include "AudioEngineWorkerThread.h"
@@ -61,6 +62,7 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_fxChain( nullptr ),
 	m_hasInput( false ),
 	m_stillRunning( false ),
+	m_hasOutput( false ),
 	m_peakLeft( 0.0f ),
 	m_peakRight( 0.0f ),
 	m_buffer( new SampleFrame[Engine::audioEngine()->framesPerPeriod()] ),
@@ -70,8 +72,11 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_name(),
 	m_lock(),
 	m_queued( false ),
+	m_routing(nullptr),
 	m_dependenciesMet(0),
-	m_channelIndex(idx)
+	m_channelIndex(idx),
+	m_meterVolume(1.f),
+	m_meterSubscription(0)
 {
 	zeroSampleFrames(m_buffer, Engine::audioEngine()->framesPerPeriod());
 }
@@ -81,25 +86,43 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 
 MixerChannel::~MixerChannel()
 {
+	setMetered(false);
 	delete[] m_buffer;
 }
 
 
 inline void MixerChannel::processed()
 {
-	for( const MixerRoute * receiverRoute : m_sends )
+	for (MixerChannel* receiver : m_routing->receivers)
 	{
-		if( receiverRoute->receiver()->m_muted == false )
+		if( receiver->m_muted == false )
 		{
-			receiverRoute->receiver()->incrementDeps();
+			receiver->incrementDeps();
 		}
 	}
 }
 
+void MixerChannel::setMetered(bool metered)
+{
+	if (metered && m_meterSubscription == 0)
+	{
+		m_meterSubscription = Engine::audioEngine()->tapService()->subscribe(m_tap, [this](const AudioTap::Analysis& analysis) {
+			const float v = m_meterVolume.load(std::memory_order_relaxed);
+			m_peakLeft = std::max(m_peakLeft, analysis.peak.left() * v);
+			m_peakRight = std::max(m_peakRight, analysis.peak.right() * v);
+		});
+	}
+	else if (!metered && m_meterSubscription != 0)
+	{
+		Engine::audioEngine()->tapService()->unsubscribe(m_meterSubscription);
+		m_meterSubscription = 0;
+	}
+}
+
 void MixerChannel::incrementDeps()
 {
 	const auto i = m_dependenciesMet++ + 1;
-	if( i >= m_receives.size() && ! m_queued )
+	if( i >= m_routing->receives.size() && ! m_queued )
 	{
 		m_queued = true;
 		AudioEngineWorkerThread::addJob( this );
@@ -167,13 +190,13 @@ void MixerChannel::doProcessing()
 
 	if( m_muted == false )
 	{
-		for( MixerRoute * senderRoute : m_receives )
+		for( MixerRoute * senderRoute : m_routing->receives )
 		{
 			MixerChannel * sender = senderRoute->sender();
 			FloatModel * sendModel = senderRoute->amount();
 			if( ! sendModel ) qFatal( "Error: no send model found from %d to %d", senderRoute->senderIndex(), m_channelIndex );
 
-			if( sender->m_hasInput || sender->m_stillRunning )
+			if( sender->m_hasOutput )
 			{
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
@@ -215,11 +238,21 @@ void MixerChannel::doProcessing()
 			m_fxChain.startRunning();
 		}
 
-		m_stillRunning = m_fxChain.processAudioBuffer( m_buffer, fpp, m_hasInput );
+		// without input and effect tails the buffer is still silent,
+		// so there is nothing to process or meter
+		if( m_hasInput || m_fxChain.isRunning() )
+		{
+			m_stillRunning = m_fxChain.processAudioBuffer( m_buffer, fpp, m_hasInput );
+			m_hasOutput = true;
 
-		SampleFrame peakSamples = getAbsPeakValues(m_buffer, fpp);
-		m_peakLeft = std::max(m_peakLeft, peakSamples[0] * v);
-		m_peakRight = std::max(m_peakRight, peakSamples[1] * v);
+			// the peaks are computed off the audio thread, and only if anybody looks at them
+			m_meterVolume.store(v, std::memory_order_relaxed);
+			m_tap.publish(m_buffer, fpp);
+		}
+		else
+		{
+			m_stillRunning = false;
+		}
 	}
 	else
 	{
@@ -236,7 +269,11 @@ Mixer::Mixer() :
 	Model( nullptr ),
 	JournallingObject(),
 	m_mixerChannels(),
-	m_lastSoloed(-1)
+	m_routing(new MixerRouting),
+	m_activeRouting(nullptr),
+	m_lastSoloed(-1),
+	m_metered(false),
+	m_reclaimScheduled(false)
 {
 	// create master channel
 	createChannel();
@@ -256,6 +293,10 @@ Mixer::~Mixer()
 		m_mixerChannels.pop_back();
 		delete f;
 	}
+
+	// the audio engine has stopped processing, so nothing uses the routings anymore
+	reclaimRoutings();
+	delete m_routing.load();
 }
 
 
@@ -265,6 +306,8 @@ int Mixer::createChannel()
 	const int index = m_mixerChannels.size();
 	// create new channel
 	m_mixerChannels.push_back( new MixerChannel( index, this ) );
+	m_mixerChannels[index]->setMetered(m_metered);
+	publishRouting();
 
 	// reset channel state
 	clearChannel( index );
@@ -279,6 +322,15 @@ int Mixer::createChannel()
 	return index;
 }
 
+void Mixer::setMetered(bool metered)
+{
+	m_metered = metered;
+	for (const auto& channel : m_mixerChannels)
+	{
+		channel->setMetered(metered);
+	}
+}
+
 void Mixer::activateSolo()
 {
 	for (auto i = std::size_t{1}; i < m_mixerChannels.size(); ++i)
@@ -333,9 +385,6 @@ void Mixer::toggledSolo()
 
 void Mixer::deleteChannel( int index )
 {
-	// channel deletion is performed between mixer rounds
-	Engine::audioEngine()->requestChangeInModel();
-
 	// go through every instrument and adjust for the channel index change
 	TrackContainer::TrackList tracks;
 
@@ -397,9 +446,10 @@ void Mixer::deleteChannel( int index )
 	// if m_lastSoloed is > delete index, it will move left
 	else if (m_lastSoloed > index) { --m_lastSoloed; }
 
-	// actually delete the channel
+	// actually remove the channel. The audio thread may use it until the end of
+	// the current period, so it is deleted later on (see reclaimRoutings())
 	m_mixerChannels.erase(m_mixerChannels.begin() + index);
-	delete ch;
+	m_removedChannels.push_back(ch);
 
 	for (auto i = static_cast<std::size_t>(index); i < m_mixerChannels.size(); ++i)
 	{
@@ -419,7 +469,7 @@ void Mixer::deleteChannel( int index )
 		}
 	}
 
-	Engine::audioEngine()->doneChangeInModel();
+	publishRouting();
 }
 
 
@@ -481,6 +531,8 @@ void Mixer::moveChannelLeft( int index )
 	// Update m_channelIndex of both channels
 	m_mixerChannels[index]->setIndex(index);
 	m_mixerChannels[index - 1]->setIndex(index - 1);
+
+	publishRouting();
 }
 
 
@@ -521,7 +573,6 @@ MixerRoute * Mixer::createRoute( MixerChannel * from, MixerChannel * to, float a
 	{
 		return nullptr;
 	}
-	Engine::audioEngine()->requestChangeInModel();
 	auto route = new MixerRoute(from, to, amount);
 
 	// add us to from's sends
@@ -532,7 +583,8 @@ MixerRoute * Mixer::createRoute( MixerChannel * from, MixerChannel * to, float a
 
 	// add us to mixer's list
 	Engine::mixer()->m_mixerRoutes.push_back(route);
-	Engine::audioEngine()->doneChangeInModel();
+
+	publishRouting();
 
 	return route;
 }
@@ -559,8 +611,6 @@ void Mixer::deleteChannelSend( mix_ch_t fromChannel, mix_ch_t toChannel )
 
 void Mixer::deleteChannelSend( MixerRoute * route )
 {
-	Engine::audioEngine()->requestChangeInModel();
-
 	auto removeFromMixerRoute = [route](MixerRouteVector& routeVec)
 	{
 		auto it = std::find(routeVec.begin(), routeVec.end(), route);
@@ -576,8 +626,8 @@ void Mixer::deleteChannelSend( MixerRoute * route )
 	// remove us from mixer's list
 	removeFromMixerRoute(Engine::mixer()->m_mixerRoutes);
 
-	delete route;
-	Engine::audioEngine()->doneChangeInModel();
+	m_removedRoutes.push_back(route);
+	publishRouting();
 }
 
 
@@ -644,7 +694,10 @@ FloatModel * Mixer::channelSendModel( mix_ch_t fromChannel, mix_ch_t toChannel )
 
 void Mixer::mixToChannel( const SampleFrame* _buf, mix_ch_t _ch )
 {
-	const auto channel = m_mixerChannels[_ch];
+	const MixerRouting* routing = m_activeRouting.load(std::memory_order_relaxed);
+	if (static_cast<std::size_t>(_ch) >= routing->channels.size()) { return; }
+
+	const auto channel = routing->channels[_ch].channel;
 	if (!channel->m_muteModel.value())
 	{
 		channel->m_lock.lock();
@@ -657,16 +710,11 @@ void Mixer::mixToChannel( const SampleFrame* _buf, mix_ch_t _ch )
 
 
 
-void Mixer::prepareMasterMix()
-{
-	zeroSampleFrames(m_mixerChannels[0]->m_buffer, Engine::audioEngine()->framesPerPeriod());
-}
-
-
-
-void Mixer::masterMix( SampleFrame* _buf )
+bool Mixer::masterMix( SampleFrame* _buf )
 {
 	const int fpp = Engine::audioEngine()->framesPerPeriod();
+	const MixerRouting* routing = m_activeRouting.load(std::memory_order_relaxed);
+	MixerChannel* master = routing->channels[0].channel;
 
 	// add the channels that have no dependencies (no incoming senders, ie.
 	// no receives) to the jobqueue. The channels that have receives get
@@ -676,26 +724,27 @@ void Mixer::masterMix( SampleFrame* _buf )
 	// about their senders, and can just increment the deps of their
 	// recipients right away.
 	AudioEngineWorkerThread::resetJobQueue( AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic );
-	for( MixerChannel * ch : m_mixerChannels )
+	for (const auto& channel : routing->channels)
 	{
+		MixerChannel* ch = channel.channel;
 		ch->m_muted = ch->m_muteModel.value();
 		if( ch->m_muted ) // instantly "process" muted channels
 		{
 			ch->processed();
 			ch->done();
 		}
-		else if( ch->m_receives.size() == 0 )
+		else if (channel.receives.empty())
 		{
 			ch->m_queued = true;
 			AudioEngineWorkerThread::addJob( ch );
 		}
 	}
-	while (m_mixerChannels[0]->state() != ThreadableJob::ProcessingState::Done)
+	while (master->state() != ThreadableJob::ProcessingState::Done)
 	{
 		bool found = false;
-		for( MixerChannel * ch : m_mixerChannels )
+		for (const auto& channel : routing->channels)
 		{
-			const auto s = ch->state();
+			const auto s = channel.channel->state();
 			if (s == ThreadableJob::ProcessingState::Queued
 				|| s == ThreadableJob::ProcessingState::InProgress)
 			{
@@ -710,33 +759,127 @@ void Mixer::masterMix( SampleFrame* _buf )
 		AudioEngineWorkerThread::startAndWaitForJobs();
 	}
 
-	// handle sample-exact data in master volume fader
-	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
-
-	if( volBuf )
+	const bool hasOutput = master->m_hasOutput;
+	if( hasOutput )
 	{
-		for( int f = 0; f < fpp; f++ )
+		// handle sample-exact data in master volume fader
+		ValueBuffer * volBuf = master->m_volumeModel.valueBuffer();
+
+		if( volBuf )
 		{
-			m_mixerChannels[0]->m_buffer[f][0] *= volBuf->values()[f];
-			m_mixerChannels[0]->m_buffer[f][1] *= volBuf->values()[f];
+			for( int f = 0; f < fpp; f++ )
+			{
+				master->m_buffer[f][0] *= volBuf->values()[f];
+				master->m_buffer[f][1] *= volBuf->values()[f];
+			}
 		}
-	}
 
-	const float v = volBuf
-		? 1.0f
-		: m_mixerChannels[0]->m_volumeModel.value();
-	MixHelpers::addSanitizedMultiplied( _buf, m_mixerChannels[0]->m_buffer, v, fpp );
+		const float v = volBuf
+			? 1.0f
+			: master->m_volumeModel.value();
+		MixHelpers::addSanitizedMultiplied( _buf, master->m_buffer, v, fpp );
+	}
 
-	// clear all channel buffers and
+	// clear all channel buffers that were written to and
 	// reset channel process state
-	for( int i = 0; i < numChannels(); ++i)
+	for (const auto& channel : routing->channels)
 	{
-		zeroSampleFrames(m_mixerChannels[i]->m_buffer, Engine::audioEngine()->framesPerPeriod());
-		m_mixerChannels[i]->reset();
-		m_mixerChannels[i]->m_queued = false;
+		MixerChannel * ch = channel.channel;
+		if( ch->m_hasInput || ch->m_hasOutput )
+		{
+			zeroSampleFrames(ch->m_buffer, fpp);
+		}
+		ch->reset();
+		ch->m_queued = false;
 		// also reset hasInput
-		m_mixerChannels[i]->m_hasInput = false;
-		m_mixerChannels[i]->m_dependenciesMet = 0;
+		ch->m_hasInput = false;
+		ch->m_hasOutput = false;
+		ch->m_dependenciesMet = 0;
+	}
+
+	return hasOutput;
+}
+
+
+
+
+void Mixer::startPeriod()
+{
+	// Announce the routing before using it. If it was replaced meanwhile,
+	// publishRouting() may not have seen the announcement and deleted it.
+	MixerRouting* routing;
+	do
+	{
+		routing = m_routing.load();
+		m_activeRouting.store(routing);
+	}
+	while (routing != m_routing.load());
+
+	for (const auto& channel : routing->channels)
+	{
+		channel.channel->m_routing = &channel;
+	}
+}
+
+
+
+
+void Mixer::finishPeriod()
+{
+	m_activeRouting.store(nullptr);
+}
+
+
+
+
+void Mixer::publishRouting()
+{
+	auto routing = new MixerRouting;
+	routing->channels.reserve(m_mixerChannels.size());
+	for (MixerChannel* ch : m_mixerChannels)
+	{
+		auto receivers = std::vector<MixerChannel*>{};
+		receivers.reserve(ch->m_sends.size());
+		for (const MixerRoute* send : ch->m_sends)
+		{
+			receivers.push_back(send->receiver());
+		}
+		routing->channels.push_back({ch, ch->m_receives, std::move(receivers)});
+	}
+
+	// whatever was removed since the last publish may be in use until the old routing is
+	m_retiredRoutings.push_back({m_routing.exchange(routing), std::move(m_removedChannels), std::move(m_removedRoutes)});
+	m_removedChannels.clear();
+	m_removedRoutes.clear();
+
+	reclaimRoutings();
+}
+
+
+
+
+void Mixer::reclaimRoutings()
+{
+	// the audio thread only ever picks up the latest routing, so all routings
+	// retired before the one it uses are unused
+	const MixerRouting* active = m_activeRouting.load();
+	auto it = m_retiredRoutings.begin();
+	for (; it != m_retiredRoutings.end() && it->routing != active; ++it)
+	{
+		for (MixerRoute* route : it->routes) { delete route; }
+		for (MixerChannel* channel : it->channels) { delete channel; }
+		delete it->routing;
+	}
+	m_retiredRoutings.erase(m_retiredRoutings.begin(), it);
+
+	// the audio thread is still using one of them, try again once its period is over
+	if (!m_retiredRoutings.empty() && !m_reclaimScheduled)
+	{
+		m_reclaimScheduled = true;
+		QTimer::singleShot(ReclaimRetryInterval, this, [this] {
+			m_reclaimScheduled = false;
+			reclaimRoutings();
+		});
 	}
 }
 
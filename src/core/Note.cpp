@@ -26,6 +26,10 @@
 #include <QDomElement>
 
 #include <cmath>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Note.h"
 #include "DetuningHelper.h"
@@ -33,6 +37,65 @@
 namespace lmms
 {
 
+namespace
+{
+
+class NotePool
+{
+public:
+	void* allocate()
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		if (!m_free) { grow(); }
+
+		Slot* slot = m_free;
+		m_free = slot->next;
+		return slot->storage;
+	}
+
+	void deallocate(void* ptr)
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		auto slot = static_cast<Slot*>(ptr);
+		slot->next = m_free;
+		m_free = slot;
+	}
+
+private:
+	union Slot
+	{
+		Slot* next;
+		alignas(Note) std::byte storage[sizeof(Note)];
+	};
+
+	static constexpr std::size_t ChunkSize = 256;
+
+	void grow()
+	{
+		auto& chunk = m_chunks.emplace_back(std::make_unique<Slot[]>(ChunkSize));
+		// link in reverse so that slots are handed out in ascending order
+		for (std::size_t i = ChunkSize; i > 0; --i)
+		{
+			chunk[i - 1].next = m_free;
+			m_free = &chunk[i - 1];
+		}
+	}
+
+	std::mutex m_mutex;
+	Slot* m_free = nullptr;
+	std::vector<std::unique_ptr<Slot[]>> m_chunks;
+};
+
+// never destroyed, as notes may outlive static destruction
+NotePool& notePool()
+{
+	static auto pool = new NotePool;
+	return *pool;
+}
+
+} // namespace
+
+
 
 Note::Note( const TimePos & length, const TimePos & pos,
 		int key, volume_t volume, panning_t panning,
@@ -110,6 +173,32 @@ Note::~Note()
 
 
 
+void* Note::operator new(std::size_t size)
+{
+	// derived classes are not pooled
+	return size == sizeof(Note) ? notePool().allocate() : ::operator new(size);
+}
+
+
+
+
+void Note::operator delete(void* ptr, std::size_t size)
+{
+	if (!ptr) { return; }
+
+	if (size == sizeof(Note))
+	{
+		notePool().deallocate(ptr);
+	}
+	else
+	{
+		::operator delete(ptr);
+	}
+}
+
+
+
+
 void Note::setLength( const TimePos & length )
 {
 	m_length = length;
@@ -70,6 +70,8 @@ NotePlayHandle::NotePlayHandle( InstrumentTrack* instrumentTrack,
 	m_parent( parent ),
 	m_hadChildren( false ),
 	m_muted( false ),
+	m_stealFrames( 0 ),
+	m_stealFramesDone( 0 ),
 	m_patternTrack( nullptr ),
 	m_origTempo( Engine::getSong()->getTempo() ),
 	m_origBaseNote( instrumentTrack->baseNote() ),
@@ -261,6 +263,17 @@ void NotePlayHandle::play( SampleFrame* _working_buffer )
 	{
 		// play note!
 		m_instrumentTrack->playNote( this, _working_buffer );
+
+		if (isStolen() && _working_buffer)
+		{
+			const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+			for (fpp_t f = 0; f < fpp; ++f)
+			{
+				const auto done = std::min(m_stealFramesDone + f, m_stealFrames);
+				_working_buffer[f] *= 1.0f - static_cast<float>(done) / m_stealFrames;
+			}
+			m_stealFramesDone += fpp;
+		}
 	}
 
 	if( m_released && (!instrumentTrack()->isSustainPedalPressed() ||
@@ -328,7 +341,11 @@ void NotePlayHandle::play( SampleFrame* _working_buffer )
 
 f_cnt_t NotePlayHandle::framesLeft() const
 {
-	if( instrumentTrack()->isSustainPedalPressed() )
+	if (isStolen() && m_stealFramesDone >= m_stealFrames)
+	{
+		return 0;
+	}
+	else if( instrumentTrack()->isSustainPedalPressed() )
 	{
 		return 4 * Engine::audioEngine()->framesPerPeriod();
 	}
@@ -453,6 +470,23 @@ void NotePlayHandle::mute()
 
 
 
+void NotePlayHandle::steal(f_cnt_t fadeFrames)
+{
+	if (isStolen())
+	{
+		return;
+	}
+
+	m_stealFrames = std::max<f_cnt_t>(fadeFrames, 1);
+	// instruments rendering all notes into one stream do their own release
+	m_stealFramesDone = usesBuffer() ? 0 : m_stealFrames;
+
+	noteOff(0);
+}
+
+
+
+
 int NotePlayHandle::index() const
 {
 	const PlayHandleList & playHandles = Engine::audioEngine()->playHandles();
@@ -36,6 +36,7 @@
 #include "AutomatableModel.h"
 #include "fftw3.h"
 #include "fft_helpers.h"
+#include "WaveTableCache.h"
 
 
 namespace lmms
@@ -44,8 +45,26 @@ namespace lmms
 
 void Oscillator::waveTableInit()
 {
+	// Bump when changing how the tables are generated, to invalidate cached tables
+	constexpr std::uint64_t GeneratorVersion = 1;
+
+	WaveTableCache::loadFftwWisdom();
 	createFFTPlans();
-	generateWaveTables();
+
+	const auto cacheKey = WaveTableCache::key({GeneratorVersion, NumWaveShapeTables,
+		OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT, OscillatorConstants::WAVETABLE_LENGTH,
+		OscillatorConstants::MAX_FREQ, OscillatorConstants::SEMITONES_PER_TABLE, sizeof(sample_t)});
+	if (const auto cached = WaveTableCache::map("oscillator-wavetables", cacheKey, sizeof(WaveShapeTables)))
+	{
+		s_waveTables = static_cast<const WaveShapeTable*>(cached);
+	}
+	else
+	{
+		generateWaveTables();
+		s_waveTables = s_generatedWaveTables;
+		WaveTableCache::store("oscillator-wavetables", cacheKey, s_generatedWaveTables, sizeof(WaveShapeTables));
+	}
+	WaveTableCache::saveFftwWisdom();
 	// The oscillator FFT plans remain throughout the application lifecycle
 	// due to being expensive to create, and being used whenever a userwave form is changed
 	// deleted in main.cpp main()
@@ -209,10 +228,8 @@ std::unique_ptr<OscillatorConstants::waveform_t> Oscillator::generateAntiAliasUs
 
 
 
-sample_t Oscillator::s_waveTables
-	[Oscillator::NumWaveShapeTables]
-	[OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT]
-	[OscillatorConstants::WAVETABLE_LENGTH];
+const Oscillator::WaveShapeTable* Oscillator::s_waveTables = Oscillator::s_generatedWaveTables;
+Oscillator::WaveShapeTables Oscillator::s_generatedWaveTables;
 fftwf_plan Oscillator::s_fftPlan;
 fftwf_plan Oscillator::s_ifftPlan;
 fftwf_complex * Oscillator::s_specBuf;
@@ -253,21 +270,21 @@ void Oscillator::generateWaveTables()
 
 		// Clear the first wave table
 		std::fill(
-		    std::begin(s_waveTables[shapeID][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT - 1]),
-		    std::end(s_waveTables[shapeID][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT - 1]),
+		    std::begin(s_generatedWaveTables[shapeID][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT - 1]),
+		    std::end(s_generatedWaveTables[shapeID][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT - 1]),
 		    0.f);
 
 		for (int i = OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT - 1; i >= 0; i--)
 		{
 			const int bands = OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i);
-			generator(bands, s_waveTables[shapeID][i], lastBands + 1);
+			generator(bands, s_generatedWaveTables[shapeID][i], lastBands + 1);
 			lastBands = bands;
 			if (i)
 			{
 				std::copy(
-					s_waveTables[shapeID][i],
-					s_waveTables[shapeID][i] + OscillatorConstants::WAVETABLE_LENGTH,
-					s_waveTables[shapeID][i - 1]);
+					s_generatedWaveTables[shapeID][i],
+					s_generatedWaveTables[shapeID][i] + OscillatorConstants::WAVETABLE_LENGTH,
+					s_generatedWaveTables[shapeID][i - 1]);
 			}
 		}
 	};
@@ -284,7 +301,7 @@ void Oscillator::generateWaveTables()
 				Oscillator::s_sampleBuffer[i] = moogSawSample((float)i / (float)OscillatorConstants::WAVETABLE_LENGTH);
 			}
 			fftwf_execute(s_fftPlan);
-			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable][i]);
+			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_generatedWaveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable][i]);
 		}
 
 		// Generate exponential tables
@@ -295,7 +312,7 @@ void Oscillator::generateWaveTables()
 				s_sampleBuffer[i] = expSample((float)i / (float)OscillatorConstants::WAVETABLE_LENGTH);
 			}
 			fftwf_execute(s_fftPlan);
-			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable][i]);
+			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_generatedWaveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable][i]);
 		}
 	};
 
@@ -0,0 +1,257 @@
+/*
+ * PartitionedConvolver.cpp - uniformly partitioned FFT convolution
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PartitionedConvolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "SampleFrame.h"
+
+namespace lmms
+{
+
+
+PartitionedConvolver::ImpulseResponse::ImpulseResponse(fpp_t blockSize) :
+	m_blockSize(blockSize),
+	m_timeBuffer(static_cast<float*>(fftwf_malloc(2 * blockSize * sizeof(float)))),
+	m_spectrumBuffer(static_cast<fftwf_complex*>(fftwf_malloc((blockSize + 1) * sizeof(fftwf_complex)))),
+	m_forward(fftwf_plan_dft_r2c_1d(2 * blockSize, m_timeBuffer, m_spectrumBuffer, FFTW_MEASURE)),
+	m_partitions(0)
+{
+}
+
+
+
+
+PartitionedConvolver::ImpulseResponse::~ImpulseResponse()
+{
+	fftwf_destroy_plan(m_forward);
+	fftwf_free(m_timeBuffer);
+	fftwf_free(m_spectrumBuffer);
+}
+
+
+
+
+void PartitionedConvolver::ImpulseResponse::set(const SampleFrame* ir, f_cnt_t length)
+{
+	m_partitions = std::max<std::size_t>((length + m_blockSize - 1) / m_blockSize, 1);
+
+	m_activePartitions.clear();
+	for (std::size_t p = 0; p < m_partitions; ++p)
+	{
+		const f_cnt_t begin = p * m_blockSize;
+		const f_cnt_t end = std::min<f_cnt_t>(begin + m_blockSize, length);
+		if (std::all_of(ir + begin, ir + end, [](const SampleFrame& f) { return f.left() == 0 && f.right() == 0; }))
+		{
+			continue;
+		}
+
+		const auto index = m_activePartitions.size();
+		m_activePartitions.push_back(p);
+		if (m_spectra.size() < (index + 1) * 2 * bins())
+		{
+			m_spectra.resize((index + 1) * 2 * bins());
+		}
+
+		for (ch_cnt_t ch = 0; ch < 2; ++ch)
+		{
+			// zero padded to twice the block size, as required by overlap-save
+			std::fill_n(m_timeBuffer, 2 * m_blockSize, 0.f);
+			for (f_cnt_t f = begin; f < end; ++f)
+			{
+				m_timeBuffer[f - begin] = ir[f][ch];
+			}
+			fftwf_execute(m_forward);
+			std::copy_n(reinterpret_cast<const Spectrum*>(m_spectrumBuffer), bins(), spectrum(index, ch));
+		}
+	}
+}
+
+
+
+
+void PartitionedConvolver::ImpulseResponse::swap(ImpulseResponse& other)
+{
+	// the FFT buffers are scratch space and stay with their owner
+	m_spectra.swap(other.m_spectra);
+	m_activePartitions.swap(other.m_activePartitions);
+	std::swap(m_partitions, other.m_partitions);
+}
+
+
+
+
+PartitionedConvolver::PartitionedConvolver(fpp_t blockSize, f_cnt_t maxLength) :
+	m_blockSize(blockSize),
+	m_timeBuffer(static_cast<float*>(fftwf_malloc(2 * blockSize * sizeof(float)))),
+	m_spectrumBuffer(static_cast<fftwf_complex*>(fftwf_malloc((blockSize + 1) * sizeof(fftwf_complex)))),
+	m_forward(fftwf_plan_dft_r2c_1d(2 * blockSize, m_timeBuffer, m_spectrumBuffer, FFTW_MEASURE)),
+	m_backward(fftwf_plan_dft_c2r_1d(2 * blockSize, m_spectrumBuffer, m_timeBuffer, FFTW_MEASURE)),
+	m_response(blockSize),
+	m_inputSlots(0),
+	m_inputPosition(0),
+	m_accumulator(blockSize + 1)
+{
+	m_history[0].resize(2 * blockSize);
+	m_history[1].resize(2 * blockSize);
+	reserveInputSlots((maxLength + blockSize - 1) / blockSize);
+}
+
+
+
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+	fftwf_destroy_plan(m_forward);
+	fftwf_destroy_plan(m_backward);
+	fftwf_free(m_timeBuffer);
+	fftwf_free(m_spectrumBuffer);
+}
+
+
+
+
+void PartitionedConvolver::setImpulseResponse(const SampleFrame* ir, f_cnt_t length)
+{
+	m_response.set(ir, length);
+	reserveInputSlots(m_response.partitions());
+}
+
+
+
+
+void PartitionedConvolver::swapImpulseResponse(ImpulseResponse& response)
+{
+	assert(response.blockSize() == m_blockSize);
+	m_response.swap(response);
+	reserveInputSlots(m_response.partitions());
+}
+
+
+
+
+void PartitionedConvolver::reserveInputSlots(std::size_t partitions)
+{
+	// Growing the delay line loses the input history, as the slots are indexed modulo its size
+	if (partitions > m_inputSlots)
+	{
+		m_inputSlots = partitions;
+		m_inputSpectra.assign(m_inputSlots * 2 * bins(), Spectrum{});
+		m_inputPosition = 0;
+	}
+}
+
+
+
+
+void PartitionedConvolver::process(const SampleFrame* in, SampleFrame* out)
+{
+	if (m_response.m_activePartitions.empty()) { return; }
+
+	const float scale = 1.f / (2 * m_blockSize);
+
+	for (ch_cnt_t ch = 0; ch < 2; ++ch)
+	{
+		// slide the input history by one block and transform it
+		auto& history = m_history[ch];
+		std::copy(history.begin() + m_blockSize, history.end(), history.begin());
+		for (fpp_t f = 0; f < m_blockSize; ++f)
+		{
+			history[m_blockSize + f] = in[f][ch];
+		}
+
+		std::copy(history.begin(), history.end(), m_timeBuffer);
+		fftwf_execute(m_forward);
+		std::copy_n(reinterpret_cast<const Spectrum*>(m_spectrumBuffer), bins(), inputSpectrum(m_inputPosition, ch));
+
+		// multiply each partition with the input from as many blocks ago
+		std::fill(m_accumulator.begin(), m_accumulator.end(), Spectrum{});
+		for (std::size_t i = 0; i < m_response.m_activePartitions.size(); ++i)
+		{
+			const auto slot = (m_inputPosition + m_inputSlots - m_response.m_activePartitions[i]) % m_inputSlots;
+			const Spectrum* x = inputSpectrum(slot, ch);
+			const Spectrum* h = m_response.spectrum(i, ch);
+			for (std::size_t b = 0; b < bins(); ++b)
+			{
+				m_accumulator[b] += x[b] * h[b];
+			}
+		}
+
+		std::copy(m_accumulator.begin(), m_accumulator.end(), reinterpret_cast<Spectrum*>(m_spectrumBuffer));
+		fftwf_execute(m_backward);
+
+		// the first half is the circular wrap-around and gets discarded
+		for (fpp_t f = 0; f < m_blockSize; ++f)
+		{
+			out[f][ch] += m_timeBuffer[m_blockSize + f] * scale;
+		}
+	}
+
+	m_inputPosition = (m_inputPosition + 1) % m_inputSlots;
+}
+
+
+
+
+void PartitionedConvolver::reset()
+{
+	std::fill(m_history[0].begin(), m_history[0].end(), 0.f);
+	std::fill(m_history[1].begin(), m_history[1].end(), 0.f);
+	std::fill(m_inputSpectra.begin(), m_inputSpectra.end(), Spectrum{});
+	m_inputPosition = 0;
+}
+
+
+
+
+std::size_t PartitionedConvolver::activePartitions(const SampleFrame* ir, f_cnt_t length, fpp_t blockSize)
+{
+	std::size_t count = 0;
+	for (f_cnt_t begin = 0; begin < length; begin += blockSize)
+	{
+		const f_cnt_t end = std::min<f_cnt_t>(begin + blockSize, length);
+		if (std::any_of(ir + begin, ir + end, [](const SampleFrame& f) { return f.left() != 0 || f.right() != 0; }))
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+
+
+
+float PartitionedConvolver::estimatedCost(std::size_t activePartitions, fpp_t blockSize)
+{
+	const float fftSize = 2.f * blockSize;
+	// two real FFTs plus one complex multiply-add (8 operations) per bin and partition, for both channels
+	const float fftCost = 2.5f * fftSize * std::log2(fftSize);
+	return 2 * (fftCost + 8.f * (blockSize + 1) * activePartitions);
+}
+
+
+} // namespace lmms
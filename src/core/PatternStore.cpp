@@ -36,7 +36,9 @@ namespace lmms
 
 PatternStore::PatternStore() :
 	TrackContainer(),
-	m_patternComboBoxModel(this)
+	m_patternComboBoxModel(this),
+	m_playbackLengthsRevision(Clip::layoutRevision() - 1),
+	m_playbackLengthsTicksPerBar(0)
 {
 	setType(Type::Pattern);
 }
@@ -48,12 +50,13 @@ bool PatternStore::play(TimePos start, fpp_t frames, f_cnt_t offset, int clipNum
 {
 	bool notePlayed = false;
 
-	if (lengthOfPattern(clipNum) <= 0)
+	const tick_t length = playbackLength(clipNum);
+	if (length <= 0)
 	{
 		return false;
 	}
 
-	start = start % (lengthOfPattern(clipNum) * TimePos::ticksPerBar());
+	start = start % length;
 
 	const TrackList& tl = tracks();
 	for (Track * t : tl)
@@ -101,6 +104,31 @@ bar_t PatternStore::lengthOfPattern(int pattern) const
 
 
 
+tick_t PatternStore::playbackLength(int pattern)
+{
+	const unsigned revision = Clip::layoutRevision();
+	if (revision != m_playbackLengthsRevision || TimePos::ticksPerBar() != m_playbackLengthsTicksPerBar)
+	{
+		m_playbackLengthsRevision = revision;
+		m_playbackLengthsTicksPerBar = TimePos::ticksPerBar();
+		m_playbackLengths.clear();
+	}
+
+	// patterns are measured on first use, so a pattern that is not played costs nothing
+	if (pattern >= static_cast<int>(m_playbackLengths.size()))
+	{
+		m_playbackLengths.resize(pattern + 1, -1);
+	}
+	if (m_playbackLengths[pattern] < 0)
+	{
+		m_playbackLengths[pattern] = lengthOfPattern(pattern) * TimePos::ticksPerBar();
+	}
+	return m_playbackLengths[pattern];
+}
+
+
+
+
 int PatternStore::numOfPatterns() const
 {
 	return Engine::getSong()->countTracks(Track::Type::Pattern);
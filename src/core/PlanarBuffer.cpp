@@ -0,0 +1,71 @@
+/*
+ * PlanarBuffer.cpp - owning buffer with one array per channel
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PlanarBuffer.h"
+
+namespace lmms
+{
+
+
+PlanarBuffer::PlanarBuffer(f_cnt_t frames)
+	: m_frames(frames)
+	, m_data(frames * DEFAULT_CHANNELS)
+{
+	for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+	{
+		m_channels[ch] = m_data.data() + ch * frames;
+	}
+}
+
+
+
+
+void PlanarBuffer::deinterleave(std::span<const SampleFrame> source)
+{
+	assert(source.size() <= m_frames);
+	float* left = m_channels[0];
+	float* right = m_channels[1];
+	for (std::size_t f = 0; f < source.size(); ++f)
+	{
+		left[f] = source[f].left();
+		right[f] = source[f].right();
+	}
+}
+
+
+
+
+void PlanarBuffer::interleave(std::span<SampleFrame> destination) const
+{
+	assert(destination.size() <= m_frames);
+	const float* left = m_channels[0];
+	const float* right = m_channels[1];
+	for (std::size_t f = 0; f < destination.size(); ++f)
+	{
+		destination[f] = SampleFrame{left[f], right[f]};
+	}
+}
+
+
+} // namespace lmms
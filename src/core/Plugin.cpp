@@ -209,9 +209,10 @@ Plugin * Plugin::instantiate(const QString& pluginName, Model * parent,
 								void *data)
 {
 	const PluginFactory::PluginInfo& pi = getPluginFactory()->pluginInfo(pluginName.toUtf8());
+	const auto library = pi.isNull() ? nullptr : getPluginFactory()->library(pi);
 
 	Plugin* inst;
-	if( pi.isNull() )
+	if (!library)
 	{
 		if (gui::getGUI() != nullptr)
 		{
@@ -225,7 +226,7 @@ Plugin * Plugin::instantiate(const QString& pluginName, Model * parent,
 	}
 	else
 	{
-		auto instantiationHook = reinterpret_cast<InstantiationHook>(pi.library->resolve("lmms_plugin_main"));
+		auto instantiationHook = reinterpret_cast<InstantiationHook>(library->resolve("lmms_plugin_main"));
 		if (instantiationHook)
 		{
 			inst = instantiationHook(parent, data);
@@ -0,0 +1,131 @@
+/*
+ * PluginCache.cpp - persistent cache of plugin metadata
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PluginCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include "WaveTableCache.h"
+#include "lmmsversion.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Bump when changing what is stored, to invalidate existing caches
+constexpr int FormatVersion = 2;
+
+bool s_rescan = false;
+
+} // namespace
+
+
+
+
+PluginCache::PluginCache(const QString& name)
+	: m_path(WaveTableCache::directory() + "/" + name + ".json")
+{
+	if (s_rescan) { return; }
+
+	auto file = QFile{m_path};
+	if (!file.open(QIODevice::ReadOnly)) { return; }
+
+	const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+	// plugins in the search paths are updated together with LMMS, possibly without changing their size
+	if (root.value("format").toInt() != FormatVersion || root.value("lmms").toString() != LMMS_VERSION)
+	{
+		return;
+	}
+	m_stored = root.value("libraries").toObject();
+}
+
+
+
+
+PluginCache::~PluginCache()
+{
+	if (m_current == m_stored) { return; }
+
+	const auto root = QJsonObject{
+		{"format", FormatVersion},
+		{"lmms", LMMS_VERSION},
+		{"libraries", m_current}
+	};
+
+	if (!QDir().mkpath(QFileInfo(m_path).absolutePath())) { return; }
+	auto file = QSaveFile{m_path};
+	if (file.open(QIODevice::WriteOnly))
+	{
+		file.write(QJsonDocument{root}.toJson(QJsonDocument::Compact));
+		file.commit();
+	}
+}
+
+
+
+
+std::optional<QJsonObject> PluginCache::find(const QFileInfo& library)
+{
+	const QString path = library.absoluteFilePath();
+	const QJsonObject entry = m_stored.value(path).toObject();
+	if (entry.isEmpty()
+		|| entry.value("modified").toVariant().toLongLong() != library.lastModified().toMSecsSinceEpoch()
+		|| entry.value("size").toVariant().toLongLong() != library.size())
+	{
+		return std::nullopt;
+	}
+
+	m_current.insert(path, entry);
+	return entry.value("data").toObject();
+}
+
+
+
+
+void PluginCache::insert(const QFileInfo& library, const QJsonObject& data)
+{
+	m_current.insert(library.absoluteFilePath(), QJsonObject{
+		{"modified", QString::number(library.lastModified().toMSecsSinceEpoch())},
+		{"size", QString::number(library.size())},
+		{"data", data}
+	});
+}
+
+
+
+
+void PluginCache::setRescan(bool rescan)
+{
+	s_rescan = rescan;
+}
+
+
+} // namespace lmms
@@ -24,16 +24,23 @@
 
 #include "PluginFactory.h"
 
+#include <QBuffer>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QImage>
+#include <QImageReader>
+#include <QJsonObject>
 #include <QLibrary>
+#include <QPixmapCache>
 #include <QRegularExpression>
 #include <memory>
 #include "lmmsconfig.h"
 
 #include "ConfigManager.h"
 #include "Plugin.h"
+#include "PluginCache.h"
+#include "embed.h"
 
 // QT qHash specialization, needs to be in global namespace
 qint64 qHash(const QFileInfo& fi)
@@ -53,12 +60,137 @@ namespace lmms
 
 std::unique_ptr<PluginFactory> PluginFactory::s_instance;
 
+namespace
+{
+
+//! Shows a logo stored in the PluginCache, since the library with the original is not loaded
+class CachedPixmapLoader : public PixmapLoader
+{
+public:
+	CachedPixmapLoader(std::string name, QByteArray image) :
+		PixmapLoader{std::move(name)},
+		m_image{std::move(image)}
+	{ }
+
+	auto pixmap(int width = -1, int height = -1) const -> QPixmap override
+	{
+		// same pixmap cache as embed::getIconPixmap(), the original looks the same
+		const auto name = QString::fromStdString(pixmapName());
+		const auto cacheName = (width > 0 && height > 0)
+			? QStringLiteral("%1_%2_%3").arg(name).arg(width).arg(height)
+			: name;
+		if (auto pixmap = QPixmap{}; QPixmapCache::find(cacheName, &pixmap)) { return pixmap; }
+
+		auto pixmap = QPixmap{};
+		pixmap.loadFromData(m_image, "PNG");
+		if (width > 0 && height > 0)
+		{
+			pixmap = pixmap.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+		}
+		QPixmapCache::insert(cacheName, pixmap);
+		return pixmap;
+	}
+
+private:
+	QByteArray m_image;
+};
+
+//! Loads the logo like embed::getIconPixmap(), but without QPixmap, which needs a GUI
+QByteArray encodeLogo(const PixmapLoader& logo)
+{
+	const auto name = QString::fromStdString(logo.pixmapName());
+	const auto image = logo.xpm()
+		? QImage{logo.xpm()}
+		: QImageReader{QDir::isAbsolutePath(name) ? name : "artwork:" + name}.read();
+
+	auto data = QByteArray{};
+	auto buffer = QBuffer{&data};
+	if (image.isNull() || !buffer.open(QIODevice::WriteOnly) || !image.save(&buffer, "PNG"))
+	{
+		qWarning() << "Could not cache the plugin logo" << name;
+		return {};
+	}
+	return data;
+}
+
+std::unique_ptr<PixmapLoader> cachedLogo(const QJsonObject& data, const QByteArray& image)
+{
+	if (!data.contains("logo")) { return nullptr; }
+
+	auto name = data.value("logo").toString().toStdString();
+	if (image.isEmpty()) { return std::make_unique<PixmapLoader>(std::move(name)); }
+	return std::make_unique<CachedPixmapLoader>(std::move(name), image);
+}
+
+} // namespace
+
+
+
+
+PluginFactory::CachedDescriptor::CachedDescriptor(const QJsonObject& data) :
+	name(data.value("name").toString().toStdString()),
+	displayName(data.value("displayName").toString().toStdString()),
+	description(data.value("description").toString().toStdString()),
+	author(data.value("author").toString().toStdString()),
+	supportedFileTypes(data.value("supportedFileTypes").toString().toStdString()),
+	logoImage(QByteArray::fromBase64(data.value("logoImage").toString().toLatin1())),
+	logo(cachedLogo(data, logoImage)),
+	descriptor{
+		name.c_str(),
+		displayName.c_str(),
+		description.c_str(),
+		author.c_str(),
+		data.value("version").toInt(),
+		static_cast<Plugin::Type>(data.value("type").toInt()),
+		logo.get(),
+		data.contains("supportedFileTypes") ? supportedFileTypes.c_str() : nullptr,
+		nullptr
+	}
+{
+}
+
+PluginFactory::CachedDescriptor::~CachedDescriptor() = default;
+
+bool PluginFactory::CachedDescriptor::isCacheable(const Plugin::Descriptor& descriptor)
+{
+	// sub plugins are discovered when their library is loaded
+	return descriptor.subPluginFeatures == nullptr;
+}
+
+QJsonObject PluginFactory::CachedDescriptor::toJson(const Plugin::Descriptor& descriptor)
+{
+	auto data = QJsonObject{
+		{"name", descriptor.name},
+		{"displayName", descriptor.displayName},
+		{"description", descriptor.description},
+		{"author", descriptor.author},
+		{"version", descriptor.version},
+		{"type", static_cast<int>(descriptor.type)}
+	};
+	if (descriptor.logo)
+	{
+		data.insert("logo", QString::fromStdString(descriptor.logo->pixmapName()));
+		// plugin logos are in the library's resources, which are gone when it is not loaded
+		if (const auto image = encodeLogo(*descriptor.logo); !image.isEmpty())
+		{
+			data.insert("logoImage", QString::fromLatin1(image.toBase64()));
+		}
+	}
+	if (descriptor.supportedFileTypes)
+	{
+		data.insert("supportedFileTypes", descriptor.supportedFileTypes);
+	}
+	return data;
+}
+
 PluginFactory::PluginFactory()
 {
 	setupSearchPaths();
 	discoverPlugins();
 }
 
+PluginFactory::~PluginFactory() = default;
+
 void PluginFactory::setupSearchPaths()
 {
 	// Adds a search path relative to the main executable if the path exists.
@@ -135,6 +267,28 @@ PluginFactory::PluginInfo PluginFactory::pluginInfo(const char* name) const
 	return PluginInfo();
 }
 
+std::shared_ptr<QLibrary> PluginFactory::library(const PluginInfo& info)
+{
+	if (info.library) { return info.library; }
+
+	for (PluginInfo& known : m_pluginInfos)
+	{
+		if (known.descriptor != info.descriptor) { continue; }
+		if (known.library) { return known.library; }
+
+		auto library = std::make_shared<QLibrary>(known.file.absoluteFilePath());
+		if (!library->load())
+		{
+			m_errors[known.file.baseName()] = library->errorString();
+			qWarning("%s", library->errorString().toLocal8Bit().data());
+			return nullptr;
+		}
+		known.library = library;
+		return library;
+	}
+	return nullptr;
+}
+
 QString PluginFactory::errorString(QString pluginName) const
 {
 	static QString notfound = qApp->translate("PluginFactory", "Plugin not found.");
@@ -157,14 +311,63 @@ void PluginFactory::discoverPlugins()
 	// Apply any plugin filters from environment LMMS_EXCLUDE_PLUGINS
 	filterPlugins(files);
 
+	auto addSupportedFileTypes =
+		[this](QString supportedFileTypes,
+			const PluginInfo& info,
+			const Plugin::Descriptor::SubPluginFeatures::Key* key = nullptr)
+	{
+		if(!supportedFileTypes.isNull())
+		{
+			for (const QString& ext : supportedFileTypes.split(','))
+			{
+				//qDebug() << "Plugin " << info.name()
+				//	<< "supports" << ext;
+				PluginInfoAndKey infoAndKey;
+				infoAndKey.info = info;
+				infoAndKey.key = key
+					? *key
+					: Plugin::Descriptor::SubPluginFeatures::Key();
+				m_pluginByExt.insert(ext, infoAndKey);
+			}
+		}
+	};
+
+	// Plugins known from the last run are listed without loading their
+	// library, which is loaded by library() once the plugin is used
+	PluginCache cache("plugins");
+	QSet<QFileInfo> librariesToLoad;
+	for (const QFileInfo& file : files)
+	{
+		const auto data = cache.find(file);
+		if (!data)
+		{
+			librariesToLoad.insert(file);
+			continue;
+		}
+
+		auto& cached = m_cachedDescriptors.emplace_back(std::make_unique<CachedDescriptor>(*data));
+
+		PluginInfo info;
+		info.file = file;
+		info.descriptor = &cached->descriptor;
+		pluginInfos << info;
+
+		if (info.descriptor->supportedFileTypes)
+			addSupportedFileTypes(QString(info.descriptor->supportedFileTypes), info);
+
+		descriptors.insert(info.descriptor->type, info.descriptor);
+	}
+
 	// Cheap dependency handling: zynaddsubfx needs ZynAddSubFxCore. By loading
 	// all libraries twice we ensure that libZynAddSubFxCore is found.
-	for (const QFileInfo& file : files)
+	// Libraries without a plugin descriptor are never cached, so dependencies
+	// are still loaded before a cached plugin needs them.
+	for (const QFileInfo& file : librariesToLoad)
 	{
 		QLibrary(file.absoluteFilePath()).load();
 	}
 
-	for (const QFileInfo& file : files)
+	for (const QFileInfo& file : librariesToLoad)
 	{
 		auto library = std::make_shared<QLibrary>(file.absoluteFilePath());
 		if (! library->load()) {
@@ -199,26 +402,10 @@ void PluginFactory::discoverPlugins()
 			info.descriptor = pluginDescriptor;
 			pluginInfos << info;
 
-			auto addSupportedFileTypes =
-				[this](QString supportedFileTypes,
-					const PluginInfo& info,
-					const Plugin::Descriptor::SubPluginFeatures::Key* key = nullptr)
+			if (CachedDescriptor::isCacheable(*pluginDescriptor))
 			{
-				if(!supportedFileTypes.isNull())
-				{
-					for (const QString& ext : supportedFileTypes.split(','))
-					{
-						//qDebug() << "Plugin " << info.name()
-						//	<< "supports" << ext;
-						PluginInfoAndKey infoAndKey;
-						infoAndKey.info = info;
-						infoAndKey.key = key
-							? *key
-							: Plugin::Descriptor::SubPluginFeatures::Key();
-						m_pluginByExt.insert(ext, infoAndKey);
-					}
-				}
-			};
+				cache.insert(file, CachedDescriptor::toJson(*pluginDescriptor));
+			}
 
 			if (info.descriptor->supportedFileTypes)
 				addSupportedFileTypes(QString(info.descriptor->supportedFileTypes), info);
@@ -0,0 +1,360 @@
+/*
+ * ProjectContainer.cpp - project file with the sample data stored next to the XML
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ProjectContainer.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QIODevice>
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr char Magic[] = "LMMSPRJC";
+constexpr int MagicSize = sizeof(Magic) - 1;
+constexpr quint32 FormatVersion = 1;
+
+constexpr qint64 HeaderSize = MagicSize + 2 * sizeof(quint32) + 2 * sizeof(quint64);
+constexpr int HashSize = 32;
+constexpr qint64 IndexEntrySize = HashSize + 2 * sizeof(quint64);
+
+//! Samples start at page boundaries, so they can be mapped individually
+constexpr quint64 BlobAlignment = 4096;
+
+//! int in Qt 5 and qsizetype in Qt 6
+using ByteArraySize = decltype(QByteArray{}.size());
+constexpr quint64 MaxByteArraySize = std::numeric_limits<ByteArraySize>::max();
+
+//! Prefix of sample data attributes that refer to a sample in the container
+const QString BlobPrefix = QStringLiteral("blob:");
+
+//! Element and attribute names of sample data embedded in projects
+constexpr std::array<std::pair<const char*, const char*>, 3> SampleDataAttributes = {{
+	{"sampleclip", "data"},
+	{"audiofileprocessor", "sampledata"},
+	{"slicert", "sampledata"},
+}};
+
+quint64 aligned(quint64 offset)
+{
+	return (offset + BlobAlignment - 1) / BlobAlignment * BlobAlignment;
+}
+
+bool writePadding(QIODevice& device, quint64 offset)
+{
+	const qint64 padding = static_cast<qint64>(offset) - device.pos();
+	return padding <= 0 || device.write(QByteArray(padding, '\0')) == padding;
+}
+
+template<class Func>
+void forEachSampleData(QDomDocument& doc, Func&& func)
+{
+	for (const auto& [tagName, attribute] : SampleDataAttributes)
+	{
+		const QDomNodeList elements = doc.elementsByTagName(tagName);
+		for (int i = 0; i < elements.size(); ++i)
+		{
+			QDomElement element = elements.item(i).toElement();
+			const QString data = element.attribute(attribute);
+			if (!data.isEmpty())
+			{
+				func(element, attribute, data);
+			}
+		}
+	}
+}
+
+} // namespace
+
+
+ProjectContainer* ProjectContainer::s_active = nullptr;
+
+
+
+
+ProjectContainer::~ProjectContainer() = default;
+
+
+
+
+bool ProjectContainer::isContainerFile(const QString& fileName)
+{
+	auto file = QFile{fileName};
+	return file.open(QIODevice::ReadOnly) && file.read(MagicSize) == Magic;
+}
+
+
+
+
+std::unique_ptr<ProjectContainer> ProjectContainer::open(const QString& fileName)
+{
+	auto container = std::make_unique<ProjectContainer>();
+	container->m_file.setFileName(fileName);
+	if (!container->m_file.open(QIODevice::ReadOnly)) { return nullptr; }
+
+	// most files opened here are plain XML projects or presets
+	const qint64 fileSize = container->m_file.size();
+	if (fileSize < HeaderSize || container->m_file.read(MagicSize) != Magic) { return nullptr; }
+
+	container->m_map = container->m_file.map(0, fileSize);
+	if (!container->m_map) { return nullptr; }
+
+	// read from the file, the whole mapping may be larger than a QByteArray can refer to
+	auto stream = QDataStream{&container->m_file};
+	stream.setByteOrder(QDataStream::LittleEndian);
+
+	quint32 version = 0, blobCount = 0;
+	quint64 xmlOffset = 0, xmlSize = 0;
+	stream >> version >> blobCount >> xmlOffset >> xmlSize;
+
+	const auto inFile = [fileSize](quint64 offset, quint64 size) {
+		return offset <= static_cast<quint64>(fileSize) && size <= static_cast<quint64>(fileSize) - offset;
+	};
+
+	if (version != FormatVersion || !inFile(HeaderSize, blobCount * IndexEntrySize) || !inFile(xmlOffset, xmlSize)
+		|| xmlSize > MaxByteArraySize)
+	{
+		qWarning() << "Invalid or unsupported project container" << fileName;
+		return nullptr;
+	}
+
+	const auto data = reinterpret_cast<const char*>(container->m_map);
+	for (quint32 i = 0; i < blobCount; ++i)
+	{
+		auto hash = QByteArray(HashSize, '\0');
+		quint64 offset = 0, size = 0;
+		stream.readRawData(hash.data(), HashSize);
+		stream >> offset >> size;
+		if (stream.status() != QDataStream::Ok || !inFile(offset, size)) { return nullptr; }
+
+		container->m_blobs[QString::fromLatin1(hash.toHex())] = Blob{data + offset, size, nullptr, {}};
+	}
+
+	container->m_compressedXml = QByteArray::fromRawData(data + xmlOffset, static_cast<ByteArraySize>(xmlSize));
+	return container;
+}
+
+
+
+
+QByteArray ProjectContainer::xml() const
+{
+	return qUncompress(m_compressedXml);
+}
+
+
+
+
+bool ProjectContainer::write(QIODevice& device, const QByteArray& xml) const
+{
+	const QByteArray compressedXml = qCompress(xml);
+
+	// all offsets are known beforehand, so everything is written in one go
+	auto offsets = std::vector<quint64>{};
+	offsets.reserve(m_blobs.size());
+	auto end = static_cast<quint64>(HeaderSize + m_blobs.size() * IndexEntrySize);
+	for (const auto& [id, blob] : m_blobs)
+	{
+		offsets.push_back(aligned(end));
+		end = offsets.back() + blob.size;
+	}
+
+	auto stream = QDataStream{&device};
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData(Magic, MagicSize);
+	stream << FormatVersion << static_cast<quint32>(m_blobs.size())
+		<< end << static_cast<quint64>(compressedXml.size());
+
+	auto offset = offsets.begin();
+	for (const auto& [id, blob] : m_blobs)
+	{
+		const QByteArray hash = QByteArray::fromHex(id.toLatin1());
+		stream.writeRawData(hash.constData(), HashSize);
+		stream << *offset++ << blob.size;
+	}
+	if (stream.status() != QDataStream::Ok) { return false; }
+
+	offset = offsets.begin();
+	for (const auto& [id, blob] : m_blobs)
+	{
+		if (!writePadding(device, *offset++) || device.write(blob.data, blob.size) != static_cast<qint64>(blob.size))
+		{
+			return false;
+		}
+	}
+
+	return device.write(compressedXml) == compressedXml.size();
+}
+
+
+
+
+void ProjectContainer::extractSamples(QDomDocument& doc)
+{
+	forEachSampleData(doc, [this](QDomElement& element, const char* attribute, const QString& data) {
+		if (data.startsWith(BlobPrefix)) { return; }
+		element.setAttribute(attribute, BlobPrefix + addSample(blobOf(QByteArray::fromBase64(data.toLatin1()))));
+	});
+}
+
+
+
+
+bool ProjectContainer::embedSamples(QDomDocument& doc) const
+{
+	bool embedded = true;
+	forEachSampleData(doc, [this, &embedded](QDomElement& element, const char* attribute, const QString& data) {
+		if (!data.startsWith(BlobPrefix)) { return; }
+		const auto blob = m_blobs.find(data.mid(BlobPrefix.size()));
+		if (blob == m_blobs.end())
+		{
+			element.setAttribute(attribute, QString{});
+			return;
+		}
+
+		// Base64 takes a third more space than the data
+		const auto& [id, sample] = *blob;
+		if (sample.size > MaxByteArraySize / 4 * 3)
+		{
+			qWarning() << "Sample" << id << "is too large to be embedded into the project";
+			element.setAttribute(attribute, QString{});
+			embedded = false;
+			return;
+		}
+		const auto bytes = QByteArray::fromRawData(sample.data, static_cast<ByteArraySize>(sample.size));
+		element.setAttribute(attribute, QString::fromLatin1(bytes.toBase64()));
+	});
+	return embedded;
+}
+
+
+
+
+QString ProjectContainer::saveSample(const std::shared_ptr<const SampleBuffer>& buffer)
+{
+	if (!s_active || buffer->empty()) { return buffer->toBase64(); }
+
+	// the buffer is kept alive until the container is written, so its data doesn't need to be copied
+	const auto data = reinterpret_cast<const char*>(buffer->data());
+	return BlobPrefix + s_active->addSample({data, buffer->size() * sizeof(SampleFrame), buffer, {}});
+}
+
+
+
+
+std::shared_ptr<const SampleBuffer> ProjectContainer::loadSample(const QString& data, int sampleRate)
+{
+	if (!data.startsWith(BlobPrefix)) { return SampleBuffer::fromBase64(data, sampleRate); }
+
+	const QString id = data.mid(BlobPrefix.size());
+	if (auto buffer = s_active ? s_active->sample(id, sampleRate) : nullptr) { return buffer; }
+
+	qWarning() << "Sample" << id << "not found in project container";
+	return SampleBuffer::emptyBuffer();
+}
+
+
+
+
+auto ProjectContainer::blobOf(QByteArray bytes) -> Blob
+{
+	// the data of a QByteArray stays in place when the array is moved
+	const auto data = bytes.constData();
+	const auto size = static_cast<quint64>(bytes.size());
+	return {data, size, nullptr, std::move(bytes)};
+}
+
+
+
+
+QString ProjectContainer::addSample(Blob blob)
+{
+	// fed in chunks, a QByteArray may not be able to refer to all of it
+	constexpr quint64 ChunkSize = 1 << 30;
+	auto hash = QCryptographicHash{QCryptographicHash::Sha256};
+	for (quint64 offset = 0; offset < blob.size; offset += ChunkSize)
+	{
+		const auto size = std::min(ChunkSize, blob.size - offset);
+		hash.addData(QByteArray::fromRawData(blob.data + offset, static_cast<ByteArraySize>(size)));
+	}
+
+	const QString id = QString::fromLatin1(hash.result().toHex());
+	m_blobs.try_emplace(id, std::move(blob));
+	return id;
+}
+
+
+
+
+std::shared_ptr<const SampleBuffer> ProjectContainer::sample(const QString& id, int sampleRate)
+{
+	if (const auto it = m_loaded.find(id); it != m_loaded.end())
+	{
+		if (auto buffer = it->second.lock(); buffer && buffer->sampleRate() == static_cast<sample_rate_t>(sampleRate))
+		{
+			return buffer;
+		}
+	}
+
+	const auto blob = m_blobs.find(id);
+	if (blob == m_blobs.end() || blob->second.size % sizeof(SampleFrame) != 0) { return nullptr; }
+
+	// blobs start at page boundaries of the mapping, so the frames are properly aligned
+	const auto& data = blob->second;
+	auto buffer = std::make_shared<const SampleBuffer>(reinterpret_cast<const SampleFrame*>(data.data),
+		data.size / sizeof(SampleFrame), sampleRate);
+	m_loaded[id] = buffer;
+	return buffer;
+}
+
+
+
+
+ProjectContainer::Scope::Scope(ProjectContainer* container)
+	: m_previous(s_active)
+{
+	s_active = container;
+}
+
+
+
+
+ProjectContainer::Scope::~Scope()
+{
+	s_active = m_previous;
+}
+
+
+} // namespace lmms
@@ -39,12 +39,14 @@ namespace lmms
 //! and newly created IDs (have the bit set)
 static const int EO_ID_MSB = 1 << 23;
 
-const int ProjectJournal::MAX_UNDO_STATES = 100; // TODO: make this configurable in settings
+const std::size_t ProjectJournal::DefaultMaxMemoryUsage = 64 * 1024 * 1024;
 
 ProjectJournal::ProjectJournal() :
 	m_joIDs(),
 	m_undoCheckPoints(),
 	m_redoCheckPoints(),
+	m_checkPointBytes( 0 ),
+	m_maxMemoryUsage( DefaultMaxMemoryUsage ),
 	m_journalling( false )
 {
 }
@@ -54,28 +56,20 @@ ProjectJournal::ProjectJournal() :
 
 void ProjectJournal::undo()
 {
-	while( !m_undoCheckPoints.isEmpty() )
+	while( !m_undoCheckPoints.empty() )
 	{
-		CheckPoint c = m_undoCheckPoints.pop();
+		CheckPoint c = std::move( m_undoCheckPoints.back() );
+		m_undoCheckPoints.pop_back();
+		m_checkPointBytes -= c.size();
 		JournallingObject *jo = m_joIDs[c.joID];
 
 		if( jo )
 		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_redoCheckPoints.push( CheckPoint( c.joID, curState ) );
-
-			bool prev = isJournalling();
-			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
-			setJournalling( prev );
-			Engine::getSong()->setModified();
-
-			// loading AutomationClip connections correctly
-			if (!c.data.content().elementsByTagName("automationclip").isEmpty())
-			{
-				AutomationClip::resolveAllIDs();
-			}
+			CheckPoint curState = saveCheckPoint( jo );
+			m_checkPointBytes += curState.size();
+			m_redoCheckPoints.push_back( std::move( curState ) );
+
+			restoreCheckPoint( jo, c );
 			break;
 		}
 	}
@@ -85,22 +79,18 @@ void ProjectJournal::undo()
 
 void ProjectJournal::redo()
 {
-	while( !m_redoCheckPoints.isEmpty() )
+	while( !m_redoCheckPoints.empty() )
 	{
-		CheckPoint c = m_redoCheckPoints.pop();
+		CheckPoint c = std::move( m_redoCheckPoints.back() );
+		m_redoCheckPoints.pop_back();
+		m_checkPointBytes -= c.size();
 		JournallingObject *jo = m_joIDs[c.joID];
 
 		if( jo )
 		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_undoCheckPoints.push( CheckPoint( c.joID, curState ) );
-
-			bool prev = isJournalling();
-			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
-			setJournalling( prev );
-			Engine::getSong()->setModified();
+			pushUndoCheckPoint( saveCheckPoint( jo ) );
+
+			restoreCheckPoint( jo, c );
 			break;
 		}
 	}
@@ -108,12 +98,12 @@ void ProjectJournal::redo()
 
 bool ProjectJournal::canUndo() const
 {
-	return !m_undoCheckPoints.isEmpty();
+	return !m_undoCheckPoints.empty();
 }
 
 bool ProjectJournal::canRedo() const
 {
-	return !m_redoCheckPoints.isEmpty();
+	return !m_redoCheckPoints.empty();
 }
 
 
@@ -122,17 +112,106 @@ void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 {
 	if( isJournalling() )
 	{
-		m_redoCheckPoints.clear();
+		clearRedoCheckPoints();
+		pushUndoCheckPoint( saveCheckPoint( jo ) );
+	}
+}
 
-		DataFile dataFile( DataFile::Type::JournalData );
-		jo->saveState( dataFile, dataFile.content() );
 
-		m_undoCheckPoints.push( CheckPoint( jo->id(), dataFile ) );
-		if( m_undoCheckPoints.size() > MAX_UNDO_STATES )
+
+
+std::size_t ProjectJournal::CheckPoint::size() const
+{
+	return sizeof( CheckPoint ) + ( delta ? delta->size() : static_cast<std::size_t>( snapshot.size() ) );
+}
+
+
+
+
+auto ProjectJournal::saveCheckPoint( JournallingObject* jo ) -> CheckPoint
+{
+	if( auto delta = jo->saveJournalDelta() )
+	{
+		return { jo->id(), std::move( delta ), {} };
+	}
+
+	// everything else is stored as a whole, compressed as the XML is very redundant
+	DataFile dataFile( DataFile::Type::JournalData );
+	jo->saveState( dataFile, dataFile.content() );
+	return { jo->id(), nullptr, qCompress( dataFile.toByteArray( -1 ) ) };
+}
+
+
+
+
+void ProjectJournal::restoreCheckPoint( JournallingObject* jo, const CheckPoint& c )
+{
+	bool prev = isJournalling();
+	setJournalling( false );
+
+	if( c.delta )
+	{
+		c.delta->restore( jo );
+	}
+	else
+	{
+		// DataFile uncompresses the data itself
+		DataFile data( c.snapshot );
+		jo->restoreState( data.content().firstChildElement() );
+
+		// loading AutomationClip connections correctly
+		if (!data.content().elementsByTagName("automationclip").isEmpty())
 		{
-			m_undoCheckPoints.remove( 0, m_undoCheckPoints.size() - MAX_UNDO_STATES );
+			AutomationClip::resolveAllIDs();
 		}
 	}
+
+	setJournalling( prev );
+	Engine::getSong()->setModified();
+}
+
+
+
+
+void ProjectJournal::setMaxMemoryUsage( std::size_t bytes )
+{
+	m_maxMemoryUsage = bytes;
+	trimUndoCheckPoints();
+}
+
+
+
+
+void ProjectJournal::pushUndoCheckPoint( CheckPoint c )
+{
+	m_checkPointBytes += c.size();
+	m_undoCheckPoints.push_back( std::move( c ) );
+	trimUndoCheckPoints();
+}
+
+
+
+
+void ProjectJournal::trimUndoCheckPoints()
+{
+	// always keep the latest checkpoint, even if it alone exceeds the budget
+	while( m_checkPointBytes > m_maxMemoryUsage && m_undoCheckPoints.size() > 1 )
+	{
+		m_checkPointBytes -= m_undoCheckPoints.front().size();
+		m_undoCheckPoints.pop_front();
+	}
+}
+
+
+
+
+void ProjectJournal::clearRedoCheckPoints()
+{
+	for( const auto& c : m_redoCheckPoints )
+	{
+		m_checkPointBytes -= c.size();
+	}
+	m_redoCheckPoints.clear();
 }
 
 
@@ -174,6 +253,7 @@ void ProjectJournal::clearJournal()
 {
 	m_undoCheckPoints.clear();
 	m_redoCheckPoints.clear();
+	m_checkPointBytes = 0;
 
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); )
 	{
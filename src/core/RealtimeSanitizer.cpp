@@ -0,0 +1,283 @@
+/*
+ * RealtimeSanitizer.cpp - detect realtime-unsafe calls on the audio threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RealtimeSanitizer.h"
+
+#ifdef LMMS_DEBUG_RTSAN
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "AudioEngine.h"
+
+// glibc's implementations, which we forward to without going through dlsym
+extern "C"
+{
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace lmms::RealtimeSanitizer
+{
+
+namespace
+{
+
+constexpr std::size_t MaxViolations = 4096;
+constexpr int MaxFrames = 32;
+
+struct Record
+{
+	Violation type;
+	int depth;
+	std::array<void*, MaxFrames> frames;
+};
+
+// static storage - recording must not allocate
+std::array<Record, MaxViolations> s_records;
+std::atomic<std::size_t> s_count{0};
+
+// > 0 while we are inside the sanitizer or a ScopedAllow
+thread_local int s_suppressed = 0;
+
+bool shouldTrap()
+{
+	return s_suppressed == 0 && AudioEngine::isRenderingThread();
+}
+
+const char* violationName(Violation type)
+{
+	switch (type)
+	{
+		case Violation::Allocation: return "allocation";
+		case Violation::Deallocation: return "deallocation";
+		case Violation::Lock: return "mutex lock";
+		case Violation::FileIo: return "file I/O";
+	}
+	return "unknown";
+}
+
+void record(Violation type)
+{
+	// backtrace() itself may allocate when first called
+	++s_suppressed;
+
+	const auto index = s_count.fetch_add(1, std::memory_order_relaxed);
+	if (index < MaxViolations)
+	{
+		auto& r = s_records[index];
+		r.type = type;
+		r.depth = backtrace(r.frames.data(), MaxFrames);
+	}
+
+	static const bool abortOnViolation = std::getenv("LMMS_RTSAN_ABORT") != nullptr;
+	if (abortOnViolation)
+	{
+		std::fprintf(stderr, "RealtimeSanitizer: %s on audio thread\n", violationName(type));
+		if (index < MaxViolations)
+		{
+			backtrace_symbols_fd(s_records[index].frames.data(), s_records[index].depth, STDERR_FILENO);
+		}
+		std::abort();
+	}
+
+	--s_suppressed;
+}
+
+template<typename Fn>
+Fn realFunction(const char* name)
+{
+	++s_suppressed;
+	auto fn = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+	--s_suppressed;
+	return fn;
+}
+
+} // namespace
+
+
+
+
+std::size_t violationCount()
+{
+	return s_count.load(std::memory_order_relaxed);
+}
+
+
+
+
+void report(std::FILE* out)
+{
+	++s_suppressed;
+
+	const auto count = std::min(violationCount(), MaxViolations);
+	auto reported = std::array<bool, MaxViolations>{};
+
+	std::fprintf(out, "RealtimeSanitizer: %zu violation(s) on audio threads\n", violationCount());
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (reported[i]) { continue; }
+
+		const auto& r = s_records[i];
+		std::size_t occurrences = 0;
+		for (std::size_t j = i; j < count; ++j)
+		{
+			const auto& other = s_records[j];
+			if (other.type == r.type && other.depth == r.depth
+				&& std::equal(r.frames.begin(), r.frames.begin() + r.depth, other.frames.begin()))
+			{
+				reported[j] = true;
+				++occurrences;
+			}
+		}
+
+		std::fprintf(out, "\n%s, %zu time(s):\n", violationName(r.type), occurrences);
+		std::fflush(out);
+		backtrace_symbols_fd(r.frames.data(), r.depth, fileno(out));
+	}
+
+	--s_suppressed;
+}
+
+
+
+
+void reset()
+{
+	s_count.store(0, std::memory_order_relaxed);
+}
+
+
+
+
+ScopedAllow::ScopedAllow()
+{
+	++s_suppressed;
+}
+
+ScopedAllow::~ScopedAllow()
+{
+	--s_suppressed;
+}
+
+} // namespace lmms::RealtimeSanitizer
+
+
+
+
+using lmms::RealtimeSanitizer::Violation;
+using lmms::RealtimeSanitizer::record;
+using lmms::RealtimeSanitizer::realFunction;
+using lmms::RealtimeSanitizer::shouldTrap;
+
+extern "C"
+{
+
+void* malloc(std::size_t size)
+{
+	if (shouldTrap()) { record(Violation::Allocation); }
+	return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+	if (shouldTrap()) { record(Violation::Allocation); }
+	return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size)
+{
+	if (shouldTrap()) { record(Violation::Allocation); }
+	return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+	if (ptr && shouldTrap()) { record(Violation::Deallocation); }
+	__libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+	using Fn = int (*)(pthread_mutex_t*);
+	static const auto real = realFunction<Fn>("pthread_mutex_lock");
+	if (shouldTrap()) { record(Violation::Lock); }
+	return real(mutex);
+}
+
+int open(const char* path, int flags, ...)
+{
+	using Fn = int (*)(const char*, int, ...);
+	static const auto real = realFunction<Fn>("open");
+
+	mode_t mode = 0;
+	if (flags & (O_CREAT | O_TMPFILE))
+	{
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+
+	if (shouldTrap()) { record(Violation::FileIo); }
+	return real(path, flags, mode);
+}
+
+FILE* fopen(const char* path, const char* mode)
+{
+	using Fn = FILE* (*)(const char*, const char*);
+	static const auto real = realFunction<Fn>("fopen");
+	if (shouldTrap()) { record(Violation::FileIo); }
+	return real(path, mode);
+}
+
+ssize_t read(int fd, void* buf, std::size_t count)
+{
+	using Fn = ssize_t (*)(int, void*, std::size_t);
+	static const auto real = realFunction<Fn>("read");
+	if (shouldTrap()) { record(Violation::FileIo); }
+	return real(fd, buf, count);
+}
+
+ssize_t write(int fd, const void* buf, std::size_t count)
+{
+	using Fn = ssize_t (*)(int, const void*, std::size_t);
+	static const auto real = realFunction<Fn>("write");
+	if (shouldTrap()) { record(Violation::FileIo); }
+	return real(fd, buf, count);
+}
+
+} // extern "C"
+
+#endif // LMMS_DEBUG_RTSAN
@@ -0,0 +1,394 @@
+/*
+ * RenderServer.cpp - render projects on request from a local socket
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RenderServer.h"
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include "Engine.h"
+#include "RenderManager.h"
+#include "SampleBuffer.h"
+#include "Song.h"
+
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Decoded samples that no project uses anymore are dropped beyond this size
+constexpr std::size_t MaxCachedSampleBytes = std::size_t{1} << 30;
+
+//! Requests longer than this are rejected, so a broken client can't exhaust the memory
+constexpr qint64 MaxRequestLength = 64 * 1024;
+
+} // namespace
+
+
+
+
+RenderServer::RenderServer(QObject* parent)
+	: QObject(parent)
+	, m_server(new QLocalServer(this))
+{
+	m_server->setSocketOptions(QLocalServer::UserAccessOption);
+	connect(m_server, &QLocalServer::newConnection, this, &RenderServer::acceptConnection);
+
+	SampleBuffer::setCacheEnabled(true);
+}
+
+
+
+
+RenderServer::~RenderServer()
+{
+	SampleBuffer::setCacheEnabled(false);
+}
+
+
+
+
+bool RenderServer::listen(const QString& socketName)
+{
+	// remove a socket left behind by a server that crashed
+	QLocalServer::removeServer(socketName);
+	return m_server->listen(socketName);
+}
+
+
+
+
+QString RenderServer::errorString() const
+{
+	return m_server->errorString();
+}
+
+
+
+
+void RenderServer::acceptConnection()
+{
+	while (QLocalSocket* client = m_server->nextPendingConnection())
+	{
+		connect(client, &QLocalSocket::readyRead, this, [this, client] { readRequests(client); });
+		connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+	}
+}
+
+
+
+
+void RenderServer::readRequests(QLocalSocket* client)
+{
+	while (client->canReadLine())
+	{
+		const QByteArray line = client->readLine().trimmed();
+		if (!line.isEmpty())
+		{
+			handleRequest(client, line);
+		}
+	}
+
+	if (client->bytesAvailable() > MaxRequestLength)
+	{
+		replyError(client, QJsonValue{}, "Request too long");
+		client->disconnectFromServer();
+	}
+}
+
+
+
+
+void RenderServer::handleRequest(QLocalSocket* client, const QByteArray& line)
+{
+	auto parseError = QJsonParseError{};
+	const auto document = QJsonDocument::fromJson(line, &parseError);
+	if (!document.isObject())
+	{
+		replyError(client, QJsonValue{}, "Invalid request: " + parseError.errorString());
+		return;
+	}
+
+	const QJsonObject request = document.object();
+	const QJsonValue id = request.value("id");
+	const QString command = request.value("command").toString("render");
+
+	if (command == "status")
+	{
+		reply(client, id, {
+			{"status", "ok"},
+			{"queued", static_cast<int>(m_queue.size())},
+			{"busy", m_currentJob.has_value()}
+		});
+	}
+	else if (command == "shutdown")
+	{
+		m_shutdownRequested = true;
+		reply(client, id, {{"status", "ok"}});
+		if (!m_currentJob) { startNextJob(); }
+	}
+	else if (command == "render")
+	{
+		if (m_shutdownRequested)
+		{
+			replyError(client, id, "Server is shutting down");
+			return;
+		}
+
+		auto error = QString{};
+		auto job = parseJob(client, request, error);
+		if (!job)
+		{
+			replyError(client, id, error);
+			return;
+		}
+
+		m_queue.push_back(std::move(*job));
+		if (!m_currentJob) { startNextJob(); }
+	}
+	else
+	{
+		replyError(client, id, QString("Unknown command \"%1\"").arg(command));
+	}
+}
+
+
+
+
+auto RenderServer::parseJob(QLocalSocket* client, const QJsonObject& request, QString& error) const
+	-> std::optional<Job>
+{
+	const QString project = request.value("project").toString();
+	const QString output = request.value("output").toString();
+	if (project.isEmpty() || output.isEmpty())
+	{
+		error = "\"project\" and \"output\" are required";
+		return std::nullopt;
+	}
+	if (!QFileInfo{project}.isFile())
+	{
+		error = QString("Project %1 does not exist").arg(project);
+		return std::nullopt;
+	}
+
+	// same defaults and limits as the render action
+	auto outputSettings = OutputSettings{44100, 160, OutputSettings::BitDepth::Depth16Bit,
+		OutputSettings::StereoMode::JointStereo};
+
+	const int sampleRate = request.value("sampleRate").toInt(44100);
+	if (sampleRate < 44100 || sampleRate > 192000)
+	{
+		error = QString("Invalid samplerate %1").arg(sampleRate);
+		return std::nullopt;
+	}
+	outputSettings.setSampleRate(sampleRate);
+
+	const int bitrate = request.value("bitrate").toInt(160);
+	if (bitrate < 64 || bitrate > 384)
+	{
+		error = QString("Invalid bitrate %1").arg(bitrate);
+		return std::nullopt;
+	}
+	outputSettings.setBitrate(bitrate);
+
+	switch (request.value("bitDepth").toInt(16))
+	{
+		case 16: outputSettings.setBitDepth(OutputSettings::BitDepth::Depth16Bit); break;
+		case 24: outputSettings.setBitDepth(OutputSettings::BitDepth::Depth24Bit); break;
+		case 32: outputSettings.setBitDepth(OutputSettings::BitDepth::Depth32Bit); break;
+		default:
+			error = "Invalid bit depth";
+			return std::nullopt;
+	}
+
+	const QString stereoMode = request.value("stereoMode").toString("j");
+	if (stereoMode == "s") { outputSettings.setStereoMode(OutputSettings::StereoMode::Stereo); }
+	else if (stereoMode == "j") { outputSettings.setStereoMode(OutputSettings::StereoMode::JointStereo); }
+	else if (stereoMode == "m") { outputSettings.setStereoMode(OutputSettings::StereoMode::Mono); }
+	else
+	{
+		error = QString("Invalid stereo mode %1").arg(stereoMode);
+		return std::nullopt;
+	}
+
+	const QString extension = "." + request.value("format").toString("wav");
+	const auto device = std::find_if(ProjectRenderer::fileEncodeDevices.begin(),
+		ProjectRenderer::fileEncodeDevices.end(), [&](const auto& dev) {
+			return dev.isAvailable() && extension == dev.m_extension;
+		});
+	if (device == ProjectRenderer::fileEncodeDevices.end())
+	{
+		error = QString("Invalid output format %1").arg(extension.mid(1));
+		return std::nullopt;
+	}
+
+	return Job{
+		client,
+		request.value("id"),
+		project,
+		output,
+		outputSettings,
+		device->m_fileFormat,
+		request.value("loop").toBool(false),
+		request.value("tracks").toBool(false)
+	};
+}
+
+
+
+
+void RenderServer::startNextJob()
+{
+	m_currentJob.reset();
+
+	if (m_shutdownRequested)
+	{
+		for (const auto& job : m_queue)
+		{
+			replyError(job.client, job.id, "Server is shutting down");
+		}
+		m_queue.clear();
+		QCoreApplication::quit();
+		return;
+	}
+
+	while (!m_queue.empty())
+	{
+		auto& job = m_currentJob.emplace(std::move(m_queue.front()));
+		m_queue.pop_front();
+
+		m_jobTimer.start();
+
+		// Only the song is reset, the engine, plugins and cached samples stay loaded.
+		// Clearing first makes a project that fails to load show up as empty instead
+		// of rendering the previous one again.
+		const auto song = Engine::getSong();
+		song->setLoadOnLaunch(false);
+		song->clearProject();
+		song->loadProject(job.project);
+		if (song->isEmpty())
+		{
+			replyError(job.client, job.id, QString("The project %1 is empty or could not be loaded").arg(job.project));
+			m_currentJob.reset();
+			continue;
+		}
+		song->setExportLoop(job.loop);
+
+		QString outputPath = job.output;
+		if (job.tracks)
+		{
+			QDir{}.mkpath(outputPath);
+		}
+		else
+		{
+			const QString extension = ProjectRenderer::getFileExtensionFromFormat(job.format);
+			if (!outputPath.endsWith(extension)) { outputPath += extension; }
+			QFile::remove(outputPath);
+			job.output = outputPath;
+		}
+
+		m_loadTime = m_jobTimer.restart();
+
+		m_renderManager = std::make_unique<RenderManager>(job.outputSettings, job.format, outputPath);
+		connect(m_renderManager.get(), &RenderManager::finished, this, &RenderServer::finishJob);
+		if (job.tracks)
+		{
+			m_renderManager->renderTracks();
+		}
+		else
+		{
+			m_renderManager->renderProject();
+		}
+		return;
+	}
+}
+
+
+
+
+void RenderServer::finishJob()
+{
+	const auto& job = *m_currentJob;
+	const qint64 renderTime = m_jobTimer.elapsed();
+
+	if (!job.tracks && !QFileInfo{job.output}.isFile())
+	{
+		replyError(job.client, job.id, QString("Could not write %1").arg(job.output));
+	}
+	else
+	{
+		auto response = QJsonObject{
+			{"status", "ok"},
+			{"output", job.output},
+			{"loadMs", m_loadTime},
+			{"renderMs", renderTime}
+		};
+		if (Engine::getSong()->hasErrors())
+		{
+			response.insert("warnings", Engine::getSong()->errorSummary());
+		}
+		reply(job.client, job.id, response);
+	}
+
+	SampleBuffer::trimCache(MaxCachedSampleBytes);
+
+	// The render manager emitted the signal we are handling, so it can't be deleted right here
+	QTimer::singleShot(0, this, [this] {
+		m_renderManager.reset();
+		startNextJob();
+	});
+}
+
+
+
+
+void RenderServer::reply(QLocalSocket* client, const QJsonValue& id, QJsonObject response)
+{
+	// the client may have disconnected while its job was rendering
+	if (!client || client->state() != QLocalSocket::ConnectedState) { return; }
+
+	if (!id.isUndefined()) { response.insert("id", id); }
+	client->write(QJsonDocument{response}.toJson(QJsonDocument::Compact) + '\n');
+	client->flush();
+}
+
+
+
+
+void RenderServer::replyError(QLocalSocket* client, const QJsonValue& id, const QString& message)
+{
+	reply(client, id, {{"status", "error"}, {"message", message}});
+}
+
+
+} // namespace lmms
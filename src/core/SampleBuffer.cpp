@@ -24,9 +24,13 @@
 
 #include "SampleBuffer.h"
 
+#include <QDateTime>
 #include <QDebug>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <cstring>
+#include <map>
+#include <mutex>
 
 #include "GuiApplication.h"
 #include "PathUtil.h"
@@ -34,6 +38,28 @@
 
 namespace lmms {
 
+namespace {
+
+struct CachedBuffer
+{
+	std::shared_ptr<const SampleBuffer> buffer;
+	QDateTime lastModified;
+	qint64 fileSize;
+};
+
+// samples may be loaded from several threads at once
+std::mutex s_cacheMutex;
+bool s_cacheEnabled = false;
+std::map<QString, CachedBuffer> s_cache;
+
+// the stored path depends on the project, so it is part of the key
+QString cacheKey(const QString& absolutePath, const QString& storedPath)
+{
+	return absolutePath + '\n' + storedPath;
+}
+
+} // namespace
+
 SampleBuffer::SampleBuffer(const SampleFrame* data, size_t numFrames, int sampleRate)
 	: m_data(data, data + numFrames)
 	, m_sampleRate(sampleRate)
@@ -77,6 +103,21 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePa
 	const auto absolutePath = PathUtil::toAbsolute(filePath);
 	const auto storedPath = PathUtil::toShortestRelative(filePath);
 
+	const auto fileInfo = QFileInfo{absolutePath};
+	const auto key = cacheKey(absolutePath, storedPath);
+	{
+		const auto lock = std::lock_guard{s_cacheMutex};
+		if (s_cacheEnabled)
+		{
+			const auto it = s_cache.find(key);
+			if (it != s_cache.end() && it->second.lastModified == fileInfo.lastModified()
+				&& it->second.fileSize == fileInfo.size())
+			{
+				return it->second.buffer;
+			}
+		}
+	}
+
 	auto result = SampleDecoder::decode(absolutePath);
 
 	if (!result)
@@ -99,7 +140,14 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePa
 	}
 
 	auto& [data, sampleRate] = *result;
-	return std::make_shared<SampleBuffer>(std::move(data), sampleRate, storedPath);
+	auto buffer = std::make_shared<const SampleBuffer>(std::move(data), sampleRate, storedPath);
+
+	const auto lock = std::lock_guard{s_cacheMutex};
+	if (s_cacheEnabled)
+	{
+		s_cache[key] = CachedBuffer{buffer, fileInfo.lastModified(), fileInfo.size()};
+	}
+	return buffer;
 }
 
 std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str, int sampleRate)
@@ -130,4 +178,33 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str,
 	return std::make_shared<SampleBuffer>(std::move(data), sampleRate);
 }
 
+void SampleBuffer::setCacheEnabled(bool enabled)
+{
+	const auto lock = std::lock_guard{s_cacheMutex};
+	s_cacheEnabled = enabled;
+	if (!enabled) { s_cache.clear(); }
+}
+
+void SampleBuffer::trimCache(std::size_t maxBytes)
+{
+	const auto lock = std::lock_guard{s_cacheMutex};
+
+	auto bytes = std::size_t{0};
+	for (const auto& [key, entry] : s_cache)
+	{
+		bytes += entry.buffer->size() * sizeof(SampleFrame);
+	}
+
+	for (auto it = s_cache.begin(); it != s_cache.end() && bytes > maxBytes;)
+	{
+		// only the cache holds this buffer
+		if (it->second.buffer.use_count() == 1)
+		{
+			bytes -= it->second.buffer->size() * sizeof(SampleFrame);
+			it = s_cache.erase(it);
+		}
+		else { ++it; }
+	}
+}
+
 } // namespace lmms
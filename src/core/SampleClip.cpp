@@ -28,7 +28,9 @@
 #include <QFileInfo>
 
 #include "PathUtil.h"
+#include "ProjectContainer.h"
 #include "SampleClipView.h"
+#include "SampleRecordWriter.h"
 #include "SampleTrack.h"
 #include "Song.h"
 
@@ -64,6 +66,8 @@ SampleClip::SampleClip(Track* _track, Sample sample, bool isPlaying)
 			this, SLOT(playbackPositionChanged()), Qt::DirectConnection );
 	//care about Clip position
 	connect( this, SIGNAL(positionChanged()), this, SLOT(updateTrackClips()));
+	//the audio thread disarms recording when a take ends, so this may be queued
+	connect(&m_recordModel, &BoolModel::dataChanged, this, &SampleClip::updateRecordWriter);
 
 	updateTrackClips();
 }
@@ -102,6 +106,8 @@ SampleClip::SampleClip(const SampleClip& orig) :
 			this, SLOT(playbackPositionChanged()), Qt::DirectConnection );
 	//care about Clip position
 	connect( this, SIGNAL(positionChanged()), this, SLOT(updateTrackClips()));
+	//the audio thread disarms recording when a take ends, so this may be queued
+	connect(&m_recordModel, &BoolModel::dataChanged, this, &SampleClip::updateRecordWriter);
 
 	updateTrackClips();
 }
@@ -111,6 +117,8 @@ SampleClip::SampleClip(const SampleClip& orig) :
 
 SampleClip::~SampleClip()
 {
+	if (auto writer = m_recordWriter.exchange(nullptr)) { writer->finish(); }
+
 	auto sampletrack = dynamic_cast<SampleTrack*>(getTrack());
 	if ( sampletrack )
 	{
@@ -184,6 +192,33 @@ void SampleClip::toggleRecord()
 
 
 
+SampleRecordWriter* SampleClip::takeRecordWriter()
+{
+	return m_recordWriter.exchange(nullptr);
+}
+
+
+
+
+void SampleClip::updateRecordWriter()
+{
+	if (isRecord())
+	{
+		if (!m_recordWriter.load())
+		{
+			m_recordWriter = new SampleRecordWriter(this, Engine::audioEngine()->inputSampleRate());
+		}
+	}
+	else if (auto writer = m_recordWriter.exchange(nullptr))
+	{
+		// armed, but nothing was recorded
+		writer->finish();
+	}
+}
+
+
+
+
 void SampleClip::playbackPositionChanged()
 {
 	Engine::audioEngine()->removePlayHandlesOfTypes( getTrack(), PlayHandle::Type::SamplePlayHandle );
@@ -280,8 +315,7 @@ void SampleClip::saveSettings( QDomDocument & _doc, QDomElement & _this )
 	_this.setAttribute("autoresize", QString::number(getAutoResize()));
 	if( sampleFile() == "" )
 	{
-		QString s;
-		_this.setAttribute("data", m_sample.toBase64());
+		_this.setAttribute("data", ProjectContainer::saveSample(m_sample.buffer()));
 	}
 
 	_this.setAttribute( "sample_rate", m_sample.sampleRate());
@@ -320,7 +354,7 @@ void SampleClip::loadSettings( const QDomElement & _this )
 		auto sampleRate = _this.hasAttribute("sample_rate") ? _this.attribute("sample_rate").toInt() :
 			Engine::audioEngine()->outputSampleRate();
 
-		auto buffer = SampleBuffer::fromBase64(_this.attribute("data"), sampleRate);
+		auto buffer = ProjectContainer::loadSample(_this.attribute("data"), sampleRate);
 		m_sample = Sample(std::move(buffer));
 	}
 	changeLength( _this.attribute( "len" ).toInt() );
@@ -27,8 +27,8 @@
 #include "AudioEngine.h"
 #include "Engine.h"
 #include "PatternTrack.h"
-#include "SampleBuffer.h"
 #include "SampleClip.h"
+#include "SampleRecordWriter.h"
 
 
 namespace lmms
@@ -37,6 +37,7 @@ namespace lmms
 
 SampleRecordHandle::SampleRecordHandle( SampleClip* clip ) :
 	PlayHandle( Type::SamplePlayHandle ),
+	m_writer( clip->takeRecordWriter() ),
 	m_framesRecorded( 0 ),
 	m_minLength( clip->length() ),
 	m_track( clip->getTrack() ),
@@ -50,13 +51,8 @@ SampleRecordHandle::SampleRecordHandle( SampleClip* clip ) :
 
 SampleRecordHandle::~SampleRecordHandle()
 {
-	if (!m_buffers.empty()) { m_clip->setSampleBuffer(createSampleBuffer()); }
-
-	while( !m_buffers.empty() )
-	{
-		delete[] m_buffers.front().first;
-		m_buffers.erase( m_buffers.begin() );
-	}
+	// the clip gets the recorded file once everything is written
+	if( m_writer ) { m_writer->finish(); }
 	m_clip->setRecord( false );
 }
 
@@ -65,9 +61,12 @@ SampleRecordHandle::~SampleRecordHandle()
 
 void SampleRecordHandle::play( SampleFrame* /*_working_buffer*/ )
 {
+	// no writer was prepared for this take
+	if( !m_writer ) { return; }
+
 	const SampleFrame* recbuf = Engine::audioEngine()->inputBuffer();
 	const f_cnt_t frames = Engine::audioEngine()->inputBufferFrames();
-	writeBuffer( recbuf, frames );
+	m_writer->write( recbuf, frames );
 	m_framesRecorded += frames;
 
 	TimePos len = (tick_t)( m_framesRecorded / Engine::framesPerTick() );
@@ -103,41 +102,4 @@ f_cnt_t SampleRecordHandle::framesRecorded() const
 }
 
 
-
-
-std::shared_ptr<const SampleBuffer> SampleRecordHandle::createSampleBuffer()
-{
-	const f_cnt_t frames = framesRecorded();
-	// create buffer to store all recorded buffers in
-	auto bigBuffer = std::vector<SampleFrame>(frames);
-
-	// now copy all buffers into big buffer
-	auto framesCopied = 0;
-	for (const auto& [buf, numFrames] : m_buffers)
-	{
-		std::copy_n(buf, numFrames, bigBuffer.begin() + framesCopied);
-		framesCopied += numFrames;
-	}
-
-	// create according sample-buffer out of big buffer
-	return std::make_shared<const SampleBuffer>(std::move(bigBuffer), Engine::audioEngine()->inputSampleRate());
-}
-
-
-
-
-void SampleRecordHandle::writeBuffer( const SampleFrame* _ab, const f_cnt_t _frames )
-{
-	auto buf = new SampleFrame[_frames];
-	for( f_cnt_t frame = 0; frame < _frames; ++frame )
-	{
-		for( ch_cnt_t chnl = 0; chnl < DEFAULT_CHANNELS; ++chnl )
-		{
-			buf[frame][chnl] = _ab[frame][chnl];
-		}
-	}
-	m_buffers.push_back( qMakePair( buf, _frames ) );
-}
-
-
 } // namespace lmms
@@ -0,0 +1,160 @@
+/*
+ * SampleRecordWriter.cpp - streams recorded audio to a file
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleRecordWriter.h"
+
+#include <vector>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <sndfile.h>
+
+#include "ConfigManager.h"
+#include "SampleBuffer.h"
+#include "SampleClip.h"
+#include "lmmsconfig.h"
+
+namespace lmms
+{
+
+
+SampleRecordWriter::SampleRecordWriter(SampleClip* clip, sample_rate_t sampleRate) :
+	m_sampleRate(sampleRate),
+	m_clip(clip),
+	m_queue(static_cast<std::size_t>(sampleRate) * QueueSeconds),
+	m_wakeUp(0)
+{
+	connect(this, &QThread::finished, this, &QObject::deleteLater);
+
+	start(QThread::LowPriority);
+}
+
+
+
+
+void SampleRecordWriter::write(const SampleFrame* frames, f_cnt_t count)
+{
+	const auto written = m_queue.write(frames, count);
+	if (written < count)
+	{
+		m_framesDropped.fetch_add(count - static_cast<f_cnt_t>(written), std::memory_order_relaxed);
+	}
+	m_wakeUp.post();
+}
+
+
+
+
+void SampleRecordWriter::finish()
+{
+	m_finishing = true;
+	m_wakeUp.post();
+}
+
+
+
+
+void SampleRecordWriter::run()
+{
+	const QString dir = ConfigManager::inst()->userSamplesDir() + "recordings";
+	QDir{}.mkpath(dir);
+	const QString fileName = dir + "/recording-"
+		+ QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz") + ".wav";
+
+	// long takes exceed the 4 GiB a WAV file can hold
+	auto info = SF_INFO{};
+	info.samplerate = static_cast<int>(m_sampleRate);
+	info.channels = DEFAULT_CHANNELS;
+	info.format = SF_FORMAT_RF64 | SF_FORMAT_FLOAT;
+	SNDFILE* file = sf_open(
+#ifdef LMMS_BUILD_WIN32
+		fileName.toLocal8Bit().constData(),
+#else
+		fileName.toUtf8().constData(),
+#endif
+		SFM_WRITE, &info);
+	if (!file)
+	{
+		qWarning() << "Could not create" << fileName << "for recording:" << sf_strerror(nullptr);
+	}
+	else
+	{
+		// short takes stay plain WAV files, which more programs can read
+		sf_command(file, SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+	}
+
+	auto reader = LocklessRingBufferReader<SampleFrame>{m_queue};
+	auto chunk = std::vector<SampleFrame>(m_queue.capacity());
+	f_cnt_t framesWritten = 0;
+	while (true)
+	{
+		m_wakeUp.wait();
+
+		// read the flag first, so nothing queued before finish() is missed
+		const bool finishing = m_finishing;
+		while (true)
+		{
+			std::size_t count = 0;
+			{
+				const auto frames = reader.read_max(chunk.size());
+				count = frames.size();
+				for (std::size_t f = 0; f < count; ++f)
+				{
+					chunk[f] = frames[f];
+				}
+			}
+			if (count == 0) { break; }
+
+			if (file) { sf_writef_float(file, chunk.data()->data(), static_cast<sf_count_t>(count)); }
+			framesWritten += static_cast<f_cnt_t>(count);
+		}
+
+		if (finishing) { break; }
+	}
+
+	if (!file) { return; }
+	sf_close(file);
+
+	if (m_framesDropped > 0)
+	{
+		qWarning() << "Recording" << fileName << "lost" << m_framesDropped.load() << "frames";
+	}
+
+	if (framesWritten == 0)
+	{
+		QFile::remove(fileName);
+		return;
+	}
+
+	// the clip refers to the file, so projects don't have to store the recording themselves
+	const auto buffer = SampleBuffer::fromFile(fileName);
+	QMetaObject::invokeMethod(this, [this, buffer] {
+		if (m_clip) { m_clip->setSampleBuffer(buffer); }
+	}, Qt::QueuedConnection);
+}
+
+
+} // namespace lmms
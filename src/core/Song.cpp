@@ -50,6 +50,7 @@
 #include "PatternStore.h"
 #include "PatternTrack.h"
 #include "PianoRoll.h"
+#include "ProjectContainer.h"
 #include "ProjectJournal.h"
 #include "ProjectNotes.h"
 #include "Scale.h"
@@ -1019,6 +1020,7 @@ void Song::loadProject( const QString & fileName )
 	setProjectFileName(fileName);
 
 	DataFile dataFile( m_fileName );
+	const auto containerScope = ProjectContainer::Scope{dataFile.container()};
 
 	bool cantLoadProject = false;
 	// if file could not be opened, head-node is null and we create
@@ -1219,6 +1221,13 @@ bool Song::saveProjectFile(const QString & filename, bool withResources)
 	DataFile dataFile( DataFile::Type::SongProject );
 	m_savingProject = true;
 
+	// samples are collected while saving instead of being embedded as Base64
+	if (dataFile.nameWithExtension(filename).endsWith(".mmpc"))
+	{
+		dataFile.setContainer(std::make_shared<ProjectContainer>());
+	}
+	const auto containerScope = ProjectContainer::Scope{dataFile.container()};
+
 	m_tempoModel.saveSettings( dataFile, dataFile.head(), "bpm" );
 	m_timeSigModel.saveSettings( dataFile, dataFile.head(), "timesig" );
 	m_masterVolumeModel.saveSettings( dataFile, dataFile.head(), "mastervol" );
@@ -1447,7 +1456,11 @@ void Song::removeController( Controller * controller )
 		m_controllers.erase(it);
 
 		emit controllerRemoved( controller );
-		delete controller;
+		{
+			// models connected to the controller are still read by the audio thread until the connections are gone
+			const auto guard = Engine::audioEngine()->requestChangesGuard();
+			delete controller;
+		}
 
 		this->setModified();
 	}
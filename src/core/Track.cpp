@@ -341,6 +341,7 @@ void Track::loadSettings(const QDomElement& element)
 Clip * Track::addClip( Clip * clip )
 {
 	m_clips.push_back( clip );
+	Clip::invalidateLayout();
 
 	emit clipAdded( clip );
 
@@ -360,6 +361,7 @@ void Track::removeClip( Clip * clip )
 	if( it != m_clips.end() )
 	{
 		m_clips.erase( it );
+		Clip::invalidateLayout();
 		if( Engine::getSong() )
 		{
 			Engine::getSong()->updateLength();
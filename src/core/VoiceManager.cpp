@@ -0,0 +1,203 @@
+/*
+ * VoiceManager.cpp - limits polyphony and keeps the audio engine within its CPU budget
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "VoiceManager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+#include "AudioEngineProfiler.h"
+#include "ConfigManager.h"
+#include "InstrumentTrack.h"
+#include "NotePlayHandle.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Length of the fade out of stolen voices
+constexpr auto StealFadeMs = 5;
+
+//! The profiler's load averaging needs about this many periods to reflect stolen voices
+constexpr auto HoldOffPeriods = 16;
+
+//! Voice count we avoid reallocating for on the audio thread
+constexpr auto ReservedVoices = std::size_t{1024};
+
+} // namespace
+
+
+
+
+VoiceManager::VoiceManager() :
+	m_enabled(ConfigManager::inst()->value("audioengine", "voicestealing", "1").toInt()),
+	m_loadTarget(std::clamp(ConfigManager::inst()->value("audioengine", "loadtarget", "85").toInt(), 10, 100)),
+	m_holdOff(0)
+{
+	m_voices.reserve(ReservedVoices);
+}
+
+
+
+
+std::size_t VoiceManager::process(const PlayHandleList& handles, const AudioEngineProfiler& profiler,
+	sample_rate_t sampleRate, bool limitLoad)
+{
+	m_voices.clear();
+	std::size_t untrackedVoices = 0;
+
+	for (PlayHandle* handle : handles)
+	{
+		if (handle->type() != PlayHandle::Type::NotePlayHandle) { continue; }
+
+		auto nph = static_cast<NotePlayHandle*>(handle);
+		// master notes of chords and arpeggios don't produce any sound themselves
+		if (nph->isMasterNote() || nph->isMuted() || nph->isFinished()) { continue; }
+		// stolen voices are fading out already, and voices beyond the reserve
+		// would make m_voices reallocate, so none of these are stolen
+		if (nph->isStolen() || m_voices.size() == ReservedVoices)
+		{
+			++untrackedVoices;
+			continue;
+		}
+
+		InstrumentTrack* track = nph->instrumentTrack();
+		m_voices.push_back({
+			nph,
+			track,
+			track->maxPolyphonyModel()->value(),
+			track->voicePriorityModel()->value(),
+			nph->isReleased(),
+			nph->getVolume() * nph->volumeLevel(nph->totalFramesPlayed()),
+			nph->totalFramesPlayed()
+		});
+	}
+
+	if (m_enabled)
+	{
+		const auto fadeFrames = static_cast<f_cnt_t>(sampleRate * StealFadeMs / 1000);
+
+		markOverPolyphony(m_voices);
+		stealMarked(fadeFrames);
+
+		if (m_holdOff > 0)
+		{
+			--m_holdOff;
+		}
+		else if (limitLoad)
+		{
+			const auto budget = voiceBudget(m_loadTarget, profiler.cpuLoad(),
+				profiler.detailLoad(AudioEngineProfiler::DetailType::Instruments), profiler.voiceLoad());
+			markOverBudget(m_voices, budget);
+			if (stealMarked(fadeFrames)) { m_holdOff = HoldOffPeriods; }
+		}
+	}
+
+	// stolen voices still render their fade out in this period
+	return untrackedVoices + m_voices.size();
+}
+
+
+
+
+bool VoiceManager::stealBefore(const Voice& a, const Voice& b)
+{
+	if (a.priority != b.priority) { return a.priority < b.priority; }
+	if (a.released != b.released) { return a.released; }
+	if (a.level != b.level) { return a.level < b.level; }
+	return a.age > b.age;
+}
+
+
+
+
+void VoiceManager::markOverPolyphony(std::vector<Voice>& voices)
+{
+	std::sort(voices.begin(), voices.end(), [](const Voice& a, const Voice& b) {
+		return a.track != b.track ? std::less<>{}(a.track, b.track) : stealBefore(a, b);
+	});
+
+	for (auto first = voices.begin(); first != voices.end(); )
+	{
+		const auto last = std::find_if(first, voices.end(),
+			[track = first->track](const Voice& v) { return v.track != track; });
+
+		const auto count = static_cast<int>(last - first);
+		const int maxPolyphony = first->maxPolyphony;
+		if (maxPolyphony > 0 && count > maxPolyphony)
+		{
+			std::for_each(first, first + (count - maxPolyphony), [](Voice& v) { v.steal = true; });
+		}
+
+		first = last;
+	}
+}
+
+
+
+
+void VoiceManager::markOverBudget(std::vector<Voice>& voices, std::size_t budget)
+{
+	if (voices.size() <= budget) { return; }
+
+	const auto toSteal = voices.size() - budget;
+	std::partial_sort(voices.begin(), voices.begin() + toSteal, voices.end(), stealBefore);
+	std::for_each(voices.begin(), voices.begin() + toSteal, [](Voice& v) { v.steal = true; });
+}
+
+
+
+
+std::size_t VoiceManager::voiceBudget(int loadTarget, int cpuLoad, int instrumentsLoad, float voiceLoad)
+{
+	if (cpuLoad <= loadTarget || voiceLoad <= 0) { return SIZE_MAX; }
+
+	// everything not caused by voices, e.g. effects and mixing, can't be reduced here.
+	// If that alone exceeds the target, only a single voice is left.
+	const auto otherLoad = std::max(cpuLoad - instrumentsLoad, 0);
+	const auto available = static_cast<float>(std::max(loadTarget - otherLoad, 0));
+	return std::max(static_cast<std::size_t>(available / voiceLoad), std::size_t{1});
+}
+
+
+
+
+bool VoiceManager::stealMarked(f_cnt_t fadeFrames)
+{
+	const auto stolen = std::partition(m_voices.begin(), m_voices.end(), [](const Voice& v) { return !v.steal; });
+	if (stolen == m_voices.end()) { return false; }
+
+	std::for_each(stolen, m_voices.end(), [fadeFrames](Voice& v) {
+		v.handle->lock();
+		v.handle->steal(fadeFrames);
+		v.handle->unlock();
+	});
+	m_voices.erase(stolen, m_voices.end());
+	return true;
+}
+
+} // namespace lmms
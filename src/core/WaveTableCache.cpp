@@ -0,0 +1,235 @@
+/*
+ * WaveTableCache.cpp - persistent cache for precomputed tables and FFTW wisdom
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "WaveTableCache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <fftw3.h>
+
+namespace lmms::WaveTableCache
+{
+
+namespace
+{
+
+constexpr char Magic[8] = {'L', 'M', 'M', 'S', 'W', 'T', 'C', '\0'};
+constexpr std::uint32_t FormatVersion = 1;
+
+//! The payload starts at this offset, so mapped tables are suitably aligned for SIMD loads
+constexpr std::size_t PayloadOffset = 64;
+
+struct Header
+{
+	char magic[8];
+	std::uint32_t formatVersion;
+	std::uint32_t payloadOffset;
+	std::uint64_t key;
+	std::uint64_t size;
+	std::uint64_t checksum;
+};
+
+static_assert(sizeof(Header) <= PayloadOffset);
+
+constexpr std::uint64_t FnvOffset = 0xcbf29ce484222325ull;
+constexpr std::uint64_t FnvPrime = 0x100000001b3ull;
+
+std::uint64_t combine(std::uint64_t hash, std::uint64_t value)
+{
+	return (hash ^ value) * FnvPrime;
+}
+
+//! FNV-1a over 64 bit words, fast enough to verify several megabytes on every start
+std::uint64_t checksum(const void* data, std::size_t size)
+{
+	auto hash = FnvOffset;
+	const auto bytes = static_cast<const unsigned char*>(data);
+	std::size_t i = 0;
+	for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+	{
+		std::uint64_t word;
+		std::memcpy(&word, bytes + i, sizeof(word));
+		hash = combine(hash, word);
+	}
+	for (; i < size; ++i)
+	{
+		hash = combine(hash, bytes[i]);
+	}
+	return hash;
+}
+
+QString filePath(const QString& name)
+{
+	return directory() + "/" + name;
+}
+
+QString wisdomPath()
+{
+	return filePath("fftwf-wisdom");
+}
+
+bool writeAtomically(const QString& path, const QByteArray& data)
+{
+	if (!QDir().mkpath(QFileInfo(path).absolutePath())) { return false; }
+
+	auto file = QSaveFile{path};
+	if (!file.open(QIODevice::WriteOnly)) { return false; }
+	if (file.write(data) != data.size())
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+// mapped files stay open until the process exits
+std::mutex s_mappedFilesMutex;
+std::vector<std::unique_ptr<QFile>> s_mappedFiles;
+
+QByteArray s_loadedWisdom;
+
+} // namespace
+
+
+
+
+QString directory()
+{
+	if (const char* dir = std::getenv("LMMS_CACHE_DIR"))
+	{
+		return QString::fromLocal8Bit(dir);
+	}
+	return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lmms";
+}
+
+
+
+
+std::uint64_t key(std::initializer_list<std::uint64_t> values)
+{
+	auto hash = FnvOffset;
+	for (const auto value : values)
+	{
+		hash = combine(hash, value);
+	}
+	// tables are stored in native byte order
+	const std::uint32_t byteOrder = 0x01020304;
+	return combine(hash, *reinterpret_cast<const unsigned char*>(&byteOrder));
+}
+
+
+
+
+const void* map(const QString& name, std::uint64_t key, std::size_t size)
+{
+	auto file = std::make_unique<QFile>(filePath(name));
+	if (!file->open(QIODevice::ReadOnly)) { return nullptr; }
+	if (static_cast<std::size_t>(file->size()) != PayloadOffset + size) { return nullptr; }
+
+	auto header = Header{};
+	if (file->read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) { return nullptr; }
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0
+		|| header.formatVersion != FormatVersion
+		|| header.payloadOffset != PayloadOffset
+		|| header.key != key
+		|| header.size != size)
+	{
+		return nullptr;
+	}
+
+	const uchar* payload = file->map(PayloadOffset, size);
+	if (!payload || checksum(payload, size) != header.checksum)
+	{
+		return nullptr;
+	}
+
+	const auto lock = std::lock_guard{s_mappedFilesMutex};
+	s_mappedFiles.push_back(std::move(file));
+	return payload;
+}
+
+
+
+
+bool store(const QString& name, std::uint64_t key, const void* data, std::size_t size)
+{
+	auto header = Header{};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.formatVersion = FormatVersion;
+	header.payloadOffset = PayloadOffset;
+	header.key = key;
+	header.size = size;
+	header.checksum = checksum(data, size);
+
+	auto contents = QByteArray(PayloadOffset, '\0');
+	std::memcpy(contents.data(), &header, sizeof(header));
+	contents.append(static_cast<const char*>(data), size);
+
+	return writeAtomically(filePath(name), contents);
+}
+
+
+
+
+bool loadFftwWisdom()
+{
+	auto file = QFile{wisdomPath()};
+	if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+	s_loadedWisdom = file.readAll();
+	if (!fftwf_import_wisdom_from_string(s_loadedWisdom.constData()))
+	{
+		s_loadedWisdom.clear();
+		return false;
+	}
+	return true;
+}
+
+
+
+
+void saveFftwWisdom()
+{
+	char* wisdom = fftwf_export_wisdom_to_string();
+	if (!wisdom) { return; }
+
+	const auto data = QByteArray{wisdom};
+	std::free(wisdom);
+
+	if (data != s_loadedWisdom && writeAtomically(wisdomPath(), data))
+	{
+		s_loadedWisdom = data;
+	}
+}
+
+} // namespace lmms::WaveTableCache
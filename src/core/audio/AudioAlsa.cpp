@@ -249,17 +249,45 @@ void AudioAlsa::run()
 	int outbuf_pos = 0;
 	int pcmbuf_size = m_periodSize * channels();
 
+	// if the hardware period matches ours, convert straight from the
+	// engine's buffer into the PCM buffer
+	const bool direct = zeroCopy() && m_periodSize == audioEngine()->framesPerPeriod();
+
+	const auto fetchNextBuffer = [&](const SampleFrame*& buf) -> fpp_t
+	{
+		if (zeroCopy()) { return getNextBufferView(buf); }
+		buf = temp;
+		return getNextBuffer(temp);
+	};
+
 	bool quit = false;
 	while( quit == false )
 	{
 		int_sample_t * ptr = pcmbuf;
 		int len = pcmbuf_size;
+		if (direct)
+		{
+			const SampleFrame* buf = nullptr;
+			const fpp_t frames = fetchNextBuffer(buf);
+			if (!frames)
+			{
+				quit = true;
+				memset(ptr, 0, len * sizeof(int_sample_t));
+			}
+			else
+			{
+				convertToS16(buf, frames, pcmbuf, m_convertEndian);
+				audioEngine()->profiler().addSkippedCopy(len * sizeof(int_sample_t));
+			}
+			len = 0;
+		}
 		while( len )
 		{
 			if( outbuf_pos == 0 )
 			{
 				// frames depend on the sample rate
-				const fpp_t frames = getNextBuffer( temp );
+				const SampleFrame* buf = nullptr;
+				const fpp_t frames = fetchNextBuffer(buf);
 				if( !frames )
 				{
 					quit = true;
@@ -269,7 +297,7 @@ void AudioAlsa::run()
 				}
 				outbuf_size = frames * channels();
 
-				convertToS16(temp, frames, outbuf, m_convertEndian);
+				convertToS16(buf, frames, outbuf, m_convertEndian);
 			}
 			int min_len = std::min(len, outbuf_size - outbuf_pos);
 			memcpy( ptr, outbuf + outbuf_pos,
@@ -26,6 +26,7 @@
 
 #include "AudioDevice.h"
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 
 namespace lmms
 {
@@ -35,7 +36,9 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 	m_sampleRate( _audioEngine->outputSampleRate() ),
 	m_channels( _channels ),
 	m_audioEngine( _audioEngine ),
-	m_buffer(new SampleFrame[audioEngine()->framesPerPeriod()])
+	m_zeroCopy(ConfigManager::inst()->value("audioengine", "zerocopyoutput", "1").toInt()),
+	m_buffer(new SampleFrame[audioEngine()->framesPerPeriod()]),
+	m_viewBuffer(nullptr)
 {
 }
 
@@ -45,6 +48,7 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 AudioDevice::~AudioDevice()
 {
 	delete[] m_buffer;
+	delete[] m_viewBuffer;
 	m_devMutex.tryLock();
 	unlock();
 }
@@ -75,6 +79,25 @@ fpp_t AudioDevice::getNextBuffer(SampleFrame* _ab)
 	return frames;
 }
 
+fpp_t AudioDevice::getNextBufferView(const SampleFrame*& buffer)
+{
+	// the previous view is not needed anymore
+	delete[] m_viewBuffer;
+	m_viewBuffer = nullptr;
+
+	const fpp_t frames = audioEngine()->framesPerPeriod();
+	buffer = audioEngine()->nextBuffer();
+
+	if (!buffer) { return 0; }
+
+	// without FIFO this is the engine's read buffer, which is only
+	// overwritten when we ask for the next period
+	if (audioEngine()->hasFifoWriter()) { m_viewBuffer = buffer; }
+
+	audioEngine()->profiler().addSkippedCopy(frames * sizeof(SampleFrame));
+	return frames;
+}
+
 
 
 
@@ -103,6 +103,7 @@ AudioJack::AudioJack(bool& successful, AudioEngine* audioEngineParam)
 	, m_midiClient(nullptr)
 	, m_tempOutBufs(new jack_default_audio_sample_t*[channels()])
 	, m_outBuf(new SampleFrame[audioEngine()->framesPerPeriod()])
+	, m_curBuf(m_outBuf)
 	, m_framesDoneInCurBuf(0)
 	, m_framesToDoInCurBuf(0)
 {
@@ -426,26 +427,40 @@ int AudioJack::processCallback(jack_nframes_t nframes)
 	}
 #endif
 
+	// In zero-copy mode m_curBuf points into the engine's buffer, so the
+	// only copy left is deinterleaving into the JACK ports. If JACK's period
+	// differs from ours, m_framesDoneInCurBuf acts as the cursor that carries
+	// the remainder of a period over to the next callback.
 	jack_nframes_t done = 0;
 	while (done < nframes && !m_stopped)
 	{
 		jack_nframes_t todo = std::min<jack_nframes_t>(nframes - done, m_framesToDoInCurBuf - m_framesDoneInCurBuf);
 		for (int c = 0; c < channels(); ++c)
 		{
-			jack_default_audio_sample_t* o = m_tempOutBufs[c];
+			jack_default_audio_sample_t* o = m_tempOutBufs[c] + done;
+			const SampleFrame* in = m_curBuf + m_framesDoneInCurBuf;
 			for (jack_nframes_t frame = 0; frame < todo; ++frame)
 			{
-				o[done + frame] = m_outBuf[m_framesDoneInCurBuf + frame][c];
+				o[frame] = in[frame][c];
 			}
 		}
 		done += todo;
 		m_framesDoneInCurBuf += todo;
 		if (m_framesDoneInCurBuf == m_framesToDoInCurBuf)
 		{
-			m_framesToDoInCurBuf = getNextBuffer(m_outBuf);
+			if (zeroCopy())
+			{
+				m_framesToDoInCurBuf = getNextBufferView(m_curBuf);
+			}
+			else
+			{
+				m_framesToDoInCurBuf = getNextBuffer(m_outBuf);
+				m_curBuf = m_outBuf;
+			}
 			m_framesDoneInCurBuf = 0;
 			if (!m_framesToDoInCurBuf)
 			{
+				m_curBuf = m_outBuf;
 				m_stopped = true;
 				break;
 			}
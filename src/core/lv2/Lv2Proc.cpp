@@ -368,6 +368,40 @@ void Lv2Proc::copyBuffersToCore(SampleFrame* buf,
 
 
 
+void Lv2Proc::copyBuffersFromCore(PlanarBuffer::View buf, unsigned firstChan, unsigned num)
+{
+	inPorts().m_left->copyBuffersFromCore(buf[firstChan], buf.frames());
+	if (num > 1)
+	{
+		// see the interleaved version
+		if (inPorts().m_right)
+		{
+			inPorts().m_right->copyBuffersFromCore(buf[firstChan + 1], buf.frames());
+		}
+		else
+		{
+			inPorts().m_left->averageWithBuffersFromCore(buf[firstChan + 1], buf.frames());
+		}
+	}
+}
+
+
+
+
+void Lv2Proc::copyBuffersToCore(PlanarBuffer::View buf, unsigned firstChan, unsigned num) const
+{
+	outPorts().m_left->copyBuffersToCore(buf[firstChan], buf.frames());
+	if (num > 1)
+	{
+		Lv2Ports::Audio* ap = outPorts().m_right
+			? outPorts().m_right : outPorts().m_left;
+		ap->copyBuffersToCore(buf[firstChan + 1], buf.frames());
+	}
+}
+
+
+
+
 void Lv2Proc::run(fpp_t frames)
 {
 	if (m_worker)
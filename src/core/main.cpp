@@ -68,8 +68,10 @@
 #include "MainWindow.h"
 #include "MixHelpers.h"
 #include "OutputSettings.h"
+#include "PluginCache.h"
 #include "ProjectRenderer.h"
 #include "RenderManager.h"
+#include "RenderServer.h"
 #include "Song.h"
 
 #ifdef LMMS_DEBUG_FPE
@@ -166,9 +168,12 @@ void printHelp()
 		"  compress <in>                         Compress file <in>\n"
 		"  render <project> [options...]         Render given project file\n"
 		"  rendertracks <project> [options...]   Render each track to a different file\n"
+		"  render-server <socket>                Keep running and render projects sent\n"
+		"                                        to the local socket <socket>\n"
 		"  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
 		"                                        Standard out is used if no output file\n"
-		"                                        is specified\n"
+		"                                        is specified. Converts between .mmpz\n"
+		"                                        and .mmpc depending on <out>\n"
 		"  makebundle <in> [out]                 Make a project bundle from the project\n"
 		"                                        file <in> saving the resulting bundle\n"
 		"                                        as <out>\n"
@@ -177,6 +182,8 @@ void printHelp()
 		"          caution).\n"
 		"  -c, --config <configfile>      Get the configuration from <configfile>\n"
 		"  -h, --help                     Show this usage information and exit.\n"
+		"      --rescan-plugins           Ignore the plugin cache and load all\n"
+		"          plugin libraries to find out which plugins they provide.\n"
 		"  -v, --version                  Show version information and exit.\n"
 		"\nOptions if no action is given:\n"
 		"      --geometry <geometry>      Specify the size and position of\n"
@@ -254,7 +261,7 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
-	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	QString fileToLoad, fileToImport, renderOut, renderServerSocket, profilerOutputFile, configFile;
 
 	// first of two command-line parsing stages
 	for (int i = 1; i < argc; ++i)
@@ -280,10 +287,18 @@ int main( int argc, char * * argv )
 			coreOnly = true;
 			renderTracks = true;
 		}
+		else if (arg == "render-server")
+		{
+			coreOnly = true;
+		}
 		else if (arg == "--allowroot")
 		{
 			allowRoot = true;
 		}
+		else if (arg == "--rescan-plugins")
+		{
+			PluginCache::setRescan(true);
+		}
 		else if (arg == "--geometry" || arg == "-geometry")
 		{
 			if (arg == "--geometry") { argv[i]++; } // Delete the first "-" so Qt recognize the option
@@ -392,12 +407,12 @@ int main( int argc, char * * argv )
 
 			if( argc > i+1 ) // output file specified
 			{
-				dataFile.writeFile( QString::fromLocal8Bit( argv[i+1] ) );
+				if (!dataFile.writeFile(QString::fromLocal8Bit(argv[i + 1]))) { return EXIT_FAILURE; }
 			}
 			else // no output file specified; use stdout
 			{
 				QTextStream ts( stdout );
-				dataFile.write( ts );
+				if (!dataFile.write(ts)) { return EXIT_FAILURE; }
 				fflush( stdout );
 			}
 
@@ -425,6 +440,10 @@ int main( int argc, char * * argv )
 				return usageError("No project bundle name given");
 			}
 		}
+		else if (arg == "--rescan-plugins")
+		{
+			// Ignore, processed earlier
+		}
 		else if( arg == "--allowroot" )
 		{
 			// Ignore, processed earlier
@@ -483,6 +502,17 @@ int main( int argc, char * * argv )
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 			renderOut = fileToLoad;
 		}
+		else if (arg == "render-server")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No socket specified");
+			}
+
+			renderServerSocket = QString::fromLocal8Bit(argv[i]);
+		}
 		else if( arg == "--loop" || arg == "-l" )
 		{
 			renderLoop = true;
@@ -710,9 +740,24 @@ int main( int argc, char * * argv )
 
 	bool destroyEngine = false;
 
+	if (!renderServerSocket.isEmpty())
+	{
+		Engine::init(true);
+		destroyEngine = true;
+
+		auto server = new RenderServer(app);
+		if (!server->listen(renderServerSocket))
+		{
+			printf("Could not listen on %s: %s\n", renderServerSocket.toUtf8().constData(),
+				server->errorString().toUtf8().constData());
+			return EXIT_FAILURE;
+		}
+		printf("Listening on %s\n", renderServerSocket.toUtf8().constData());
+		fflush(stdout);
+	}
 	// if we have an output file for rendering, just render the song
 	// without starting the GUI
-	if( !renderOut.isEmpty() )
+	else if( !renderOut.isEmpty() )
 	{
 		Engine::init( true );
 		destroyEngine = true;
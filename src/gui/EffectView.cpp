@@ -195,6 +195,21 @@ void EffectView::contextMenuEvent( QContextMenuEvent * )
 						tr( "Move &down" ),
 						this, SLOT(moveDown()));
 	contextMenu->addSeparator();
+	if (effect()->supportsOversampling())
+	{
+		const auto model = effect()->oversamplingModel();
+		auto oversamplingMenu = contextMenu->addMenu(model->value() > 0
+			? tr("Oversampling (latency: %1 samples)").arg(effect()->oversamplingLatency(), 0, 'f', 1)
+			: tr("Oversampling"));
+		for (int stages = 0; stages <= Effect::MaxOversamplingStages; ++stages)
+		{
+			auto action = oversamplingMenu->addAction(stages == 0 ? tr("Off") : tr("%1x").arg(1 << stages),
+				[model, stages] { model->setValue(stages); });
+			action->setCheckable(true);
+			action->setChecked(model->value() == stages);
+		}
+		contextMenu->addSeparator();
+	}
 	contextMenu->addAction( embed::getIconPixmap( "cancel" ),
 						tr( "&Remove this plugin" ),
 						this, SLOT(deletePlugin()));
@@ -547,6 +547,23 @@ void MixerView::closeEvent(QCloseEvent * ce)
 
 
 
+void MixerView::showEvent(QShowEvent* se)
+{
+	// the channels only compute their peaks while somebody can see them
+	getMixer()->setMetered(true);
+	QWidget::showEvent(se);
+}
+
+
+
+void MixerView::hideEvent(QHideEvent* he)
+{
+	getMixer()->setMetered(false);
+	QWidget::hideEvent(he);
+}
+
+
+
 void MixerView::setCurrentMixerChannel(int channel)
 {
 	if (channel >= 0 && channel < m_mixerChannelViews.size())
@@ -44,6 +44,7 @@
 #include <QToolButton>
 
 #include <cmath>
+#include <ranges>
 #include <utility>
 
 #include "AutomationEditor.h"
@@ -5070,8 +5071,9 @@ Note * PianoRoll::noteUnderMouse()
 	int pos_ticks = (pos.x() - m_whiteKeyWidth) *
 			TimePos::ticksPerBar() / m_ppb + m_currentPosition;
 
-	// loop through whole note-vector...
-	for( Note* const& note : m_midiClip->notes() )
+	// loop through the notes at the cursor position...
+	const auto [first, last] = m_midiClip->notesInRange(pos_ticks, pos_ticks + 1);
+	for (Note* note : std::ranges::subrange(first, last))
 	{
 		// and check whether the cursor is over an
 		// existing note
@@ -396,6 +396,8 @@ void InstrumentTrackWindow::modelChanged()
 	m_tuningView->scaleCombo()->setModel(m_track->m_microtuner.scaleModel());
 	m_tuningView->keymapCombo()->setModel(m_track->m_microtuner.keymapModel());
 	m_tuningView->rangeImportCheckbox()->setModel(m_track->m_microtuner.keyRangeImportModel());
+	m_tuningView->maxPolyphonySpinBox()->setModel(m_track->maxPolyphonyModel());
+	m_tuningView->voicePrioritySpinBox()->setModel(m_track->voicePriorityModel());
 	updateName();
 
 	updateSubWindow();
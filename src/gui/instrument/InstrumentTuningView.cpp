@@ -35,6 +35,7 @@
 #include "GuiApplication.h"
 #include "FontHelper.h"
 #include "InstrumentTrack.h"
+#include "LcdSpinBox.h"
 #include "LedCheckBox.h"
 #include "MainWindow.h"
 #include "PixmapButton.h"
@@ -110,6 +111,28 @@ InstrumentTuningView::InstrumentTuningView(InstrumentTrack *it, QWidget *parent)
 	m_rangeImportCheckbox->setCheckable(true);
 	microtunerLayout->addWidget(m_rangeImportCheckbox);
 
+	// Voice allocation
+	auto voicesGroupBox = new QWidget(this);
+	layout->addWidget(voicesGroupBox);
+
+	auto voicesLayout = new QHBoxLayout(voicesGroupBox);
+	voicesLayout->setContentsMargins(8, 8, 8, 8);
+
+	m_maxPolyphonySpinBox = new LcdSpinBox(3, voicesGroupBox, tr("Max polyphony"));
+	m_maxPolyphonySpinBox->setModel(it->maxPolyphonyModel());
+	m_maxPolyphonySpinBox->setLabel(tr("VOICES"));
+	m_maxPolyphonySpinBox->setToolTip(tr("Maximum number of notes playing at the same time, 0 for unlimited. "
+		"The oldest or quietest notes are faded out when the limit is exceeded."));
+	voicesLayout->addWidget(m_maxPolyphonySpinBox);
+
+	m_voicePrioritySpinBox = new LcdSpinBox(2, voicesGroupBox, tr("Voice priority"));
+	m_voicePrioritySpinBox->setModel(it->voicePriorityModel());
+	m_voicePrioritySpinBox->setLabel(tr("PRIORITY"));
+	m_voicePrioritySpinBox->setToolTip(tr("When the CPU is overloaded, notes of instruments with a lower priority "
+		"are faded out first."));
+	voicesLayout->addWidget(m_voicePrioritySpinBox);
+	voicesLayout->addStretch();
+
 	// Fill remaining space
 	layout->addStretch();
 }
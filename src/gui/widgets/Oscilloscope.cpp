@@ -23,6 +23,8 @@
  */
 
 
+#include <algorithm>
+
 #include <QMouseEvent>
 #include <QPainter>
 
@@ -43,21 +45,25 @@ Oscilloscope::Oscilloscope( QWidget * _p ) :
 	QWidget( _p ),
 	m_background( embed::getIconPixmap( "output_graph" ) ),
 	m_points( new QPointF[Engine::audioEngine()->framesPerPeriod()] ),
+	m_buffer( Engine::audioEngine()->framesPerPeriod() ),
+	m_snapshotIndex( 0 ),
+	m_writtenSnapshot( 1 ),
+	m_paintedSnapshot( 2 ),
 	m_active( false ),
+	m_tapSubscription( 0 ),
 	m_leftChannelColor(71, 253, 133),
 	m_rightChannelColor(71, 253, 133),
 	m_otherChannelsColor(71, 253, 133),
 	m_clippingColor(255, 64, 64)
 {
+	for( auto& snapshot : m_snapshots )
+	{
+		snapshot.resize( m_buffer.size() );
+	}
+
 	setFixedSize( m_background.width(), m_background.height() );
 	setActive( ConfigManager::inst()->value( "ui", "displaywaveform").toInt() );
 
-	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
-	m_buffer = new SampleFrame[frames];
-
-	zeroSampleFrames(m_buffer, frames);
-
-
 	setToolTip(tr("Oscilloscope"));
 }
 
@@ -66,19 +72,29 @@ Oscilloscope::Oscilloscope( QWidget * _p ) :
 
 Oscilloscope::~Oscilloscope()
 {
-	delete[] m_buffer;
+	if( m_tapSubscription != 0 && Engine::audioEngine() )
+	{
+		Engine::audioEngine()->tapService()->unsubscribe(m_tapSubscription);
+	}
 	delete[] m_points;
 }
 
 
 
 
-void Oscilloscope::updateAudioBuffer(const SampleFrame* buffer)
+void Oscilloscope::updateAudioBuffer(const AudioTap::Analysis& analysis)
 {
 	if( !Engine::getSong()->isExporting() )
 	{
-		const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
-		memcpy(m_buffer, buffer, sizeof(SampleFrame) * fpp);
+		// only the latest period is drawn
+		const auto fpp = m_buffer.size();
+		const auto frames = std::min<std::size_t>(fpp, analysis.frameCount);
+		std::copy(m_buffer.begin() + frames, m_buffer.end(), m_buffer.begin());
+		std::copy_n(analysis.frames + analysis.frameCount - frames, frames, m_buffer.end() - frames);
+
+		// a snapshot that was not painted yet is outdated and gets overwritten next time
+		std::copy(m_buffer.begin(), m_buffer.end(), m_snapshots[m_writtenSnapshot].begin());
+		m_writtenSnapshot = m_snapshotIndex.exchange(m_writtenSnapshot | NewSnapshot) & ~NewSnapshot;
 	}
 }
 
@@ -88,23 +104,28 @@ void Oscilloscope::updateAudioBuffer(const SampleFrame* buffer)
 void Oscilloscope::setActive( bool _active )
 {
 	m_active = _active;
+	AudioEngine* audioEngine = Engine::audioEngine();
 	if( m_active )
 	{
 		connect( getGUI()->mainWindow(),
 					SIGNAL(periodicUpdate()),
 					this, SLOT(update()));
-		connect( Engine::audioEngine(),
-			SIGNAL(nextAudioBuffer(const lmms::SampleFrame*)),
-			this, SLOT(updateAudioBuffer(const lmms::SampleFrame*)));
+		if( m_tapSubscription == 0 )
+		{
+			m_tapSubscription = audioEngine->tapService()->subscribe(audioEngine->outputTap(),
+				[this](const AudioTap::Analysis& analysis) { updateAudioBuffer(analysis); });
+		}
 	}
 	else
 	{
 		disconnect( getGUI()->mainWindow(),
 					SIGNAL(periodicUpdate()),
 					this, SLOT(update()));
-		disconnect( Engine::audioEngine(),
-			SIGNAL(nextAudioBuffer(const lmms::SampleFrame*)),
-			this, SLOT(updateAudioBuffer(const lmms::SampleFrame*)));
+		if( m_tapSubscription != 0 && audioEngine )
+		{
+			audioEngine->tapService()->unsubscribe(m_tapSubscription);
+		}
+		m_tapSubscription = 0;
 		// we have to update (remove last waves),
 		// because timer doesn't do that anymore
 		update();
@@ -165,8 +186,14 @@ void Oscilloscope::paintEvent( QPaintEvent * )
 
 		float masterOutput = audioEngine->masterGain();
 
-		const fpp_t frames = audioEngine->framesPerPeriod();
-		SampleFrame peakValues = getAbsPeakValues(m_buffer, frames);
+		if( m_snapshotIndex.load() & NewSnapshot )
+		{
+			m_paintedSnapshot = m_snapshotIndex.exchange( m_paintedSnapshot ) & ~NewSnapshot;
+		}
+		const SampleFrame* buffer = m_snapshots[m_paintedSnapshot].data();
+
+		const fpp_t frames = m_snapshots[m_paintedSnapshot].size();
+		SampleFrame peakValues = getAbsPeakValues(buffer, frames);
 
 		auto const leftChannelClips = clips(peakValues.left() * masterOutput);
 		auto const rightChannelClips = clips(peakValues.right() * masterOutput);
@@ -190,7 +217,7 @@ void Oscilloscope::paintEvent( QPaintEvent * )
 
 			for (auto frame = std::size_t{0}; frame < frames; ++frame)
 			{
-				sample_t const clippedSample = AudioEngine::clip(m_buffer[frame][ch]);
+				sample_t const clippedSample = AudioEngine::clip(buffer[frame][ch]);
 				m_points[frame] = QPointF(
 					x_base + static_cast<qreal>(frame) * xd,
 					y_base + ( static_cast<qreal>(clippedSample) * half_h ) );
@@ -65,6 +65,8 @@ InstrumentTrack::InstrumentTrack(TrackContainer* tc) :
 	m_pitchRangeModel(1, 1, 60, this, tr("Pitch range")),
 	m_mixerChannelModel(0, 0, 0, this, tr("Mixer channel")),
 	m_useMasterPitchModel(true, this, tr("Master pitch")),
+	m_maxPolyphonyModel(0, 0, 256, this, tr("Max polyphony")),
+	m_voicePriorityModel(5, 0, 10, this, tr("Voice priority")),
 	m_instrument(nullptr),
 	m_soundShaping(this),
 	m_arpeggio(this),
@@ -754,24 +756,11 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 			cur_start -= c->startPosition() + c->startTimeOffset();
 		}
 
-		// get all notes from the given clip...
-		const NoteVector & notes = c->notes();
-		// ...and set our index to zero
-		auto nit = notes.begin();
+		// only look at notes sounding at the current tick, which includes those
+		// starting now and, at the clip start, those starting before it
+		auto [nit, notesEnd] = c->notesInRange(cur_start, cur_start + 1);
 
-		// very effective algorithm for playing notes that are
-		// posated within the current sample-frame
-
-		if( cur_start > 0 )
-		{
-			// skip notes which end before start-bar
-			while( nit != notes.end() && ( *nit )->endPos() < cur_start )
-			{
-				++nit;
-			}
-		}
-
-		while (nit != notes.end() && (*nit)->pos() < c->length() - c->startTimeOffset())
+		while (nit != notesEnd && (*nit)->pos() < c->length() - c->startTimeOffset())
 		{
 			const auto currentNote = *nit;
 			// Skip any notes note at the current time pos or not overlapping with the start.
@@ -842,6 +831,8 @@ void InstrumentTrack::saveTrackSpecificSettings(QDomDocument& doc, QDomElement&
 	m_firstKeyModel.saveSettings(doc, thisElement, "firstkey");
 	m_lastKeyModel.saveSettings(doc, thisElement, "lastkey");
 	m_useMasterPitchModel.saveSettings( doc, thisElement, "usemasterpitch");
+	m_maxPolyphonyModel.saveSettings(doc, thisElement, "maxpolyphony");
+	m_voicePriorityModel.saveSettings(doc, thisElement, "voicepriority");
 	m_microtuner.saveSettings(doc, thisElement);
 
 	// Save MIDI CC stuff
@@ -915,6 +906,8 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 	m_firstKeyModel.loadSettings(thisElement, "firstkey");
 	m_lastKeyModel.loadSettings(thisElement, "lastkey");
 	m_useMasterPitchModel.loadSettings( thisElement, "usemasterpitch");
+	m_maxPolyphonyModel.loadSettings(thisElement, "maxpolyphony");
+	m_voicePriorityModel.loadSettings(thisElement, "voicepriority");
 	m_microtuner.loadSettings(thisElement);
 
 	// clear effect-chain just in case we load an old preset without FX-data
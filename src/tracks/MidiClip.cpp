@@ -26,6 +26,7 @@
 #include "MidiClip.h"
 
 #include <algorithm>
+#include <limits>
 #include <QDomElement>
 
 #include "GuiApplication.h"
@@ -33,6 +34,7 @@
 #include "MidiClipView.h"
 #include "PatternStore.h"
 #include "PianoRoll.h"
+#include "ProjectJournal.h"
 
 
 
@@ -114,6 +116,8 @@ void MidiClip::init()
 {
 	connect( Engine::getSong(), SIGNAL(timeSignatureChanged(int,int)),
 				this, SLOT(changeTimeSignature()));
+	// editors change notes in place and notify us through dataChanged()
+	connect(this, &MidiClip::dataChanged, this, [this] { invalidateNoteIndex(); }, Qt::DirectConnection);
 	saveJournallingState( false );
 
 	updateLength();
@@ -125,6 +129,8 @@ void MidiClip::init()
 
 void MidiClip::updateLength()
 {
+	invalidateNoteIndex();
+
 	// If the clip hasn't already been manually resized, automatically resize it.
 	if (getAutoResize())
 	{
@@ -186,6 +192,7 @@ Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 
 	instrumentTrack()->lock();
 	m_notes.insert(std::upper_bound(m_notes.begin(), m_notes.end(), new_note, Note::lessThan), new_note);
+	invalidateNoteIndex();
 	instrumentTrack()->unlock();
 
 	checkType();
@@ -199,11 +206,40 @@ Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 
 
 
+void MidiClip::addNotes(const std::vector<Note>& notes)
+{
+	if (notes.empty()) { return; }
+
+	auto newNotes = NoteVector{};
+	newNotes.reserve(notes.size());
+	for (const auto& note : notes)
+	{
+		newNotes.push_back(note.clone());
+	}
+	std::stable_sort(newNotes.begin(), newNotes.end(), Note::lessThan);
+
+	instrumentTrack()->lock();
+	const auto oldSize = m_notes.size();
+	m_notes.insert(m_notes.end(), newNotes.begin(), newNotes.end());
+	std::inplace_merge(m_notes.begin(), m_notes.begin() + oldSize, m_notes.end(), Note::lessThan);
+	invalidateNoteIndex();
+	instrumentTrack()->unlock();
+
+	checkType();
+	updateLength();
+
+	emit dataChanged();
+}
+
+
+
+
 NoteVector::const_iterator MidiClip::removeNote(NoteVector::const_iterator it)
 {
 	instrumentTrack()->lock();
 	delete *it;
 	auto new_it = m_notes.erase(it);
+	invalidateNoteIndex();
 	instrumentTrack()->unlock();
 
 	checkType();
@@ -222,6 +258,7 @@ NoteVector::const_iterator MidiClip::removeNote(Note* note)
 	{
 		delete *it;
 		it = m_notes.erase(it);
+		invalidateNoteIndex();
 	}
 
 	instrumentTrack()->unlock();
@@ -254,6 +291,73 @@ void MidiClip::rearrangeAllNotes()
 {
 	// sort notes by start time
 	std::sort(m_notes.begin(), m_notes.end(), Note::lessThan);
+	invalidateNoteIndex();
+}
+
+
+
+
+MidiClip::NoteRange MidiClip::notesInRange(TimePos start, TimePos end) const
+{
+	// Don't wait if another thread is rebuilding the index, just let the caller check all notes
+	const auto lock = std::unique_lock{m_noteIndexMutex, std::try_to_lock};
+	if (!lock.owns_lock()) { return {m_notes.begin(), m_notes.end()}; }
+
+	const auto generation = m_noteGeneration.load(std::memory_order_acquire);
+	if (m_noteIndexGeneration != generation || m_notePositions.size() != m_notes.size())
+	{
+		rebuildNoteIndex(generation);
+	}
+	if (!m_notesSorted) { return {m_notes.begin(), m_notes.end()}; }
+
+	const auto first = std::lower_bound(m_noteMaxEnds.begin(), m_noteMaxEnds.end(), start.getTicks())
+		- m_noteMaxEnds.begin();
+	const auto last = std::lower_bound(m_notePositions.begin() + first, m_notePositions.end(), end.getTicks())
+		- m_notePositions.begin();
+
+	return {m_notes.begin() + first, m_notes.begin() + last};
+}
+
+
+
+
+void MidiClip::invalidateNoteIndex()
+{
+	// a rebuild that is running right now was started for the previous generation
+	m_noteGeneration.fetch_add(1, std::memory_order_release);
+
+	// Make room for the index here, so rebuilding it while playing doesn't allocate.
+	// The editing functions call this before releasing the track lock, so the
+	// audio thread can't see the new notes before, and it only tries to lock the mutex.
+	const auto lock = std::lock_guard{m_noteIndexMutex};
+	m_notePositions.reserve(m_notes.size());
+	m_noteMaxEnds.reserve(m_notes.size());
+}
+
+
+
+
+void MidiClip::rebuildNoteIndex(unsigned int generation) const
+{
+	// doesn't allocate, invalidateNoteIndex() reserved the space
+	m_notePositions.resize(m_notes.size());
+	m_noteMaxEnds.resize(m_notes.size());
+	m_notesSorted = true;
+
+	auto maxEnd = std::numeric_limits<tick_t>::min();
+	for (std::size_t i = 0; i < m_notes.size(); ++i)
+	{
+		const Note* note = m_notes[i];
+		m_notePositions[i] = note->pos();
+		// notes with a negative length still start at their position
+		maxEnd = std::max<tick_t>({maxEnd, note->pos(), note->endPos()});
+		m_noteMaxEnds[i] = maxEnd;
+
+		if (i > 0 && m_notePositions[i] < m_notePositions[i - 1]) { m_notesSorted = false; }
+	}
+
+	// changes made while rebuilding have a newer generation and cause another rebuild
+	m_noteIndexGeneration = generation;
 }
 
 
@@ -266,6 +370,7 @@ void MidiClip::clearNotes()
 		delete note;
 	}
 	m_notes.clear();
+	invalidateNoteIndex();
 	instrumentTrack()->unlock();
 
 	checkType();
@@ -532,6 +637,111 @@ void MidiClip::loadSettings( const QDomElement & _this )
 
 
 
+//! Everything loadSettings() restores, with the notes as plain values
+class MidiClip::JournalState : public JournalDelta
+{
+public:
+	explicit JournalState(const MidiClip& clip) :
+		m_type(clip.m_clipType),
+		m_name(clip.name()),
+		m_color(clip.color()),
+		m_pos(clip.startPosition()),
+		m_length(clip.length()),
+		m_startTimeOffset(clip.startTimeOffset()),
+		m_steps(clip.m_steps),
+		m_muted(clip.isMuted()),
+		m_autoResize(clip.getAutoResize())
+	{
+		m_notes.reserve(clip.m_notes.size());
+		for (const auto& note : clip.m_notes)
+		{
+			m_notes.push_back({note->pos(), note->length(), note->key(),
+				note->getVolume(), note->getPanning(), note->type()});
+		}
+	}
+
+	std::size_t size() const override
+	{
+		return sizeof(JournalState) + m_name.size() * sizeof(QChar) + m_notes.capacity() * sizeof(NoteState);
+	}
+
+	void restore(JournallingObject* object) const override
+	{
+		auto clip = static_cast<MidiClip*>(object);
+
+		clip->m_clipType = m_type;
+		clip->setName(m_name);
+		clip->setColor(m_color);
+		clip->movePosition(m_pos);
+		if (m_muted != clip->isMuted())
+		{
+			clip->toggleMute();
+		}
+
+		clip->instrumentTrack()->lock();
+		for (const auto& note : clip->m_notes)
+		{
+			delete note;
+		}
+		clip->m_notes.clear();
+		clip->m_notes.reserve(m_notes.size());
+		for (const auto& state : m_notes)
+		{
+			auto note = new Note(state.length, state.pos, state.key, state.volume, state.panning);
+			note->setType(state.type);
+			clip->m_notes.push_back(note);
+		}
+		clip->invalidateNoteIndex();
+		clip->instrumentTrack()->unlock();
+
+		clip->m_steps = m_steps;
+		clip->checkType();
+		clip->changeLength(m_length);
+		clip->setAutoResize(m_autoResize);
+		clip->setStartTimeOffset(m_startTimeOffset);
+
+		emit clip->dataChanged();
+	}
+
+private:
+	struct NoteState
+	{
+		TimePos pos;
+		TimePos length;
+		int key;
+		volume_t volume;
+		panning_t panning;
+		Note::Type type;
+	};
+
+	Type m_type;
+	QString m_name;
+	std::optional<QColor> m_color;
+	TimePos m_pos;
+	TimePos m_length;
+	TimePos m_startTimeOffset;
+	int m_steps;
+	bool m_muted;
+	bool m_autoResize;
+	std::vector<NoteState> m_notes;
+} ;
+
+
+
+
+std::unique_ptr<JournalDelta> MidiClip::saveJournalDelta()
+{
+	// detuning curves are automation clips themselves, keep storing them as XML
+	if (std::any_of(m_notes.begin(), m_notes.end(), [](const Note* note) { return note->hasDetuningInfo(); }))
+	{
+		return nullptr;
+	}
+	return std::make_unique<JournalState>(*this);
+}
+
+
+
+
 MidiClip *  MidiClip::previousMidiClip() const
 {
 	return adjacentMidiClipByOffset(-1);
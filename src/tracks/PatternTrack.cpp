@@ -23,6 +23,9 @@
  */
 #include "PatternTrack.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <QDomElement>
 
 #include "AudioEngine.h"
@@ -41,7 +44,11 @@ PatternTrack::infoMap PatternTrack::s_infoMap;
 
 
 PatternTrack::PatternTrack(TrackContainer* tc) :
-	Track(Track::Type::Pattern, tc)
+	Track(Track::Type::Pattern, tc),
+	m_timelineRevision(Clip::layoutRevision() - 1),
+	m_timelineTicksPerBar(0),
+	m_timelinePattern(0),
+	m_timelinePatternLength(0)
 {
 	int patternNum = s_infoMap.size();
 	s_infoMap[this] = patternNum;
@@ -76,6 +83,8 @@ PatternTrack::~PatternTrack()
 		}
 	}
 	s_infoMap.remove( this );
+	// the other pattern tracks may have been renumbered
+	Clip::invalidateLayout();
 
 	// remove us from the Song and update the pattern selection combobox to reflect the change
 	trackContainer()->removeTrack( this );
@@ -94,43 +103,72 @@ bool PatternTrack::play( const TimePos & _start, const fpp_t _frames,
 		return false;
 	}
 
+	updateTimeline();
+
 	if( _clip_num >= 0 )
 	{
-		return Engine::patternStore()->play(_start, _frames, _offset, s_infoMap[this]);
+		return Engine::patternStore()->play(_start, _frames, _offset, m_timelinePattern);
 	}
 
-	clipVector clips;
-	getClipsInRange( clips, _start, _start + static_cast<int>( _frames / Engine::framesPerTick() ) );
+	// of the clips overlapping this period, the one starting last is played
+	const tick_t start = _start.getTicks();
+	const tick_t end = start + static_cast<int>( _frames / Engine::framesPerTick() );
+	auto i = static_cast<std::ptrdiff_t>(std::upper_bound(m_timeline.begin(), m_timeline.end(), end,
+		[](tick_t ticks, const TimelineEntry& entry) { return ticks < entry.start; }) - m_timeline.begin()) - 1;
+	while (i >= 0 && m_timelineMaxEnd[i] >= start && m_timeline[i].end < start)
+	{
+		--i;
+	}
+	if (i < 0 || m_timelineMaxEnd[i] < start)
+	{
+		return false;
+	}
 
-	if( clips.size() == 0 )
+	const TimelineEntry& clip = m_timeline[i];
+	if (start - clip.start >= clip.end - clip.start)
 	{
 		return false;
 	}
 
-	TimePos lastPosition;
-	TimePos lastLength;
-	tick_t lastOffset = 0;
-	for (const auto& clip : clips)
+	tick_t offset = m_timelinePatternLength - (clip.startTimeOffset % m_timelinePatternLength);
+	if (offset == m_timelinePatternLength)
 	{
-		if (!clip->isMuted() && clip->startPosition() >= lastPosition)
-		{
-			lastPosition = clip->startPosition();
-			lastLength = clip->length();
-			tick_t patternLength = Engine::patternStore()->lengthOfPattern(static_cast<PatternClip*>(clip)->patternIndex())
-					* TimePos::ticksPerBar();
-			lastOffset = patternLength - (clip->startTimeOffset() % patternLength);
-			if (lastOffset == patternLength)
-			{
-				lastOffset = 0;
-			}
-		}
+		offset = 0;
+	}
+	return Engine::patternStore()->play(start - clip.start + offset, _frames, _offset, m_timelinePattern);
+}
+
+
+
+
+void PatternTrack::updateTimeline()
+{
+	const unsigned revision = Clip::layoutRevision();
+	if (revision == m_timelineRevision && TimePos::ticksPerBar() == m_timelineTicksPerBar) { return; }
+
+	m_timelineRevision = revision;
+	m_timelineTicksPerBar = TimePos::ticksPerBar();
+	m_timelinePattern = s_infoMap.value(this);
+	m_timelinePatternLength = Engine::patternStore()->lengthOfPattern(m_timelinePattern) * TimePos::ticksPerBar();
+
+	m_timeline.clear();
+	for (const Clip* clip : getClips())
+	{
+		if (clip->isMuted()) { continue; }
+		m_timeline.push_back({clip->startPosition().getTicks(), clip->endPosition().getTicks(),
+			clip->startTimeOffset().getTicks()});
 	}
+	// clips starting together keep their order, the last one of them wins like before
+	std::stable_sort(m_timeline.begin(), m_timeline.end(),
+		[](const TimelineEntry& a, const TimelineEntry& b) { return a.start < b.start; });
 
-	if( _start - lastPosition < lastLength )
+	m_timelineMaxEnd.resize(m_timeline.size());
+	tick_t maxEnd = std::numeric_limits<tick_t>::min();
+	for (std::size_t i = 0; i < m_timeline.size(); ++i)
 	{
-		return Engine::patternStore()->play(_start - lastPosition + lastOffset, _frames, _offset, s_infoMap[this]);
+		maxEnd = std::max(maxEnd, m_timeline[i].end);
+		m_timelineMaxEnd[i] = maxEnd;
 	}
-	return false;
 }
 
 
@@ -242,6 +280,7 @@ void PatternTrack::swapPatternTracks(Track* track1, Track* track2)
 	if( t1 != nullptr && t2 != nullptr )
 	{
 		qSwap( s_infoMap[t1], s_infoMap[t2] );
+		Clip::invalidateLayout();
 		Engine::patternStore()->swapPattern(s_infoMap[t1], s_infoMap[t2]);
 		Engine::patternStore()->setCurrentPattern(s_infoMap[t1]);
 	}
@@ -0,0 +1,745 @@
+/*
+ * LmmsBench.cpp - headless benchmark for the audio engine
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QCoreApplication>
+#include <QDomDocument>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <optional>
+#include <vector>
+
+#include "AudioBusHandle.h"
+#include "AudioDevice.h"
+#include "AudioEngine.h"
+#include "AutomationClip.h"
+#include "AutomationTrack.h"
+#include "ConfigManager.h"
+#include "DataFile.h"
+#include "DeprecationHelper.h"
+#include "Effect.h"
+#include "EffectChain.h"
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "Mixer.h"
+#include "RealtimeSanitizer.h"
+#include "SampleBuffer.h"
+#include "SampleClip.h"
+#include "SampleTrack.h"
+#include "Song.h"
+#include "lmmsconfig.h"
+
+#ifndef LMMS_BUILD_WIN32
+#include <sys/resource.h>
+#endif
+
+// Count every C++ allocation so we can report allocations per period
+namespace
+{
+std::atomic<std::uint64_t> s_allocations{0};
+}
+
+void* operator new(std::size_t size)
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) { return p; }
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+
+namespace lmms::bench
+{
+
+struct Options
+{
+	int periods = 2000;
+	int warmup = 100;
+	QStringList scenarios;
+	QStringList projects;
+	QList<int> workers;
+	QStringList loads;
+	//! Set in the child processes measuring a single loader
+	QString loader;
+	bool json = false;
+};
+
+struct Scenario
+{
+	QString name;
+	std::function<bool()> setup;
+};
+
+struct Result
+{
+	QString scenario;
+	int workers;
+	double p50Us;
+	double p99Us;
+	double maxUs;
+	double realtimeFactor;
+	double allocationsPerPeriod;
+	//! Realtime-safety violations, only counted in WANT_DEBUG_RTSAN builds
+	qint64 rtViolations;
+};
+
+struct LoadResult
+{
+	QString file;
+	QString loader;
+	double timeMs;
+	//! Growth of the peak resident memory while loading
+	double peakMiB;
+};
+
+
+constexpr int SongBars = 64;
+
+
+InstrumentTrack* addInstrumentTrack()
+{
+	auto track = dynamic_cast<InstrumentTrack*>(Track::create(Track::Type::Instrument, Engine::getSong()));
+	track->loadInstrument("tripleoscillator");
+	return track;
+}
+
+MidiClip* addMidiClip(InstrumentTrack* track)
+{
+	auto clip = dynamic_cast<MidiClip*>(track->createClip(TimePos{0}));
+	clip->changeLength(TimePos{SongBars, 0});
+	return clip;
+}
+
+//! Lots of tracks playing short notes
+bool setupManyTracks()
+{
+	for (int t = 0; t < 64; ++t)
+	{
+		auto clip = addMidiClip(addInstrumentTrack());
+		for (int beat = 0; beat < SongBars * 4; ++beat)
+		{
+			clip->addNote(Note{TimePos{DefaultTicksPerBar / 8}, TimePos{beat * DefaultTicksPerBar / 4},
+				DefaultKey + t % 24}, false);
+		}
+	}
+	return true;
+}
+
+//! Few tracks holding big chords
+bool setupPolyphony()
+{
+	for (int t = 0; t < 2; ++t)
+	{
+		auto clip = addMidiClip(addInstrumentTrack());
+		for (int bar = 0; bar < SongBars; ++bar)
+		{
+			for (int key = 0; key < 64; ++key)
+			{
+				clip->addNote(Note{TimePos{1, 0}, TimePos{bar, 0}, DefaultKey - 32 + key}, false);
+			}
+		}
+	}
+	return true;
+}
+
+//! Tracks feeding a long chain of mixer channels
+bool setupMixerRouting()
+{
+	constexpr int Depth = 48;
+	auto mixer = Engine::mixer();
+
+	int previous = -1;
+	int first = -1;
+	for (int i = 0; i < Depth; ++i)
+	{
+		const int channel = mixer->createChannel();
+		if (previous != -1)
+		{
+			mixer->deleteChannelSend(previous, 0);
+			mixer->createChannelSend(previous, channel);
+		}
+		else { first = channel; }
+		previous = channel;
+	}
+
+	for (int t = 0; t < 8; ++t)
+	{
+		auto track = addInstrumentTrack();
+		track->mixerChannelModel()->setValue(first);
+		auto clip = addMidiClip(track);
+		for (int bar = 0; bar < SongBars; ++bar)
+		{
+			clip->addNote(Note{TimePos{1, 0}, TimePos{bar, 0}, DefaultKey + t}, false);
+		}
+	}
+	return true;
+}
+
+//! Many automation clips modulating track parameters
+bool setupAutomation()
+{
+	std::vector<InstrumentTrack*> tracks;
+	for (int t = 0; t < 16; ++t)
+	{
+		auto track = addInstrumentTrack();
+		auto clip = addMidiClip(track);
+		for (int bar = 0; bar < SongBars; ++bar)
+		{
+			clip->addNote(Note{TimePos{1, 0}, TimePos{bar, 0}, DefaultKey + t}, false);
+		}
+		tracks.push_back(track);
+	}
+
+	for (int a = 0; a < 256; ++a)
+	{
+		auto track = dynamic_cast<AutomationTrack*>(Track::create(Track::Type::Automation, Engine::getSong()));
+		auto clip = dynamic_cast<AutomationClip*>(track->createClip(TimePos{0}));
+		clip->setProgressionType(AutomationClip::ProgressionType::Linear);
+		clip->addObject(a % 2 ? tracks[a % tracks.size()]->volumeModel() : tracks[a % tracks.size()]->panningModel());
+		for (int bar = 0; bar <= SongBars; ++bar)
+		{
+			clip->putValue(TimePos{bar, 0}, bar % 2 ? 100.f : 0.f, false);
+		}
+	}
+	return true;
+}
+
+//! Sample tracks playing long, generated audio
+bool setupLargeSamples()
+{
+	const auto sampleRate = Engine::audioEngine()->outputSampleRate();
+	const auto frames = static_cast<std::size_t>(sampleRate) * 120;
+
+	for (int t = 0; t < 8; ++t)
+	{
+		auto data = std::vector<SampleFrame>(frames);
+		const float freq = 110.f * (t + 1);
+		for (std::size_t f = 0; f < frames; ++f)
+		{
+			const float v = 0.2f * std::sin(2.f * 3.14159265f * freq * f / sampleRate);
+			data[f] = SampleFrame{v, v};
+		}
+
+		auto track = Track::create(Track::Type::Sample, Engine::getSong());
+		auto clip = dynamic_cast<SampleClip*>(track->createClip(TimePos{0}));
+		clip->setSampleBuffer(std::make_shared<SampleBuffer>(std::move(data), sampleRate));
+		clip->changeLength(TimePos{SongBars, 0});
+	}
+	return true;
+}
+
+//! Tracks running a wave shaper oversampled by 2 ^ stages, to compare the cost per factor
+bool setupOversampling(int stages)
+{
+	for (int t = 0; t < 16; ++t)
+	{
+		auto track = addInstrumentTrack();
+		auto clip = addMidiClip(track);
+		for (int bar = 0; bar < SongBars; ++bar)
+		{
+			clip->addNote(Note{TimePos{1, 0}, TimePos{bar, 0}, DefaultKey + t}, false);
+		}
+
+		auto chain = track->audioBusHandle()->effects();
+		auto key = EffectKey{};
+		auto effect = Effect::instantiate("waveshaper", chain, &key);
+		if (!effect) { return false; }
+		effect->oversamplingModel()->setValue(stages);
+		chain->appendEffect(effect);
+	}
+	return true;
+}
+
+std::vector<Scenario> builtinScenarios()
+{
+	auto scenarios = std::vector<Scenario>{
+		{"many-tracks", setupManyTracks},
+		{"polyphony", setupPolyphony},
+		{"mixer-routing", setupMixerRouting},
+		{"automation", setupAutomation},
+		{"large-samples", setupLargeSamples},
+	};
+	for (int stages = 0; stages <= Effect::MaxOversamplingStages; ++stages)
+	{
+		scenarios.push_back({QString{"oversampling-%1x"}.arg(1 << stages), [stages] {
+			return setupOversampling(stages);
+		}});
+	}
+	return scenarios;
+}
+
+
+
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+	if (sorted.empty()) { return 0; }
+	const auto index = static_cast<std::size_t>(std::ceil(p * sorted.size())) - 1;
+	return sorted[std::clamp<std::size_t>(index, 0, sorted.size() - 1)];
+}
+
+std::optional<Result> run(const Scenario& scenario, const Options& options, AudioDevice* device)
+{
+	auto song = Engine::getSong();
+	auto audioEngine = Engine::audioEngine();
+
+	song->clearProject();
+	if (!scenario.setup()) { return std::nullopt; }
+	song->startExport();
+
+	for (int i = 0; i < options.warmup; ++i)
+	{
+		device->processNextBuffer();
+	}
+
+	auto times = std::vector<double>();
+	times.reserve(options.periods);
+
+	const auto allocationsBefore = s_allocations.load();
+	const auto violationsBefore = RealtimeSanitizer::violationCount();
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < options.periods; ++i)
+	{
+		const auto periodStart = std::chrono::steady_clock::now();
+		device->processNextBuffer();
+		const auto periodEnd = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::micro>(periodEnd - periodStart).count());
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const auto allocations = s_allocations.load() - allocationsBefore;
+	const auto violations = RealtimeSanitizer::violationCount() - violationsBefore;
+
+	song->stopExport();
+
+	std::sort(times.begin(), times.end());
+
+	const double audioSeconds = static_cast<double>(options.periods) * audioEngine->framesPerPeriod()
+		/ audioEngine->outputSampleRate();
+
+	return Result{
+		scenario.name,
+		audioEngine->numWorkers() + 1,
+		percentile(times, 0.5),
+		percentile(times, 0.99),
+		times.empty() ? 0 : times.back(),
+		elapsed > 0 ? audioSeconds / elapsed : 0,
+		static_cast<double>(allocations) / std::max(options.periods, 1),
+		static_cast<qint64>(violations)
+	};
+}
+
+
+
+
+QJsonObject toJson(const Result& r)
+{
+	return QJsonObject{
+		{"scenario", r.scenario},
+		{"workers", r.workers},
+		{"p50_us", r.p50Us},
+		{"p99_us", r.p99Us},
+		{"max_us", r.maxUs},
+		{"realtime_factor", r.realtimeFactor},
+		{"allocations_per_period", r.allocationsPerPeriod},
+		{"rt_violations", r.rtViolations},
+	};
+}
+
+Result fromJson(const QJsonObject& o)
+{
+	return Result{
+		o["scenario"].toString(),
+		o["workers"].toInt(),
+		o["p50_us"].toDouble(),
+		o["p99_us"].toDouble(),
+		o["max_us"].toDouble(),
+		o["realtime_factor"].toDouble(),
+		o["allocations_per_period"].toDouble(),
+		static_cast<qint64>(o["rt_violations"].toDouble())
+	};
+}
+
+void printHeader()
+{
+	std::printf("%-24s %7s %10s %10s %10s %10s %12s %9s\n",
+		"scenario", "workers", "p50 [us]", "p99 [us]", "max [us]", "x realtime", "allocs/per.", "rt viol.");
+}
+
+void print(const Result& r, bool json)
+{
+	if (json)
+	{
+		std::printf("%s\n", QJsonDocument(toJson(r)).toJson(QJsonDocument::Compact).constData());
+	}
+	else
+	{
+		std::printf("%-24s %7d %10.1f %10.1f %10.1f %10.2f %12.1f %9lld\n", qPrintable(r.scenario), r.workers,
+			r.p50Us, r.p99Us, r.maxUs, r.realtimeFactor, r.allocationsPerPeriod,
+			static_cast<long long>(r.rtViolations));
+	}
+	std::fflush(stdout);
+}
+
+
+
+
+//! The worker count is fixed when the engine is created, so scaling runs
+//! re-execute the benchmark once per worker count and collect the results.
+int runScaling(const Options& options, const QStringList& args)
+{
+	auto results = std::vector<Result>();
+	for (const int workers : options.workers)
+	{
+		auto childArgs = args;
+		childArgs << "--workers" << QString::number(workers) << "--json";
+
+		QProcess child;
+		child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+		child.start(QCoreApplication::applicationFilePath(), childArgs);
+		if (!child.waitForFinished(-1) || child.exitCode() != 0)
+		{
+			std::fprintf(stderr, "benchmark with %d workers failed\n", workers);
+			return EXIT_FAILURE;
+		}
+
+		for (const auto& line : child.readAllStandardOutput().split('\n'))
+		{
+			const auto doc = QJsonDocument::fromJson(line);
+			if (doc.isObject()) { results.push_back(fromJson(doc.object())); }
+		}
+	}
+
+	if (!options.json) { printHeader(); }
+	for (const auto& r : results)
+	{
+		print(r, options.json);
+	}
+
+	if (!options.json)
+	{
+		// speedup relative to the first worker count of each scenario
+		std::printf("\n%-24s %7s %10s\n", "scenario", "workers", "speedup");
+		for (const auto& r : results)
+		{
+			const auto base = std::find_if(results.begin(), results.end(),
+				[&r](const Result& other) { return other.scenario == r.scenario; });
+			std::printf("%-24s %7d %10.2f\n", qPrintable(r.scenario), r.workers,
+				r.realtimeFactor / std::max(base->realtimeFactor, 1e-9));
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+
+
+
+//! Peak resident memory of the process in bytes, or 0 where unknown
+double peakMemory()
+{
+#ifdef LMMS_BUILD_WIN32
+	return 0;
+#else
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef LMMS_BUILD_APPLE
+	return static_cast<double>(usage.ru_maxrss);
+#else
+	return usage.ru_maxrss * 1024.;
+#endif
+#endif
+}
+
+bool load(const QString& loader, const QString& file)
+{
+	if (loader == "dom")
+	{
+		// How projects were read before DataFile parsed them as a stream:
+		// the whole file at once, retried uncompressed if it isn't plain XML
+		auto input = QFile{file};
+		if (!input.open(QIODevice::ReadOnly)) { return false; }
+		const QByteArray data = input.readAll();
+		auto doc = QDomDocument{};
+		return setContent(doc, data) || setContent(doc, qUncompress(data));
+	}
+	if (loader == "datafile")
+	{
+		return !DataFile{file}.documentElement().isNull();
+	}
+	if (loader == "song")
+	{
+		Engine::getSong()->loadProject(file);
+		return !Engine::getSong()->isEmpty();
+	}
+	return false;
+}
+
+std::optional<LoadResult> runLoad(const QString& loader, const QString& file)
+{
+	const double peakBefore = peakMemory();
+	const auto start = std::chrono::steady_clock::now();
+	if (!load(loader, file)) { return std::nullopt; }
+	const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return LoadResult{file, loader, elapsed, (peakMemory() - peakBefore) / (1024. * 1024.)};
+}
+
+QJsonObject toJson(const LoadResult& r)
+{
+	return QJsonObject{
+		{"file", r.file},
+		{"loader", r.loader},
+		{"time_ms", r.timeMs},
+		{"peak_mib", r.peakMiB},
+	};
+}
+
+//! The peak memory of a process only grows, so every loader is measured in a
+//! fresh process like the worker counts in runScaling().
+int runLoads(const Options& options)
+{
+	if (!options.json)
+	{
+		std::printf("%-40s %10s %10s %12s\n", "file", "loader", "time [ms]", "peak [MiB]");
+	}
+
+	for (const auto& file : options.loads)
+	{
+		for (const QString& loader : QStringList{"dom", "datafile", "song"})
+		{
+			QProcess child;
+			child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+			child.start(QCoreApplication::applicationFilePath(),
+				{"--load", file, "--loader", loader, "--json"});
+			if (!child.waitForFinished(-1) || child.exitCode() != 0)
+			{
+				std::fprintf(stderr, "loading %s with %s failed\n", qPrintable(file), qPrintable(loader));
+				return EXIT_FAILURE;
+			}
+
+			for (const auto& line : child.readAllStandardOutput().split('\n'))
+			{
+				const auto o = QJsonDocument::fromJson(line).object();
+				if (o.isEmpty()) { continue; }
+				if (options.json)
+				{
+					std::printf("%s\n", line.constData());
+				}
+				else
+				{
+					std::printf("%-40s %10s %10.1f %12.1f\n", qPrintable(o["file"].toString()),
+						qPrintable(o["loader"].toString()), o["time_ms"].toDouble(), o["peak_mib"].toDouble());
+				}
+			}
+			std::fflush(stdout);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+
+
+
+void printUsage()
+{
+	std::printf(
+		"Usage: lmms-bench [options]\n\n"
+		"Renders synthetic projects through the audio engine without a GUI\n"
+		"and reports per-period timing.\n\n"
+		"  --periods <n>          Number of measured periods (default: 2000)\n"
+		"  --warmup <n>           Periods rendered before measuring (default: 100)\n"
+		"  --scenario <name>      Only run the given scenario, may be repeated\n"
+		"  --project <file>       Also benchmark the given project file\n"
+		"  --workers <n[,n...]>   Render thread counts, e.g. 1,2,4,8\n"
+		"  --load <file>          Compare the time and peak memory of parsing the\n"
+		"                         file as a whole DOM (dom), with DataFile (datafile)\n"
+		"                         and of loading it into the song (song)\n"
+		"  --json                 Print one JSON object per result\n"
+		"  --list                 List built-in scenarios\n"
+		"  --help                 Show this help\n");
+}
+
+} // namespace lmms::bench
+
+
+
+
+int main(int argc, char** argv)
+{
+	using namespace lmms;
+	using namespace lmms::bench;
+
+	QCoreApplication app(argc, argv);
+
+	Options options;
+	QStringList forwardedArgs;
+	const auto args = app.arguments();
+	for (int i = 1; i < args.size(); ++i)
+	{
+		const auto& arg = args[i];
+		const bool hasValue = i + 1 < args.size();
+		if (arg == "--help" || arg == "-h")
+		{
+			printUsage();
+			return EXIT_SUCCESS;
+		}
+		else if (arg == "--list")
+		{
+			for (const auto& scenario : builtinScenarios())
+			{
+				std::printf("%s\n", qPrintable(scenario.name));
+			}
+			return EXIT_SUCCESS;
+		}
+		else if (arg == "--json") { options.json = true; }
+		else if (arg == "--periods" && hasValue)
+		{
+			options.periods = args[++i].toInt();
+			forwardedArgs << arg << args[i];
+		}
+		else if (arg == "--warmup" && hasValue)
+		{
+			options.warmup = args[++i].toInt();
+			forwardedArgs << arg << args[i];
+		}
+		else if (arg == "--scenario" && hasValue)
+		{
+			options.scenarios << args[++i];
+			forwardedArgs << arg << args[i];
+		}
+		else if (arg == "--project" && hasValue)
+		{
+			options.projects << args[++i];
+			forwardedArgs << arg << args[i];
+		}
+		else if (arg == "--load" && hasValue) { options.loads << args[++i]; }
+		else if (arg == "--loader" && hasValue) { options.loader = args[++i]; }
+		else if (arg == "--workers" && hasValue)
+		{
+			for (const auto& n : args[++i].split(',', Qt::SkipEmptyParts))
+			{
+				options.workers << std::max(n.toInt(), 1);
+			}
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown or incomplete option %s\n", qPrintable(arg));
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!options.loads.isEmpty() && options.loader.isEmpty()) { return runLoads(options); }
+	if (options.workers.size() > 1) { return runScaling(options, forwardedArgs); }
+
+	auto scenarios = std::vector<Scenario>();
+	for (auto& scenario : builtinScenarios())
+	{
+		if (options.scenarios.isEmpty() || options.scenarios.contains(scenario.name))
+		{
+			scenarios.push_back(std::move(scenario));
+		}
+	}
+	for (const auto& project : options.projects)
+	{
+		scenarios.push_back({project, [project] {
+			Engine::getSong()->loadProject(project);
+			return !Engine::getSong()->isEmpty();
+		}});
+	}
+
+	if (!options.workers.isEmpty())
+	{
+		ConfigManager::inst()->setValue("audioengine", "renderthreads", QString::number(options.workers.front()));
+	}
+
+	Engine::init(true);
+
+	if (!options.loader.isEmpty())
+	{
+		int status = EXIT_SUCCESS;
+		for (const auto& file : options.loads)
+		{
+			if (const auto result = runLoad(options.loader, file))
+			{
+				std::printf("%s\n", QJsonDocument(toJson(*result)).toJson(QJsonDocument::Compact).constData());
+			}
+			else
+			{
+				std::fprintf(stderr, "Could not load %s\n", qPrintable(file));
+				status = EXIT_FAILURE;
+			}
+		}
+		Engine::destroy();
+		return status;
+	}
+
+	// Drive the engine ourselves instead of letting a device thread pace it
+	auto device = new AudioDevice(DEFAULT_CHANNELS, Engine::audioEngine());
+	Engine::audioEngine()->setAudioDevice(device, false, true);
+
+	if (!options.json) { printHeader(); }
+	int status = EXIT_SUCCESS;
+	for (const auto& scenario : scenarios)
+	{
+		if (const auto result = run(scenario, options, device))
+		{
+			print(*result, options.json);
+		}
+		else
+		{
+			std::fprintf(stderr, "Could not set up %s\n", qPrintable(scenario.name));
+			status = EXIT_FAILURE;
+		}
+	}
+
+	if (RealtimeSanitizer::violationCount() > 0)
+	{
+		RealtimeSanitizer::report(stderr);
+	}
+
+	Engine::destroy();
+	return status;
+}
@@ -0,0 +1,86 @@
+/*
+ * AlignedBufferPoolTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <cstdint>
+#include <vector>
+
+#include "AlignedBufferPool.h"
+
+class AlignedBufferPoolTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void testLadspaLayout()
+	{
+		using namespace lmms;
+
+		// two processors with two audio inputs, two audio outputs and a control port each,
+		// at a period size that is not a multiple of a cache line
+		constexpr std::size_t frames = 100;
+		constexpr std::size_t processors = 2;
+		const auto portSizes = std::vector<std::size_t>{frames, frames, frames, frames, 1};
+
+		auto pool = AlignedBufferPool(processors * portSizes.size(), frames);
+		auto buffers = std::vector<float*>{};
+		for (std::size_t proc = 0; proc < processors; ++proc)
+		{
+			for (const auto size : portSizes)
+			{
+				float* buffer = pool.allocate(size);
+				QVERIFY(buffer != nullptr);
+				QCOMPARE(reinterpret_cast<std::uintptr_t>(buffer) % AlignedBufferPool::Alignment, std::uintptr_t{0});
+				for (std::size_t i = 0; i < size; ++i) { buffer[i] = static_cast<float>(buffers.size()); }
+				buffers.push_back(buffer);
+			}
+		}
+		QVERIFY(pool.used() <= pool.capacity());
+
+		// the buffers don't overlap
+		for (std::size_t b = 0; b < buffers.size(); ++b)
+		{
+			const auto size = portSizes[b % portSizes.size()];
+			QCOMPARE(buffers[b][0], static_cast<float>(b));
+			QCOMPARE(buffers[b][size - 1], static_cast<float>(b));
+		}
+	}
+
+	void testExhausted()
+	{
+		using namespace lmms;
+
+		auto pool = AlignedBufferPool(2, 100);
+		QVERIFY(pool.allocate(100) != nullptr);
+		QVERIFY(pool.allocate(100) != nullptr);
+		QVERIFY(pool.allocate(1) == nullptr);
+
+		// larger than the buffers the pool was sized for
+		auto small = AlignedBufferPool(1, 10);
+		QVERIFY(small.allocate(100) == nullptr);
+	}
+};
+
+QTEST_GUILESS_MAIN(AlignedBufferPoolTest)
+#include "AlignedBufferPoolTest.moc"
@@ -0,0 +1,154 @@
+/*
+ * AudioTapTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <QMutex>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+
+#include "AudioEngine.h"
+#include "AudioTap.h"
+#include "Engine.h"
+
+class AudioTapTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testAnalysis()
+	{
+		using namespace lmms;
+		const auto service = Engine::audioEngine()->tapService();
+
+		auto tap = AudioTap{};
+		const auto frames = std::vector<SampleFrame>(256, SampleFrame{0.5f, -0.25f});
+		// nobody listens, so nothing is queued
+		tap.publish(frames.data(), frames.size());
+		QVERIFY(!tap.isSubscribed());
+
+		QMutex mutex;
+		f_cnt_t received = 0;
+		auto peak = SampleFrame{};
+		auto rms = SampleFrame{};
+		const int id = service->subscribe(tap, [&](const AudioTap::Analysis& analysis) {
+			QMutexLocker lock(&mutex);
+			received += analysis.frameCount;
+			peak = analysis.peak;
+			rms = analysis.rms;
+		});
+		QVERIFY(tap.isSubscribed());
+
+		tap.publish(frames.data(), frames.size());
+		QTRY_VERIFY([&] { QMutexLocker lock(&mutex); return received == frames.size(); }());
+
+		QMutexLocker lock(&mutex);
+		QCOMPARE(peak.left(), 0.5f);
+		QCOMPARE(peak.right(), 0.25f);
+		QCOMPARE(rms.left(), 0.5f);
+		QCOMPARE(rms.right(), 0.25f);
+		lock.unlock();
+
+		service->unsubscribe(id);
+		QVERIFY(!tap.isSubscribed());
+	}
+
+	void testSpectrum()
+	{
+		using namespace lmms;
+		const auto service = Engine::audioEngine()->tapService();
+
+		auto tap = AudioTap{};
+		QMutex mutex;
+		auto spectrum = std::vector<float>{};
+		bool plainSubscriberGotSpectrum = false;
+		const int first = service->subscribe(tap, [&](const AudioTap::Analysis& analysis) {
+			QMutexLocker lock(&mutex);
+			plainSubscriberGotSpectrum = !analysis.spectrum.empty();
+		});
+		const int second = service->subscribe(tap, [&](const AudioTap::Analysis& analysis) {
+			QMutexLocker lock(&mutex);
+			spectrum = analysis.spectrum;
+		}, true);
+
+		// a sine right in the middle of bin 64
+		constexpr int Bin = 64;
+		auto frames = std::vector<SampleFrame>(AudioTap::SpectrumSize);
+		for (auto f = std::size_t{0}; f < frames.size(); ++f)
+		{
+			frames[f] = SampleFrame{std::sin(2 * std::numbers::pi_v<float> * Bin * f / AudioTap::SpectrumSize)};
+		}
+		tap.publish(frames.data(), frames.size());
+		QTRY_VERIFY([&] { QMutexLocker lock(&mutex); return !spectrum.empty(); }());
+
+		QMutexLocker lock(&mutex);
+		QCOMPARE(spectrum.size(), std::size_t{AudioTap::SpectrumSize / 2 + 1});
+		QCOMPARE(static_cast<int>(std::max_element(spectrum.begin(), spectrum.end()) - spectrum.begin()), Bin);
+		// the spectrum is computed once and shared with everybody
+		QVERIFY(plainSubscriberGotSpectrum);
+		lock.unlock();
+
+		service->unsubscribe(first);
+		service->unsubscribe(second);
+	}
+
+	void testUnsubscribeFromCallback()
+	{
+		using namespace lmms;
+		const auto service = Engine::audioEngine()->tapService();
+
+		// callbacks run without the service's lock, so they may unsubscribe themselves
+		auto tap = AudioTap{};
+		std::atomic<int> calls = 0;
+		std::atomic<int> id = 0;
+		id = service->subscribe(tap, [&](const AudioTap::Analysis&) {
+			++calls;
+			service->unsubscribe(id);
+		});
+
+		const auto frames = std::vector<SampleFrame>(256);
+		tap.publish(frames.data(), frames.size());
+		QTRY_COMPARE(calls.load(), 1);
+		QVERIFY(!tap.isSubscribed());
+
+		tap.publish(frames.data(), frames.size());
+		QTest::qWait(50);
+		QCOMPARE(calls.load(), 1);
+	}
+};
+
+QTEST_GUILESS_MAIN(AudioTapTest)
+#include "AudioTapTest.moc"
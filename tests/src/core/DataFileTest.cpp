@@ -0,0 +1,175 @@
+/*
+ * DataFileTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include "DataFile.h"
+#include "Engine.h"
+#include "Note.h"
+
+class DataFileTest : public QObject
+{
+	Q_OBJECT
+private:
+	static QByteArray oldProject()
+	{
+		// version 21 is the first one needing mixerRename
+		return R"(<?xml version="1.0"?>
+<!DOCTYPE lmms-project>
+<lmms-project version="21" type="song" creator="LMMS" creatorversion="1.2.2">
+  <head bpm="140"/>
+  <song>
+    <trackcontainer type="song">
+      <track type="1" name="Beat/Bassline 0">
+        <bbtrack><trackcontainer type="bbtrackcontainer"/></bbtrack>
+        <bbtco pos="0" len="192"/>
+      </track>
+      <track type="0" name="Lead">
+        <instrumenttrack fxch="2"/>
+        <pattern pos="0"><note pos="0" len="-192" key="57"/></pattern>
+      </track>
+    </trackcontainer>
+    <fxmixer><fxchannel num="0"/></fxmixer>
+    <!-- kept -->
+    <text><![CDATA[a < b]]></text>
+  </song>
+</lmms-project>
+)";
+	}
+
+	static void verifyUpgraded(const lmms::DataFile& dataFile)
+	{
+		using namespace lmms;
+
+		QCOMPARE(dataFile.type(), DataFile::Type::SongProject);
+		QVERIFY(dataFile.documentElement().attribute("version").toUInt() > 21);
+		QCOMPARE(dataFile.elementsByTagName("bbtco").size(), 0);
+		QCOMPARE(dataFile.elementsByTagName("patternclip").size(), 1);
+		QCOMPARE(dataFile.elementsByTagName("patterntrack").size(), 1);
+		QCOMPARE(dataFile.elementsByTagName("mixerchannel").size(), 1);
+		QCOMPARE(dataFile.elementsByTagName("midiclip").size(), 1);
+
+		const auto track = dataFile.elementsByTagName("track").item(0).toElement();
+		QCOMPARE(track.attribute("name"), QString{"Pattern 0"});
+
+		const auto instrumentTrack = dataFile.elementsByTagName("instrumenttrack").item(0).toElement();
+		QCOMPARE(instrumentTrack.attribute("mixch"), QString{"2"});
+		QVERIFY(!instrumentTrack.hasAttribute("fxch"));
+
+		const auto note = dataFile.elementsByTagName("note").item(0).toElement();
+		QCOMPARE(note.attribute("type").toInt(), static_cast<int>(Note::Type::Step));
+
+		const auto text = dataFile.elementsByTagName("text").item(0);
+		QVERIFY(text.firstChild().isCDATASection());
+		QCOMPARE(text.firstChild().nodeValue(), QString{"a < b"});
+		QVERIFY(text.previousSibling().isComment());
+	}
+
+	static QByteArray toUtf16(const QByteArray& utf8, bool bigEndian)
+	{
+		auto result = QByteArray{};
+		for (const QChar c : QString{QChar{0xFEFF}} + QString::fromUtf8(utf8))
+		{
+			const auto high = static_cast<char>(c.unicode() >> 8);
+			const auto low = static_cast<char>(c.unicode() & 0xFF);
+			result.append(bigEndian ? high : low);
+			result.append(bigEndian ? low : high);
+		}
+		return result;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testUpgradeWhileParsing()
+	{
+		verifyUpgraded(lmms::DataFile{oldProject()});
+	}
+
+	void testCompressed()
+	{
+		verifyUpgraded(lmms::DataFile{qCompress(oldProject())});
+	}
+
+	void testCompressedFile()
+	{
+		auto file = QTemporaryFile{QDir::tempPath() + "/DataFileTest-XXXXXX.mmpz"};
+		QVERIFY(file.open());
+		file.write(qCompress(oldProject()));
+		file.close();
+
+		verifyUpgraded(lmms::DataFile{file.fileName()});
+	}
+
+	void testCompressedLookingLikeXml()
+	{
+		// qUncompress only uses the size as a hint, so it can start
+		// with a whitespace followed by '<' without breaking the data
+		auto data = qCompress(oldProject());
+		data[0] = '\n';
+		data[1] = '<';
+		verifyUpgraded(lmms::DataFile{data});
+	}
+
+	void testUtf16()
+	{
+		verifyUpgraded(lmms::DataFile{toUtf16(oldProject(), false)});
+		verifyUpgraded(lmms::DataFile{toUtf16(oldProject(), true)});
+	}
+
+	void testCurrentVersion()
+	{
+		using namespace lmms;
+
+		auto saved = DataFile{DataFile::Type::SongProject};
+		saved.content().appendChild(saved.createElement("fxmixer"));
+
+		// nothing is upgraded in files of the current version
+		const auto loaded = DataFile{saved.toByteArray()};
+		QCOMPARE(loaded.type(), DataFile::Type::SongProject);
+		QCOMPARE(loaded.elementsByTagName("fxmixer").size(), 1);
+		QCOMPARE(loaded.doctype().name(), QString{"lmms-project"});
+	}
+
+	void testParseError()
+	{
+		using namespace lmms;
+
+		const auto dataFile = DataFile{QByteArray{"<lmms-project version=\"30\"><song></lmms-project>"}};
+		QVERIFY(dataFile.documentElement().isNull());
+	}
+};
+
+QTEST_GUILESS_MAIN(DataFileTest)
+#include "DataFileTest.moc"
@@ -0,0 +1,133 @@
+/*
+ * LfoControllerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "ControllerConnection.h"
+#include "Engine.h"
+#include "LfoController.h"
+
+namespace
+{
+
+//! Records the order in which controllers are rendered
+class RecordingController : public lmms::Controller
+{
+public:
+	RecordingController(std::vector<const lmms::Controller*>& log) :
+		Controller(ControllerType::Lfo, nullptr, "recording"),
+		m_knob(0.f, 0.f, 1.f, 0.01f, this),
+		m_log(log)
+	{
+	}
+
+	lmms::FloatModel& knob() { return m_knob; }
+
+protected:
+	void updateValueBuffer() override
+	{
+		m_log.push_back(this);
+		Controller::updateValueBuffer();
+	}
+
+private:
+	lmms::FloatModel m_knob;
+	std::vector<const lmms::Controller*>& m_log;
+};
+
+} // namespace
+
+class LfoControllerTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testSlowSineIsAccurate()
+	{
+		using namespace lmms;
+
+		// keep the audio engine from rendering periods meanwhile
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+
+		// the default LFO is a slow sine, which is rendered at control rate
+		LfoController lfo(nullptr);
+		FloatModel model;
+		model.setControllerConnection(new ControllerConnection(&lfo));
+
+		// start a period and render the connected controllers for it
+		Controller::triggerFrameCounter();
+		Controller::updateControllers();
+		const ValueBuffer* buffer = lfo.valueBuffer();
+		QVERIFY(buffer != nullptr);
+
+		const float duration = Engine::audioEngine()->outputSampleRate() * 2.f;
+		for (int f = 0; f < buffer->length(); ++f)
+		{
+			const float expected = 0.5f + std::sin(2 * std::numbers::pi_v<float> * f / duration) / 2;
+			QVERIFY(std::abs(buffer->value(f) - expected) < 1e-4f);
+		}
+	}
+
+	void testModulatedControllerFollowsModulator()
+	{
+		using namespace lmms;
+
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+
+		auto log = std::vector<const Controller*>{};
+		RecordingController modulated(log);
+		RecordingController modulator(log);
+
+		// connected in the order that makes the modulated controller come first in the list
+		FloatModel model;
+		model.setControllerConnection(new ControllerConnection(&modulated));
+		modulated.knob().setControllerConnection(new ControllerConnection(&modulator));
+
+		Controller::triggerFrameCounter();
+		Controller::updateControllers();
+
+		QCOMPARE(log.size(), std::size_t{2});
+		QCOMPARE(log[0], &modulator);
+		QCOMPARE(log[1], &modulated);
+	}
+};
+
+QTEST_GUILESS_MAIN(LfoControllerTest)
+#include "LfoControllerTest.moc"
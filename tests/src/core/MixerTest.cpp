@@ -0,0 +1,102 @@
+/*
+ * MixerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <QPointer>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Mixer.h"
+
+class MixerTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testReclaimBetweenPeriods()
+	{
+		using namespace lmms;
+		// keep the audio thread out of its periods, so only the ones started here are active
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		const auto mixer = Engine::mixer();
+
+		const int channel = mixer->createChannel();
+		const auto send = QPointer<MixerRoute>{mixer->createChannelSend(channel, 0)};
+		const auto channelModel = QPointer<BoolModel>{&mixer->mixerChannel(channel)->m_muteModel};
+
+		// nothing can use the routing, so everything is deleted right away
+		mixer->deleteChannel(channel);
+		QVERIFY(send.isNull());
+		QVERIFY(channelModel.isNull());
+		QCOMPARE(mixer->numChannels(), 1);
+	}
+
+	void testReclaimAfterPeriod()
+	{
+		using namespace lmms;
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		const auto mixer = Engine::mixer();
+
+		const int channel = mixer->createChannel();
+		const auto send = QPointer<MixerRoute>{mixer->createChannelSend(channel, 0)};
+		const auto channelModel = QPointer<BoolModel>{&mixer->mixerChannel(channel)->m_muteModel};
+
+		mixer->startPeriod();
+
+		// edits during the period, including channels and sends the period never sees
+		const int added = mixer->createChannel();
+		const auto addedSend = QPointer<MixerRoute>{mixer->createChannelSend(added, channel)};
+		const auto addedModel = QPointer<BoolModel>{&mixer->mixerChannel(added)->m_muteModel};
+		mixer->deleteChannelSend(send.data());
+		mixer->deleteChannel(added);
+		mixer->deleteChannel(channel);
+		QCOMPARE(mixer->numChannels(), 1);
+
+		// the period may still use all of them, however long it takes
+		QTest::qWait(100);
+		QVERIFY(!send.isNull());
+		QVERIFY(!channelModel.isNull());
+		QVERIFY(!addedSend.isNull());
+		QVERIFY(!addedModel.isNull());
+
+		// no further edits are needed to free them once it is over
+		mixer->finishPeriod();
+		QTRY_VERIFY(send.isNull() && channelModel.isNull() && addedSend.isNull() && addedModel.isNull());
+	}
+};
+
+QTEST_GUILESS_MAIN(MixerTest)
+#include "MixerTest.moc"
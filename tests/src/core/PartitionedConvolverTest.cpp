@@ -0,0 +1,163 @@
+/*
+ * PartitionedConvolverTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PartitionedConvolver.h"
+
+#include <QObject>
+#include <QtTest>
+#include <cmath>
+#include <vector>
+
+#include "SampleFrame.h"
+
+using lmms::PartitionedConvolver;
+using lmms::SampleFrame;
+
+class PartitionedConvolverTest : public QObject
+{
+	Q_OBJECT
+
+	static constexpr int BlockSize = 64;
+	static constexpr int Blocks = 16;
+
+	static std::vector<SampleFrame> testSignal()
+	{
+		auto signal = std::vector<SampleFrame>(BlockSize * Blocks);
+		for (auto i = std::size_t{0}; i < signal.size(); ++i)
+		{
+			signal[i] = SampleFrame(std::sin(i * 0.3f), std::cos(i * 0.17f));
+		}
+		return signal;
+	}
+
+	static float maxError(const std::vector<SampleFrame>& in, const std::vector<SampleFrame>& ir,
+		const std::vector<SampleFrame>& out)
+	{
+		return maxError(in, ir, out, 0, in.size());
+	}
+
+	//! Compares the output frames in [begin, end) with the convolution of the whole input
+	static float maxError(const std::vector<SampleFrame>& in, const std::vector<SampleFrame>& ir,
+		const std::vector<SampleFrame>& out, std::size_t begin, std::size_t end)
+	{
+		float error = 0.f;
+		for (auto n = begin; n < end; ++n)
+		{
+			for (int ch = 0; ch < 2; ++ch)
+			{
+				float expected = 0.f;
+				for (auto k = std::size_t{0}; k < ir.size() && k <= n; ++k)
+				{
+					expected += ir[k][ch] * in[n - k][ch];
+				}
+				error = std::max(error, std::abs(expected - out[n][ch]));
+			}
+		}
+		return error;
+	}
+
+private slots:
+	void matchesDirectConvolution()
+	{
+		auto ir = std::vector<SampleFrame>(BlockSize * 6 + 10);
+		ir[0] = SampleFrame(0.25f, 0.5f);
+		ir[3] = SampleFrame(0.5f, -0.2f);
+		ir[BlockSize * 4 + 1] = SampleFrame(1.f, -1.f);
+		ir[BlockSize * 6 + 5] = SampleFrame(0.3f);
+
+		auto convolver = PartitionedConvolver(BlockSize);
+		convolver.setImpulseResponse(ir.data(), ir.size());
+		QCOMPARE(convolver.tailBlocks(), std::size_t{7});
+		QCOMPARE(convolver.activePartitions(), std::size_t{3});
+
+		const auto in = testSignal();
+		auto out = std::vector<SampleFrame>(in.size());
+		for (int b = 0; b < Blocks; ++b)
+		{
+			convolver.process(&in[b * BlockSize], &out[b * BlockSize]);
+		}
+
+		QVERIFY(maxError(in, ir, out) < 1e-4f);
+	}
+
+	void swapsResponseWithoutLosingHistory()
+	{
+		auto first = std::vector<SampleFrame>(BlockSize * 3);
+		first[2] = SampleFrame(0.5f);
+		first[BlockSize * 2 + 1] = SampleFrame(1.f, -1.f);
+		auto second = std::vector<SampleFrame>(BlockSize * 5);
+		second[0] = SampleFrame(0.3f, 0.2f);
+		second[BlockSize * 4 + 3] = SampleFrame(-0.7f);
+
+		// allocated for the longer response up front, so swapping keeps the input history
+		auto convolver = PartitionedConvolver(BlockSize, second.size());
+		auto prepared = PartitionedConvolver::ImpulseResponse(BlockSize);
+		prepared.set(first.data(), first.size());
+		convolver.swapImpulseResponse(prepared);
+
+		const auto in = testSignal();
+		auto out = std::vector<SampleFrame>(in.size());
+		constexpr int SwitchBlock = Blocks / 2;
+		for (int b = 0; b < Blocks; ++b)
+		{
+			if (b == SwitchBlock)
+			{
+				prepared.set(second.data(), second.size());
+				convolver.swapImpulseResponse(prepared);
+			}
+			convolver.process(&in[b * BlockSize], &out[b * BlockSize]);
+		}
+		QCOMPARE(convolver.tailBlocks(), std::size_t{5});
+
+		// each part of the output is the full convolution with the response in use at that time
+		QVERIFY(maxError(in, first, out, 0, SwitchBlock * BlockSize) < 1e-4f);
+		QVERIFY(maxError(in, second, out, SwitchBlock * BlockSize, in.size()) < 1e-4f);
+	}
+
+	void countsActivePartitions()
+	{
+		auto ir = std::vector<SampleFrame>(BlockSize * 4);
+		QCOMPARE(PartitionedConvolver::activePartitions(ir.data(), ir.size(), BlockSize), std::size_t{0});
+
+		ir[BlockSize] = SampleFrame(1.f);
+		ir[BlockSize * 4 - 1] = SampleFrame(0.f, 1.f);
+		QCOMPARE(PartitionedConvolver::activePartitions(ir.data(), ir.size(), BlockSize), std::size_t{2});
+	}
+
+	void silentWithoutImpulseResponse()
+	{
+		auto convolver = PartitionedConvolver(BlockSize);
+		const auto in = testSignal();
+		auto out = std::vector<SampleFrame>(BlockSize);
+		convolver.process(in.data(), out.data());
+		for (const auto& frame : out)
+		{
+			QCOMPARE(frame.left(), 0.f);
+			QCOMPARE(frame.right(), 0.f);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(PartitionedConvolverTest)
+#include "PartitionedConvolverTest.moc"
@@ -0,0 +1,92 @@
+/*
+ * PlanarBufferTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <algorithm>
+#include <limits>
+
+#include "MixHelpers.h"
+#include "PlanarBuffer.h"
+
+class PlanarBufferTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void testRoundTrip()
+	{
+		using namespace lmms;
+
+		auto frames = std::vector<SampleFrame>(64);
+		for (auto i = std::size_t{0}; i < frames.size(); ++i)
+		{
+			frames[i] = SampleFrame{i / 64.f, -(i / 64.f)};
+		}
+
+		auto buffer = PlanarBuffer{128};
+		buffer.deinterleave(frames);
+
+		const auto view = buffer.view(frames.size());
+		QCOMPARE(view.frames(), frames.size());
+		QCOMPARE(view[0][10], frames[10].left());
+		QCOMPARE(view[1][10], frames[10].right());
+
+		// the channels are contiguous
+		QCOMPARE(view[0] + 1, &view[0][1]);
+
+		auto result = std::vector<SampleFrame>(frames.size());
+		buffer.interleave(result);
+		for (auto i = std::size_t{0}; i < frames.size(); ++i)
+		{
+			QCOMPARE(result[i].left(), frames[i].left());
+			QCOMPARE(result[i].right(), frames[i].right());
+		}
+	}
+
+	void testSanitize()
+	{
+		using namespace lmms;
+
+		const bool nanHandler = MixHelpers::useNaNHandler();
+		MixHelpers::setNaNHandler(true);
+
+		auto buffer = PlanarBuffer{16};
+		const auto view = buffer.view(16);
+		std::fill_n(view[0], 16, 2000.f);
+		std::fill_n(view[1], 16, -0.5f);
+		QVERIFY(!MixHelpers::sanitize(view));
+		QCOMPARE(view[0][3], 1000.f);
+		QCOMPARE(view[1][3], -0.5f);
+
+		view[1][7] = std::numeric_limits<float>::quiet_NaN();
+		QVERIFY(MixHelpers::sanitize(view));
+		QCOMPARE(view[0][3], 0.f);
+		QCOMPARE(view[1][7], 0.f);
+
+		MixHelpers::setNaNHandler(nanHandler);
+	}
+};
+
+QTEST_GUILESS_MAIN(PlanarBufferTest)
+#include "PlanarBufferTest.moc"
@@ -0,0 +1,139 @@
+/*
+ * PluginCacheTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <QImage>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+
+#include "PluginCache.h"
+#include "PluginFactory.h"
+#include "embed.h"
+
+namespace
+{
+
+// compiled in, so the logo doesn't come from any resources
+const char* const logoXpm[] = {
+	"2 2 2 1",
+	"a c #FF0000",
+	"b c #0000FF",
+	"ab",
+	"ba"
+};
+
+} // namespace
+
+class PluginCacheTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		QVERIFY(m_cacheDir.isValid());
+		qputenv("LMMS_CACHE_DIR", m_cacheDir.path().toLocal8Bit());
+	}
+
+	void testDescriptorRoundTrip()
+	{
+		using namespace lmms;
+
+		auto library = QTemporaryFile{};
+		QVERIFY(library.open());
+		library.write("not really a library");
+		library.flush();
+		const auto file = QFileInfo{library.fileName()};
+
+		const auto logo = PixmapLoader{"plugin/logo", logoXpm};
+		const auto original = Plugin::Descriptor{
+			"plugin",
+			"Plugin",
+			"Does things",
+			"Someone",
+			0x0100,
+			Plugin::Type::Instrument,
+			&logo,
+			"wav,ogg",
+			nullptr
+		};
+
+		{
+			PluginCache cache("PluginCacheTest");
+			QVERIFY(!cache.find(file));
+			cache.insert(file, PluginFactory::CachedDescriptor::toJson(original));
+		}
+
+		PluginCache cache("PluginCacheTest");
+		const auto data = cache.find(file);
+		QVERIFY(data);
+
+		const auto cached = PluginFactory::CachedDescriptor{*data};
+		QCOMPARE(cached.descriptor.name, original.name);
+		QCOMPARE(cached.descriptor.displayName, original.displayName);
+		QCOMPARE(cached.descriptor.description, original.description);
+		QCOMPARE(cached.descriptor.author, original.author);
+		QCOMPARE(cached.descriptor.version, original.version);
+		QCOMPARE(cached.descriptor.type, original.type);
+		QCOMPARE(cached.descriptor.supportedFileTypes, original.supportedFileTypes);
+		QVERIFY(cached.descriptor.subPluginFeatures == nullptr);
+
+		// the logo is available without the library's resources
+		QVERIFY(cached.descriptor.logo != nullptr);
+		QCOMPARE(cached.descriptor.logo->pixmapName(), logo.pixmapName());
+		const auto image = QImage::fromData(cached.logoImage, "PNG");
+		QCOMPARE(image.convertToFormat(QImage::Format_ARGB32), QImage{logoXpm}.convertToFormat(QImage::Format_ARGB32));
+	}
+
+	void testChangedLibrary()
+	{
+		using namespace lmms;
+
+		auto library = QTemporaryFile{};
+		QVERIFY(library.open());
+		library.write("library");
+		library.flush();
+		const auto file = QFileInfo{library.fileName()};
+
+		const auto original = Plugin::Descriptor{"plugin", "Plugin", "", "", 0x0100,
+			Plugin::Type::Effect, nullptr, nullptr, nullptr};
+		{
+			PluginCache cache("PluginCacheTest");
+			cache.insert(file, PluginFactory::CachedDescriptor::toJson(original));
+		}
+
+		// a different size means the plugin was updated
+		library.write("updated");
+		library.flush();
+
+		PluginCache cache("PluginCacheTest");
+		QVERIFY(!cache.find(QFileInfo{library.fileName()}));
+	}
+
+private:
+	QTemporaryDir m_cacheDir;
+};
+
+QTEST_GUILESS_MAIN(PluginCacheTest)
+#include "PluginCacheTest.moc"
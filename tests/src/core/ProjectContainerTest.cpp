@@ -0,0 +1,155 @@
+/*
+ * ProjectContainerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <QDataStream>
+#include <QDomDocument>
+#include <QTemporaryDir>
+
+#include "Engine.h"
+#include "ProjectContainer.h"
+#include "SampleBuffer.h"
+
+class ProjectContainerTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testRoundTrip()
+	{
+		using namespace lmms;
+
+		auto frames = std::vector<SampleFrame>(1000);
+		for (auto i = std::size_t{0}; i < frames.size(); ++i)
+		{
+			frames[i] = SampleFrame{i / 1000.f, -(i / 1000.f)};
+		}
+		const auto buffer = std::make_shared<const SampleBuffer>(frames.data(), frames.size(), 48000);
+
+		auto saved = ProjectContainer{};
+		QString first, second;
+		{
+			const auto scope = ProjectContainer::Scope{&saved};
+			first = ProjectContainer::saveSample(buffer);
+			second = ProjectContainer::saveSample(buffer);
+		}
+		// the data is not embedded and stored only once
+		QVERIFY(first.size() < 100);
+		QCOMPARE(first, second);
+
+		const auto tempDir = QTemporaryDir{};
+		const QString fileName = tempDir.filePath("test.mmpc");
+		{
+			auto file = QFile{fileName};
+			QVERIFY(file.open(QIODevice::WriteOnly));
+			QVERIFY(saved.write(file, "<lmms-project/>"));
+		}
+
+		QVERIFY(ProjectContainer::isContainerFile(fileName));
+		const auto loaded = ProjectContainer::open(fileName);
+		QVERIFY(loaded != nullptr);
+		QCOMPARE(loaded->xml(), QByteArray{"<lmms-project/>"});
+
+		const auto scope = ProjectContainer::Scope{loaded.get()};
+		const auto result = ProjectContainer::loadSample(first, 48000);
+		QCOMPARE(result->size(), frames.size());
+		QCOMPARE(result->sampleRate(), 48000u);
+		QCOMPARE(result->data()[500].left(), frames[500].left());
+		QCOMPARE(result->data()[500].right(), frames[500].right());
+
+		// references to the same data share the buffer
+		QVERIFY(ProjectContainer::loadSample(second, 48000) == result);
+	}
+
+	void testConversion()
+	{
+		using namespace lmms;
+
+		const auto frames = std::vector<SampleFrame>(10, SampleFrame{0.5f, 0.25f});
+		const QString base64 = SampleBuffer(frames.data(), frames.size(), 44100).toBase64();
+
+		auto doc = QDomDocument{};
+		auto clip = doc.createElement("sampleclip");
+		clip.setAttribute("data", base64);
+		doc.appendChild(clip);
+
+		auto container = ProjectContainer{};
+		container.extractSamples(doc);
+		QVERIFY(clip.attribute("data") != base64);
+
+		QVERIFY(container.embedSamples(doc));
+		QCOMPARE(clip.attribute("data"), base64);
+	}
+
+	void testLargeContainer()
+	{
+		using namespace lmms;
+
+		// a sample of more than 2 GiB, whose size and offsets don't fit into an int
+		constexpr quint64 BlobOffset = 4096;
+		constexpr quint64 BlobSize = (quint64{1} << 31) + 4096;
+		constexpr quint64 XmlOffset = BlobOffset + BlobSize;
+		const QByteArray xml = qCompress("<lmms-project/>");
+
+		const auto writeContainer = [&](const QString& fileName, quint64 claimedBlobSize) {
+			auto file = QFile{fileName};
+			if (!file.open(QIODevice::WriteOnly)) { return false; }
+			auto stream = QDataStream{&file};
+			stream.setByteOrder(QDataStream::LittleEndian);
+			stream.writeRawData("LMMSPRJC", 8);
+			stream << quint32{1} << quint32{1} << XmlOffset << static_cast<quint64>(xml.size());
+			stream.writeRawData(QByteArray(32, 'x').constData(), 32);
+			stream << BlobOffset << claimedBlobSize;
+			// the sample data stays a hole in the file, so this is quick and takes no disk space
+			return file.seek(XmlOffset) && file.write(xml) == xml.size();
+		};
+
+		const auto tempDir = QTemporaryDir{};
+		const QString valid = tempDir.filePath("large.mmpc");
+		QVERIFY(writeContainer(valid, BlobSize));
+		const auto container = ProjectContainer::open(valid);
+		QVERIFY(container != nullptr);
+		QCOMPARE(container->xml(), QByteArray{"<lmms-project/>"});
+
+		// sizes reaching past the end of the file are rejected instead of being truncated
+		const QString invalid = tempDir.filePath("invalid.mmpc");
+		QVERIFY(writeContainer(invalid, BlobSize + (quint64{1} << 32)));
+		QVERIFY(ProjectContainer::open(invalid) == nullptr);
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectContainerTest)
+#include "ProjectContainerTest.moc"
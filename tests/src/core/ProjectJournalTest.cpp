@@ -0,0 +1,145 @@
+/*
+ * ProjectJournalTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include "AutomatableModel.h"
+#include "DataFile.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "ProjectJournal.h"
+
+#include "Engine.h"
+#include "Song.h"
+
+class ProjectJournalTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+		Engine::projectJournal()->setJournalling(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void init()
+	{
+		using namespace lmms;
+		Engine::projectJournal()->clearJournal();
+		Engine::projectJournal()->setMaxMemoryUsage(ProjectJournal::DefaultMaxMemoryUsage);
+	}
+
+	void testModelUndoRedo()
+	{
+		using namespace lmms;
+		const auto journal = Engine::projectJournal();
+
+		FloatModel model(0.f, 0.f, 10.f, 1.f);
+		model.setValue(1.f);
+		model.setValue(2.f);
+
+		// a value change must not cost a snapshot of the model
+		QVERIFY(journal->memoryUsage() < 2 * 100);
+
+		journal->undo();
+		QCOMPARE(model.value(), 1.f);
+		journal->undo();
+		QCOMPARE(model.value(), 0.f);
+		QVERIFY(!journal->canUndo());
+
+		journal->redo();
+		QCOMPARE(model.value(), 1.f);
+		journal->redo();
+		QCOMPARE(model.value(), 2.f);
+		QVERIFY(!journal->canRedo());
+	}
+
+	void testMidiClipUndo()
+	{
+		using namespace lmms;
+		const auto journal = Engine::projectJournal();
+
+		InstrumentTrack track(Engine::getSong());
+		MidiClip clip(&track);
+		for (int i = 0; i < 100; ++i)
+		{
+			clip.addNote(Note(TimePos(10), TimePos(i * 20), 40 + i % 12), false);
+		}
+
+		DataFile snapshot(DataFile::Type::JournalData);
+		clip.saveState(snapshot, snapshot.content());
+
+		// creating the track may have journalled some of its models already
+		const std::size_t usageBefore = journal->memoryUsage();
+		clip.addJournalCheckPoint();
+		QVERIFY(journal->memoryUsage() - usageBefore < static_cast<std::size_t>(snapshot.toByteArray(-1).size()));
+
+		clip.clearNotes();
+		journal->undo();
+
+		QCOMPARE(clip.notes().size(), std::size_t{100});
+		QCOMPARE(clip.notes()[42]->pos().getTicks(), 42 * 20);
+		QCOMPARE(clip.notes()[42]->key(), 40 + 42 % 12);
+
+		journal->redo();
+		QVERIFY(clip.notes().empty());
+	}
+
+	void testMemoryBudget()
+	{
+		using namespace lmms;
+		const auto journal = Engine::projectJournal();
+
+		FloatModel model(0.f, 0.f, 1000.f, 1.f);
+		model.setValue(1.f);
+		const std::size_t checkPointSize = journal->memoryUsage();
+
+		journal->setMaxMemoryUsage(10 * checkPointSize);
+		for (int i = 2; i < 100; ++i)
+		{
+			model.setValue(static_cast<float>(i));
+		}
+		QVERIFY(journal->memoryUsage() <= 10 * checkPointSize);
+
+		// the oldest checkpoints were dropped
+		int undoSteps = 0;
+		while (journal->canUndo())
+		{
+			journal->undo();
+			++undoSteps;
+		}
+		QCOMPARE(undoSteps, 10);
+		QCOMPARE(model.value(), 89.f);
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectJournalTest)
+#include "ProjectJournalTest.moc"
@@ -0,0 +1,159 @@
+/*
+ * VoiceManagerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "Song.h"
+#include "VoiceManager.h"
+
+class VoiceManagerTest : public QObject
+{
+	Q_OBJECT
+private:
+	using Voice = lmms::VoiceManager::Voice;
+
+	//! The age identifies the voices, the handle is never used by the policy
+	static Voice voice(const lmms::InstrumentTrack* track, int maxPolyphony, int priority,
+		bool released, float level, lmms::f_cnt_t age)
+	{
+		return {nullptr, track, maxPolyphony, priority, released, level, age};
+	}
+
+	static std::vector<lmms::f_cnt_t> stolen(const std::vector<Voice>& voices)
+	{
+		auto ages = std::vector<lmms::f_cnt_t>{};
+		for (const auto& v : voices)
+		{
+			if (v.steal) { ages.push_back(v.age); }
+		}
+		std::sort(ages.begin(), ages.end());
+		return ages;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testPolyphonyLimit()
+	{
+		using namespace lmms;
+		using Ages = std::vector<f_cnt_t>;
+
+		InstrumentTrack limited(Engine::getSong());
+		InstrumentTrack unlimited(Engine::getSong());
+		InstrumentTrack full(Engine::getSong());
+
+		auto voices = std::vector<Voice>{
+			voice(&limited, 2, 0, false, 1.f, 1),
+			voice(&unlimited, 0, 0, false, 1.f, 10),
+			voice(&limited, 2, 0, false, 1.f, 2),
+			voice(&full, 3, 0, false, 1.f, 20),
+			voice(&limited, 2, 0, false, 1.f, 3),
+			voice(&unlimited, 0, 0, false, 1.f, 11),
+			voice(&full, 3, 0, false, 1.f, 21),
+			voice(&limited, 2, 0, false, 1.f, 4),
+			voice(&unlimited, 0, 0, false, 1.f, 12),
+			voice(&full, 3, 0, false, 1.f, 22),
+		};
+
+		// only the two oldest voices of the track over its limit are stolen
+		VoiceManager::markOverPolyphony(voices);
+		QCOMPARE(stolen(voices), (Ages{3, 4}));
+	}
+
+	void testBudgetLimit()
+	{
+		using namespace lmms;
+		using Ages = std::vector<f_cnt_t>;
+
+		// below the target, or without a measured voice load, nothing is limited
+		QCOMPARE(VoiceManager::voiceBudget(85, 80, 50, 1.f), SIZE_MAX);
+		QCOMPARE(VoiceManager::voiceBudget(85, 100, 60, 0.f), SIZE_MAX);
+
+		// 40% are used by everything else, so 45% are left for voices of 2% each
+		QCOMPARE(VoiceManager::voiceBudget(85, 100, 60, 2.f), std::size_t{22});
+
+		// everything else alone exceeds the target, a single voice is left
+		QCOMPARE(VoiceManager::voiceBudget(85, 100, 0, 2.f), std::size_t{1});
+		QCOMPARE(VoiceManager::voiceBudget(50, 100, 10, 2.f), std::size_t{1});
+
+		InstrumentTrack track(Engine::getSong());
+		auto voices = std::vector<Voice>{};
+		for (f_cnt_t age = 1; age <= 5; ++age)
+		{
+			voices.push_back(voice(&track, 0, 0, false, 1.f, age));
+		}
+
+		VoiceManager::markOverBudget(voices, 10);
+		QCOMPARE(stolen(voices), Ages{});
+		VoiceManager::markOverBudget(voices, 5);
+		QCOMPARE(stolen(voices), Ages{});
+		VoiceManager::markOverBudget(voices, 3);
+		QCOMPARE(stolen(voices), (Ages{4, 5}));
+	}
+
+	void testStealOrder()
+	{
+		using namespace lmms;
+		using Ages = std::vector<f_cnt_t>;
+
+		InstrumentTrack low(Engine::getSong());
+		InstrumentTrack high(Engine::getSong());
+
+		// lower priority first, then released, then quieter and finally older voices
+		const auto voices = std::vector<Voice>{
+			voice(&high, 0, 1, false, 1.f, 10),
+			voice(&high, 0, 1, false, 1.f, 20),
+			voice(&high, 0, 1, false, 0.1f, 3),
+			voice(&high, 0, 1, true, 1.f, 2),
+			voice(&low, 0, 0, false, 1.f, 1),
+		};
+		const auto expected = std::vector<Ages>{{1}, {1, 2}, {1, 2, 3}, {1, 2, 3, 20}, {1, 2, 3, 10, 20}};
+
+		for (std::size_t count = 1; count <= voices.size(); ++count)
+		{
+			auto marked = voices;
+			VoiceManager::markOverBudget(marked, voices.size() - count);
+			QCOMPARE(stolen(marked), expected[count - 1]);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(VoiceManagerTest)
+#include "VoiceManagerTest.moc"
@@ -0,0 +1,270 @@
+/*
+ * XpressiveTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ExprProgram.h"
+#include "ExprSynth.h"
+
+//! Compares the block evaluation of ExprProgram with the per sample evaluation of exprtk
+class XpressiveTest : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr auto SampleRate = 44100u;
+	static constexpr auto Frames = std::size_t{1000};
+	static constexpr auto FramesPerPeriod = std::size_t{64};
+	static constexpr auto ReleaseFrame = std::size_t{600};
+	static constexpr auto RandomSeed = 1234u;
+
+	//! The values of t, f, rel and trel for each frame of a note, like in ExprSynth::renderOutput()
+	struct Note
+	{
+		Note(int key, bool glide)
+		{
+			const float frequency = 440.f * std::exp2((key - 69) / 12.f);
+			float released = 0;
+			for (std::size_t frame = 0; frame < Frames; ++frame)
+			{
+				if (frame >= ReleaseFrame) { released = std::min(released + 0.005f, 1.f); }
+				t.push_back(frame / static_cast<float>(SampleRate));
+				f.push_back(glide ? frequency * (1 + frame / static_cast<float>(Frames)) : frequency);
+				rel.push_back(released);
+				trel.push_back(frame >= ReleaseFrame ? (frame - ReleaseFrame) / static_cast<float>(SampleRate) : 0);
+			}
+		}
+
+		std::vector<float> t, f, rel, trel;
+	};
+
+	//! Sets up an expression like ExprSynth does, except that the frame inputs are only used by the program
+	struct Expression
+	{
+		Expression(const char* text, const std::vector<lmms::WaveSample*>& waves) :
+			front(text, 512)
+		{
+			front.add_cyclic_vector("W1", waves[0]->m_samples, waves[0]->m_length, waves[0]->m_interpolate);
+			front.add_cyclic_vector("W2", waves[1]->m_samples, waves[1]->m_length, waves[1]->m_interpolate);
+			front.add_cyclic_vector("W3", waves[2]->m_samples, waves[2]->m_length, waves[2]->m_interpolate);
+			front.add_variable("t", t);
+			front.add_variable("f", f);
+			front.add_variable("rel", rel);
+			front.add_variable("trel", trel);
+			front.setIntegrate(&frame, SampleRate);
+		}
+
+		lmms::ExprFront front;
+		float t = 0, f = 0, rel = 0, trel = 0;
+		unsigned int frame = 0;
+	};
+
+	std::vector<float> evaluateWithExprtk(const char* text, const Note& note)
+	{
+		lmms::ExprFront::seedRandom(RandomSeed);
+		auto expression = Expression{text, m_waves};
+		if (!expression.front.compile()) { return {}; }
+
+		auto result = std::vector<float>(Frames);
+		for (std::size_t frame = 0; frame < Frames; ++frame)
+		{
+			expression.t = note.t[frame];
+			expression.f = note.f[frame];
+			expression.rel = note.rel[frame];
+			expression.trel = note.trel[frame];
+			expression.frame = static_cast<unsigned int>(frame);
+			result[frame] = expression.front.evaluate();
+		}
+		return result;
+	}
+
+	std::vector<float> evaluateWithProgram(const char* text, const Note& note)
+	{
+		lmms::ExprFront::seedRandom(RandomSeed);
+		auto expression = Expression{text, m_waves};
+		auto t = std::vector<float>(FramesPerPeriod);
+		auto f = std::vector<float>(FramesPerPeriod);
+		auto rel = std::vector<float>(FramesPerPeriod);
+		auto trel = std::vector<float>(FramesPerPeriod);
+		expression.front.setFrameInput("t", t.data());
+		expression.front.setFrameInput("f", f.data());
+		expression.front.setFrameInput("rel", rel.data());
+		expression.front.setFrameInput("trel", trel.data());
+		if (!expression.front.compile() || !expression.front.compileProgram(FramesPerPeriod)) { return {}; }
+
+		const bool sequential = expression.front.program()->isSequential();
+		auto result = std::vector<float>(Frames);
+		for (std::size_t start = 0; start < Frames; start += FramesPerPeriod)
+		{
+			// the last period is shorter, like when a note ends
+			const auto frames = std::min(FramesPerPeriod, Frames - start);
+			std::copy_n(note.t.begin() + start, frames, t.begin());
+			std::copy_n(note.f.begin() + start, frames, f.begin());
+			std::copy_n(note.rel.begin() + start, frames, rel.begin());
+			std::copy_n(note.trel.begin() + start, frames, trel.begin());
+			if (sequential)
+			{
+				for (std::size_t frame = 0; frame < frames; ++frame)
+				{
+					expression.front.runProgram(&result[start + frame], 1, frame);
+				}
+			}
+			else
+			{
+				expression.front.runProgram(&result[start], frames);
+			}
+		}
+		return result;
+	}
+
+	static bool fuzzyEqual(float a, float b)
+	{
+		if (std::isnan(a) || std::isnan(b)) { return std::isnan(a) && std::isnan(b); }
+		if (std::isinf(a) || std::isinf(b)) { return a == b; }
+		return std::abs(a - b) <= 1e-4f * std::max(1.f, std::abs(a));
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+
+		// W1 is a sine, W2 a saw and W3 noise, with and without interpolation
+		for (int i = 0; i < 3; ++i)
+		{
+			auto wave = new WaveSample(200);
+			for (int s = 0; s < wave->m_length; ++s)
+			{
+				const float x = s / static_cast<float>(wave->m_length);
+				wave->m_samples[s] = i == 0 ? std::sin(x * 6.2831853f)
+					: i == 1 ? 2 * x - 1
+					: std::fmod(s * 0.618034f, 1.f) * 2 - 1;
+			}
+			wave->setInterpolate(i != 1);
+			m_waves.push_back(wave);
+		}
+	}
+
+	void cleanupTestCase()
+	{
+		for (auto wave : m_waves) { delete wave; }
+		m_waves.clear();
+	}
+
+	void testSameResults_data()
+	{
+		QTest::addColumn<QString>("expression");
+		QTest::addColumn<int>("key");
+
+		const char* const expressions[] = {
+			// waves and note variables
+			"sinew(t*f)",
+			"0.5*squarew(t*f) + 0.25*trianglew(t*f*2) - 0.25*saww(t*f/2)",
+			"moogsaww(t*f)*moogw(t*f)*expw(t*f)*expnw(t*f)",
+			"sinew(t*f*semitone(7)) + sinew(t*f*cent(-10))",
+			"sinew(t*f)*(1 - rel) + trel",
+			"W1(t*f) + W2(t*f) + W3(t*f)",
+			"W1(integrate(f))*W3(t*f*2) - W2(-t*f)",
+			// integrate keeps one counter per call
+			"sinew(integrate(f))",
+			"sinew(integrate(f)) + saww(integrate(f*1.01))",
+			"sinew(integrate(f*(1 + 0.1*sinew(integrate(5)))))",
+			// random numbers depend on the seed and the order of calls
+			"rand()",
+			"rand() - rand()*0.5",
+			"randv(t*f)",
+			"randv(floor(t*f)) + randsv(t*44100, seed)",
+			"randsv(t*44100, 5) - randsv(t*f, 6)",
+			// last() depends on the history of the output
+			"0.5*last(1) + 0.5*sinew(t*f)",
+			"0.9*last(100) + 0.1*rand()",
+			"last(2) - last(1) + saww(t*f)",
+			// precedence of ^, pow() and the unary signs
+			"pow(t + 1, t*f) + pow(2, sinew(t*f))",
+			"t^2 + (t*f)^3 % 1",
+			"2^3*t + (t + 1)^(-1) + t^0.5*-f",
+			"-(t^2) + (-t)^2*f + (-2)^2*t",
+			"(t^2)^3*f",
+			"-(-t*f) + +t - -t",
+			"-t*2 + -t + 2",
+			"2*-sinew(t*f) / -4 + t % -2",
+			"exp(-t*3)*sinew(t*f)",
+			// remaining operators and functions
+			"2t*f + 3(t) + (t)2",
+			"(t*f % 1) + (t < 0.005) + (t <= 0.005) + (t > 0.005) + (t >= 0.005)",
+			"min(t*f, 1) + max(sinew(t*f), 0) + atan2(t, trel + 0.001)",
+			"abs(sinew(t*f)) + sgn(saww(t*f)) + frac(t*f) + trunc(t*f) + round(t*f)",
+			"sqrt(t) + log(1 + t) + floor(t*f) + ceil(t*f) + tanh(sinew(t*f))",
+		};
+		for (const auto expression : expressions)
+		{
+			for (const int key : {33, 69, 105})
+			{
+				QTest::newRow(qPrintable(QString{"%1 key %2"}.arg(expression).arg(key))) << QString{expression} << key;
+			}
+		}
+	}
+
+	void testSameResults()
+	{
+		QFETCH(QString, expression);
+		QFETCH(int, key);
+
+		for (const bool glide : {false, true})
+		{
+			const auto note = Note{key, glide};
+			const auto expected = evaluateWithExprtk(qPrintable(expression), note);
+			const auto actual = evaluateWithProgram(qPrintable(expression), note);
+			QVERIFY2(!expected.empty(), "exprtk failed to compile the expression");
+			QVERIFY2(!actual.empty(), "ExprProgram does not support the expression");
+
+			for (std::size_t frame = 0; frame < Frames; ++frame)
+			{
+				QVERIFY2(fuzzyEqual(expected[frame], actual[frame]), qPrintable(QString{"frame %1: %2 != %3"}
+					.arg(frame).arg(expected[frame]).arg(actual[frame])));
+			}
+		}
+	}
+
+	void testUnsupported()
+	{
+		// exprtk features outside of the subset and precedence that is not obvious keep using exprtk
+		for (const auto text : {"t == 0", "clamp(-1, t*f, 1)", "2^3^2*t", "2^-1*t", "-t^2", "-sinew(t*f)^2", "pow(t, 3)"})
+		{
+			auto expression = Expression{text, m_waves};
+			QVERIFY2(expression.front.compile(), text);
+			QVERIFY2(!expression.front.compileProgram(FramesPerPeriod), text);
+			QVERIFY(expression.front.program() == nullptr);
+		}
+	}
+
+private:
+	std::vector<lmms::WaveSample*> m_waves;
+};
+
+QTEST_GUILESS_MAIN(XpressiveTest)
+#include "XpressiveTest.moc"
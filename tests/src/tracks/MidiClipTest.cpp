@@ -0,0 +1,133 @@
+/*
+ * MidiClipTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <algorithm>
+
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+
+#include "Engine.h"
+#include "Song.h"
+
+class MidiClipTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testNotesInRange()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		MidiClip clip(&track);
+
+		// a long note at the start and short ones following it
+		clip.addNote(Note(TimePos(400), TimePos(0)), false);
+		for (int i = 0; i < 10; ++i)
+		{
+			clip.addNote(Note(TimePos(10), TimePos(i * 50)), false);
+		}
+
+		// notes reaching into the range, whether they start before it or not
+		auto overlapping = [&](int start, int end) {
+			const auto [first, last] = clip.notesInRange(start, end);
+			return static_cast<int>(std::count_if(first, last,
+				[=](const Note* n) { return n->endPos() >= start && n->pos() < end; }));
+		};
+
+		QCOMPARE(overlapping(0, 1), 2);
+		QCOMPARE(overlapping(100, 101), 2);
+		QCOMPARE(overlapping(105, 106), 2);
+		QCOMPARE(overlapping(120, 121), 1);
+		QCOMPARE(overlapping(450, 451), 1);
+		QCOMPARE(overlapping(500, 600), 0);
+
+		// the range must not contain notes starting after it
+		const auto [first, last] = clip.notesInRange(120, 121);
+		QVERIFY(std::none_of(first, last, [](const Note* n) { return n->pos() >= 121; }));
+	}
+
+	void testNotesInRangeAfterEdit()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		MidiClip clip(&track);
+
+		Note* note = clip.addNote(Note(TimePos(10), TimePos(0)), false);
+		clip.addNote(Note(TimePos(10), TimePos(100)), false);
+
+		auto [first, last] = clip.notesInRange(300, 301);
+		QCOMPARE(std::distance(first, last), 0);
+
+		// editors move notes in place, then rearrange them
+		note->setPos(TimePos(295));
+		clip.rearrangeAllNotes();
+
+		std::tie(first, last) = clip.notesInRange(300, 301);
+		QCOMPARE(std::distance(first, last), 1);
+		QCOMPARE(*first, note);
+	}
+
+	void testAddNotes()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		MidiClip clip(&track);
+		clip.addNote(Note(TimePos(10), TimePos(50), 60), false);
+
+		auto notes = std::vector<Note>{};
+		for (int i = 9; i >= 0; --i)
+		{
+			notes.emplace_back(TimePos(10), TimePos(i * 20), 40 + i);
+		}
+		notes.emplace_back(TimePos(10), TimePos(40), 70);
+		clip.addNotes(notes);
+
+		// merged with the existing note, notes at the same position by descending key
+		QCOMPARE(clip.notes().size(), std::size_t{12});
+		QVERIFY(std::is_sorted(clip.notes().begin(), clip.notes().end(), Note::lessThan));
+		QCOMPARE(clip.notes()[2]->key(), 70);
+		QCOMPARE(clip.notes()[3]->key(), 42);
+		QCOMPARE(clip.notes()[4]->key(), 60);
+		QCOMPARE(clip.length(), TimePos(DefaultTicksPerBar));
+	}
+};
+
+QTEST_GUILESS_MAIN(MidiClipTest)
+#include "MidiClipTest.moc"